@@ -13,6 +13,11 @@
 // プラットフォーム検出
 #include "internal/platform_detect.h"
 
+//=============================================================================
+// 共通実装
+//=============================================================================
+#include "internal/impl_includes.h"
+
 //=============================================================================
 // プラットフォーム層の実装
 //=============================================================================
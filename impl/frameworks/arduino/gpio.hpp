@@ -11,6 +11,8 @@
 #pragma once
 
 #include "../../internal/gpio.h"
+#include "../../internal/gpio_program.h"
+#include "../../internal/static_pin.h"
 #include <Arduino.h>
 #include <map>
 
@@ -80,11 +82,52 @@ public:
      */
     virtual uint16_t getAnalogValue() const;
 
+    /**
+     * @brief FlexHALのピンモードをArduinoのピンモードに変換
+     *
+     * @param mode ピンモード
+     * @return int Arduinoのピンモード（対応するモードがない場合は-1）
+     */
+    static int toArduinoMode(PinMode mode);
+
 protected:
     int pin_number_;
     PinMode current_mode_;
 };
 
+/**
+ * @brief StaticPin用のArduinoバックエンド
+ *
+ * ピンオブジェクトを経由せず、Arduinoの関数を直接呼び出す
+ */
+struct ArduinoPinBackend {
+    static void setMode(int pin_number, PinMode mode)
+    {
+        int arduino_mode = ArduinoPin::toArduinoMode(mode);
+        if (arduino_mode >= 0) {
+            pinMode(pin_number, arduino_mode);
+        }
+    }
+
+    static void setLevel(int pin_number, PinLevel level)
+    {
+        digitalWrite(pin_number, level == PinLevel::High ? HIGH : LOW);
+    }
+
+    static PinLevel getLevel(int pin_number)
+    {
+        return digitalRead(pin_number) == HIGH ? PinLevel::High : PinLevel::Low;
+    }
+};
+
+/**
+ * @brief Arduinoフレームワークのピン（コンパイル時ピン番号指定）
+ *
+ * @tparam PinNumber ピン番号
+ */
+template <int PinNumber>
+using ArduinoStaticPin = StaticPin<PinNumber, ArduinoPinBackend>;
+
 /**
  * @brief Arduinoフレームワーク用GPIOポート
  */
@@ -145,6 +188,62 @@ public:
      */
     uint32_t getLevels() const override;
 
+    using IGPIOPort::getLevels;
+    using IGPIOPort::setLevels;
+
+    /**
+     * @brief ピンのレベルを設定（digitalWriteを直接呼び出す）
+     *
+     * @param pin_number ピン番号
+     * @param level 設定するレベル
+     */
+    void writePin(int pin_number, PinLevel level) override;
+
+    /**
+     * @brief ピンのレベルを取得（digitalReadを直接呼び出す）
+     *
+     * @param pin_number ピン番号
+     * @return PinLevel 現在のレベル
+     */
+    PinLevel readPin(int pin_number) const override;
+
+    /**
+     * @brief バンク数を取得
+     *
+     * @return int バンク数
+     */
+    int getBankCount() const override;
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に設定
+     *
+     * @param bank バンク番号
+     * @param values 設定する値（ビットマップ）
+     * @param mask 設定対象のピン（ビットマップ）
+     */
+    void setLevels(int bank, uint32_t values, uint32_t mask) override;
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に取得
+     *
+     * @param bank バンク番号
+     * @return uint32_t 現在のレベル（ビットマップ）
+     */
+    uint32_t getLevels(int bank) const override;
+
+    /**
+     * @brief GPIOプログラムを実行
+     *
+     * 各ステップをdigitalWrite/digitalReadへ直接展開して実行する
+     *
+     * @param program 実行するプログラム
+     * @param samples 読み取りステップの結果の格納先
+     * @param sample_capacity 格納先の要素数
+     * @return true 実行成功
+     * @return false 検証失敗、またはレベル待ちのタイムアウト
+     */
+    bool execute(const GPIOProgram& program, uint32_t* samples = nullptr, size_t sample_capacity = 0) override;
+
 protected:
     /**
      * @brief プラットフォーム固有のピンを作成
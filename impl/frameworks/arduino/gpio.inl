@@ -24,40 +24,40 @@ ArduinoPin::ArduinoPin(int pin_number) : pin_number_(pin_number), current_mode_(
 
 void ArduinoPin::setMode(PinMode mode)
 {
-    uint8_t arduino_mode;
+    int arduino_mode = toArduinoMode(mode);
+    if (arduino_mode < 0) {
+        return;  // 未定義のモードは無視
+    }
 
+    // Arduinoの関数でピンモードを設定
+    pinMode(pin_number_, arduino_mode);
+    current_mode_ = mode;
+}
+
+int ArduinoPin::toArduinoMode(PinMode mode)
+{
     // FlexHALのピンモードをArduinoのピンモードに変換
     switch (mode) {
         case PinMode::Input:
-            arduino_mode = INPUT;
-            break;
+            return INPUT;
         case PinMode::Output:
-            arduino_mode = OUTPUT;
-            break;
+            return OUTPUT;
         case PinMode::InputPullUp:
-            arduino_mode = INPUT_PULLUP;
-            break;
+            return INPUT_PULLUP;
 #if defined(INPUT_PULLDOWN)
         case PinMode::InputPullDown:
-            arduino_mode = INPUT_PULLDOWN;
-            break;
+            return INPUT_PULLDOWN;
 #endif
 #if defined(OUTPUT_OPEN_DRAIN)
         case PinMode::OpenDrain:
-            arduino_mode = OUTPUT_OPEN_DRAIN;
-            break;
+            return OUTPUT_OPEN_DRAIN;
 #endif
         case PinMode::Analog:
             // 一般的なArduinoのADCモード
-            arduino_mode = INPUT;
-            break;
+            return INPUT;
         default:
-            return;  // 未定義のモードは無視
+            return -1;
     }
-
-    // Arduinoの関数でピンモードを設定
-    pinMode(pin_number_, arduino_mode);
-    current_mode_ = mode;
 }
 
 void ArduinoPin::setLevel(PinLevel level)
@@ -132,34 +132,132 @@ std::shared_ptr<IPin> ArduinoGPIOPort::createPin(int pin_number)
 
 void ArduinoGPIOPort::setLevels(uint32_t values, uint32_t mask)
 {
-    // マスクされたピンの値を設定
-    for (int i = 0; i < 32; ++i) {
-        if ((mask >> i) & 0x01) {
-            auto pin = getPin(i);
-            if (pin) {
-                pin->setLevel(((values >> i) & 0x01) ? PinLevel::High : PinLevel::Low);
-            }
-        }
-    }
+    setLevels(0, values, mask);
 }
 
 uint32_t ArduinoGPIOPort::getLevels() const
 {
+    return getLevels(0);
+}
+
+void ArduinoGPIOPort::writePin(int pin_number, PinLevel level)
+{
+    digitalWrite(pin_number, level == PinLevel::High ? HIGH : LOW);
+}
+
+PinLevel ArduinoGPIOPort::readPin(int pin_number) const
+{
+    return digitalRead(pin_number) == HIGH ? PinLevel::High : PinLevel::Low;
+}
+
+int ArduinoGPIOPort::getBankCount() const
+{
+#if defined(NUM_DIGITAL_PINS)
+    return (NUM_DIGITAL_PINS + GPIO_PINS_PER_BANK - 1) / GPIO_PINS_PER_BANK;
+#else
+    // ピン数が不明な場合は作成済みのピンから算出
+    if (pins_.empty()) {
+        return 1;
+    }
+    return pins_.rbegin()->first / GPIO_PINS_PER_BANK + 1;
+#endif
+}
+
+void ArduinoGPIOPort::setLevels(int bank, uint32_t values, uint32_t mask)
+{
+    if (bank < 0) {
+        return;
+    }
+
+    // マスクの立っているピンだけを直接書き込む（ピンオブジェクトは経由しない）
+    int base = bank * GPIO_PINS_PER_BANK;
+    for (uint32_t bits = mask; bits; bits &= bits - 1) {
+        int bit = lowestBitIndex(bits);
+        digitalWrite(base + bit, ((values >> bit) & 0x01) ? HIGH : LOW);
+    }
+}
+
+uint32_t ArduinoGPIOPort::getLevels(int bank) const
+{
+    if (bank < 0) {
+        return 0;
+    }
+
     uint32_t result = 0;
+    int base        = bank * GPIO_PINS_PER_BANK;
+    int end         = base + GPIO_PINS_PER_BANK;
+#if defined(NUM_DIGITAL_PINS)
+    if (end > NUM_DIGITAL_PINS) {
+        end = NUM_DIGITAL_PINS;
+    }
+#endif
 
-    // 各ピンのレベルを取得してビットマップに変換
-    for (const auto& pair : pins_) {
-        int pin_number = pair.first;
-        if (pin_number < 32) {
-            if (pair.second->getLevel() == PinLevel::High) {
-                result |= (1 << pin_number);
-            }
+    // setLevels() はピンオブジェクトを作成せずに書き込むため、作成済みのピンに限らず
+    // バンク内の全ピンを読み取る
+    for (int pin_number = base; pin_number < end; ++pin_number) {
+        if (digitalRead(pin_number) == HIGH) {
+            result |= (1u << (pin_number - base));
         }
     }
 
     return result;
 }
 
+bool ArduinoGPIOPort::execute(const GPIOProgram& program, uint32_t* samples, size_t sample_capacity)
+{
+#if defined(NUM_DIGITAL_PINS)
+    int bank_count = getBankCount();
+#else
+    // ピン数が不明な場合はバンク番号を制限しない
+    int bank_count = GPIOProgram::MAX_BANK + 1;
+#endif
+    if (!program.validate(bank_count, samples ? sample_capacity : 0)) {
+        return false;
+    }
+
+    // Arduino APIを直接呼び出す実行器
+    struct Executor {
+        void setLevels(int bank, uint32_t values, uint32_t mask)
+        {
+            int base = bank * GPIO_PINS_PER_BANK;
+            for (uint32_t bits = mask; bits; bits &= bits - 1) {
+                int bit = lowestBitIndex(bits);
+                digitalWrite(base + bit, ((values >> bit) & 0x01) ? HIGH : LOW);
+            }
+        }
+
+        uint32_t getLevels(int bank, uint32_t mask)
+        {
+            uint32_t result = 0;
+            int base        = bank * GPIO_PINS_PER_BANK;
+            for (uint32_t bits = mask; bits; bits &= bits - 1) {
+                int bit = lowestBitIndex(bits);
+                if (digitalRead(base + bit) == HIGH) {
+                    result |= (1u << bit);
+                }
+            }
+            return result;
+        }
+
+        void delayMicroseconds(uint32_t us)
+        {
+            // delayMicrosecondsは長い時間を正確に扱えないため、ミリ秒単位はdelayで待つ
+            if (us >= 1000) {
+                delay(us / 1000);
+            }
+            ::delayMicroseconds(us % 1000);
+        }
+
+        uint32_t micros()
+        {
+            return static_cast<uint32_t>(::micros());
+        }
+    };
+
+    Executor executor;
+    return runGPIOProgram(program, executor, samples);
+}
+
 }  // namespace arduino
 }  // namespace framework
 }  // namespace flexhal
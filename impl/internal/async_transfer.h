@@ -0,0 +1,180 @@
+/**
+ * @file async_transfer.h
+ * @brief 非同期転送の完了トークンとワーカーの定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <sys/types.h>
+
+namespace flexhal {
+
+/**
+ * @brief 非同期転送の完了トークン
+ *
+ * 非同期操作の完了をポーリング・タイムアウト付き待機・コールバックのいずれかで受け取る。
+ * コピーしても同じ操作を指す軽量なハンドル。完了済みのトークンは共有状態を持たず、結果を値として保持する。
+ * 非同期操作に渡したバッファは、トークンが完了するまで呼び出し元が保持すること。
+ */
+class TransferToken {
+public:
+    /**
+     * @brief 完了コールバック（引数は転送結果）
+     */
+    using Callback = std::function<void(ssize_t result)>;
+
+    /**
+     * @brief 無期限に待機する場合のタイムアウト値
+     */
+    static constexpr uint32_t WAIT_FOREVER = 0xFFFFFFFF;
+
+    /**
+     * @brief 無効なトークンを作成
+     */
+    TransferToken() = default;
+
+    /**
+     * @brief 未完了のトークンを作成（実装側で使用）
+     *
+     * @return TransferToken 未完了のトークン
+     */
+    static TransferToken create();
+
+    /**
+     * @brief 完了済みのトークンを作成（同期実行した場合に使用、メモリを確保しない）
+     *
+     * @param result 転送結果
+     * @return TransferToken 完了済みのトークン
+     */
+    static TransferToken completed(ssize_t result);
+
+    /**
+     * @brief 操作を指しているか確認
+     *
+     * @return true 有効
+     * @return false 無効
+     */
+    bool isValid() const
+    {
+        return state_ != nullptr || completed_;
+    }
+
+    /**
+     * @brief 完了しているか確認
+     *
+     * @return true 完了している（無効なトークンも完了扱い）
+     * @return false 実行中
+     */
+    bool isDone() const;
+
+    /**
+     * @brief 完了を待機
+     *
+     * @param timeout_ms タイムアウト（ミリ秒）
+     * @return true 完了した
+     * @return false タイムアウト
+     */
+    bool wait(uint32_t timeout_ms = WAIT_FOREVER) const;
+
+    /**
+     * @brief 転送結果を取得
+     *
+     * @return ssize_t 転送したバイト数（負の値はエラーまたは未完了）
+     */
+    ssize_t getResult() const;
+
+    /**
+     * @brief 完了コールバックを設定
+     *
+     * 完了済みの場合はその場で呼び出す。それ以外は完了させたスレッドから呼び出される
+     *
+     * @param callback 完了コールバック
+     */
+    void onComplete(Callback callback);
+
+    /**
+     * @brief 操作を完了させる（実装側で使用）
+     *
+     * @param result 転送結果
+     */
+    void complete(ssize_t result);
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done      = false;
+        ssize_t result = -1;
+        Callback callback;
+    };
+
+    std::shared_ptr<State> state_;  ///< 未完了で作成したトークンの共有状態
+    bool completed_ = false;        ///< 完了済みとして作成された（state_ なし）
+    ssize_t result_ = -1;           ///< 完了済みとして作成された場合の転送結果
+};
+
+/**
+ * @brief 非同期転送ワーカー
+ *
+ * 投入された転送処理を専用スレッドで順番に実行する。スレッドは最初の投入時に起動し、
+ * 破棄時には残りの処理を実行してから終了する。
+ * 完了コールバックはワーカースレッドで呼び出されるため、コールバック内で同じワーカーの
+ * 後続の操作を待機しないこと。
+ */
+class TransferWorker {
+public:
+    /**
+     * @brief 転送処理（戻り値が転送結果になる）
+     */
+    using Job = std::function<ssize_t()>;
+
+    TransferWorker() = default;
+
+    /**
+     * @brief デストラクタ
+     */
+    ~TransferWorker();
+
+    TransferWorker(const TransferWorker&)            = delete;
+    TransferWorker& operator=(const TransferWorker&) = delete;
+
+    /**
+     * @brief 転送処理を投入
+     *
+     * @param job 転送処理
+     * @return TransferToken 完了トークン
+     */
+    TransferToken submit(Job job);
+
+private:
+    struct Entry {
+        Job job;
+        TransferToken token;
+    };
+
+    /**
+     * @brief ワーカースレッドの処理
+     */
+    void run();
+
+    std::deque<Entry> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+}  // namespace flexhal
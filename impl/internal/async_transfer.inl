@@ -0,0 +1,165 @@
+/**
+ * @file async_transfer.inl
+ * @brief 非同期転送の完了トークンとワーカーの実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "async_transfer.h"
+#include <chrono>
+
+namespace flexhal {
+
+// TransferToken実装
+
+TransferToken TransferToken::create()
+{
+    TransferToken token;
+    token.state_ = std::make_shared<State>();
+    return token;
+}
+
+TransferToken TransferToken::completed(ssize_t result)
+{
+    TransferToken token;
+    token.completed_ = true;
+    token.result_    = result;
+    return token;
+}
+
+bool TransferToken::isDone() const
+{
+    if (!state_) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->done;
+}
+
+bool TransferToken::wait(uint32_t timeout_ms) const
+{
+    if (!state_) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (timeout_ms == WAIT_FOREVER) {
+        state_->cv.wait(lock, [this] { return state_->done; });
+        return true;
+    }
+    return state_->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return state_->done; });
+}
+
+ssize_t TransferToken::getResult() const
+{
+    if (!state_) {
+        return result_;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->done ? state_->result : -1;
+}
+
+void TransferToken::onComplete(Callback callback)
+{
+    if (!callback) {
+        return;
+    }
+    if (!state_) {
+        if (completed_) {
+            callback(result_);
+        }
+        return;
+    }
+
+    ssize_t result;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->done) {
+            state_->callback = std::move(callback);
+            return;
+        }
+        result = state_->result;
+    }
+    callback(result);
+}
+
+void TransferToken::complete(ssize_t result)
+{
+    if (!state_) {
+        return;
+    }
+
+    Callback callback;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->done) {
+            return;
+        }
+        state_->done   = true;
+        state_->result = result;
+        callback       = std::move(state_->callback);
+    }
+    state_->cv.notify_all();
+
+    // コールバックはロックの外で呼び出す
+    if (callback) {
+        callback(result);
+    }
+}
+
+// TransferWorker実装
+
+TransferWorker::~TransferWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+TransferToken TransferWorker::submit(Job job)
+{
+    if (!job) {
+        return TransferToken::completed(-1);
+    }
+
+    TransferToken token = TransferToken::create();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return TransferToken::completed(-1);
+        }
+        queue_.push_back(Entry{std::move(job), token});
+        if (!thread_.joinable()) {
+            thread_ = std::thread(&TransferWorker::run, this);
+        }
+    }
+    cv_.notify_one();
+    return token;
+}
+
+void TransferWorker::run()
+{
+    for (;;) {
+        Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            entry = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        entry.token.complete(entry.job());
+    }
+}
+
+}  // namespace flexhal
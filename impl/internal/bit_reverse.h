@@ -0,0 +1,48 @@
+/**
+ * @file bit_reverse.h
+ * @brief バイト列のビット順反転の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "simd_detect.h"
+
+namespace flexhal {
+
+/**
+ * @brief 1バイトのビット順を反転
+ *
+ * @param value 値
+ * @return uint8_t ビット7とビット0、ビット6とビット1…を入れ替えた値
+ */
+uint8_t reverseBitOrder(uint8_t value);
+
+/**
+ * @brief バイト列の各バイトのビット順を反転（コピー）
+ *
+ * LSBファーストのデバイスとの転送をMSBファーストのハードウェアやモデルで行う際に使用する。
+ * SSSE3・AVX2ではpshufbによる4ビット単位の表引き、AArch64のNEONではvrbitを使い、
+ * それ以外では256要素の表引きで処理する
+ *
+ * @param src 入力
+ * @param dst 出力（srcと同じ領域は可、部分的な重なりは不可）
+ * @param length バイト数
+ */
+void reverseBitOrder(const uint8_t* src, uint8_t* dst, size_t length);
+
+/**
+ * @brief バイト列の各バイトのビット順を反転（その場で）
+ *
+ * @param data データ
+ * @param length バイト数
+ */
+void reverseBitOrder(uint8_t* data, size_t length);
+
+}  // namespace flexhal
@@ -0,0 +1,127 @@
+/**
+ * @file command_stream.h
+ * @brief DCピン付きコマンド列の一括送信の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "spi.h"
+
+namespace flexhal {
+
+/**
+ * @brief DCピン付きコマンド列
+ *
+ * コマンド（DC=Low）とパラメータ・データ（DC=High）の区間を積み上げ、
+ * ISPITransport::writeCommandStream() で1回のCSアクティブ期間として送信する。
+ * コマンドとパラメータは内部にコピーし、data() で追加した区間は呼び出し元のバッファを
+ * 参照したまま送る。DCが同じでメモリ上で連続する区間は1つにまとめる。
+ *
+ * 送信後も内容は保持されるため、初期化シーケンスなどは一度組み立てて繰り返し送信できる
+ */
+class CommandStream {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param transport 送信先のSPIトランスポート（DCピン設定済みであること）
+     */
+    explicit CommandStream(std::shared_ptr<ISPITransport> transport);
+
+    /**
+     * @brief コマンドを追加
+     *
+     * @param command コマンド
+     * @return CommandStream& 自身
+     */
+    CommandStream& command(uint8_t command);
+
+    /**
+     * @brief コマンドとパラメータを追加（パラメータはコピーする）
+     *
+     * @param command コマンド
+     * @param params パラメータ
+     * @param length パラメータ長
+     * @return CommandStream& 自身
+     */
+    CommandStream& command(uint8_t command, const uint8_t* params, size_t length);
+
+    /**
+     * @brief データを追加（コピーせず、run() まで呼び出し元のバッファを参照する）
+     *
+     * @param data データ
+     * @param length データ長
+     * @return CommandStream& 自身
+     */
+    CommandStream& data(const void* data, size_t length);
+
+    /**
+     * @brief 積み上げた区間を送信
+     *
+     * @return true 送信成功
+     * @return false 送信失敗
+     */
+    bool run();
+
+    /**
+     * @brief 積み上げた区間を破棄
+     */
+    void clear();
+
+    /**
+     * @brief 区間数を取得（まとめた後の数）
+     *
+     * @return size_t 区間数
+     */
+    size_t getSegmentCount() const
+    {
+        return entries_.size();
+    }
+
+    /**
+     * @brief 送信するバイト数を取得
+     *
+     * @return size_t バイト数
+     */
+    size_t getLength() const
+    {
+        return length_;
+    }
+
+private:
+    /**
+     * @brief 区間（内部にコピーした区間はバッファの再確保に備えてオフセットで保持する）
+     */
+    struct Entry {
+        bool dc;
+        bool owned;           ///< 内部バッファの区間か
+        const uint8_t* data;  ///< 参照する区間の先頭
+        size_t offset;        ///< 内部バッファの区間の先頭
+        size_t length;
+    };
+
+    /**
+     * @brief 内部バッファにバイト列をコピーして区間を追加
+     *
+     * @param dc DCピンのレベル
+     * @param data データ
+     * @param length データ長
+     */
+    void append(bool dc, const uint8_t* data, size_t length);
+
+    std::shared_ptr<ISPITransport> transport_;
+    std::vector<uint8_t> storage_;
+    std::vector<Entry> entries_;
+    std::vector<SPICommandSegment> segments_;  ///< run() で組み立てる送信区間
+    size_t length_ = 0;
+};
+
+}  // namespace flexhal
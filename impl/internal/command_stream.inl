@@ -0,0 +1,98 @@
+/**
+ * @file command_stream.inl
+ * @brief DCピン付きコマンド列の一括送信の実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "command_stream.h"
+
+namespace flexhal {
+
+// CommandStream実装
+
+CommandStream::CommandStream(std::shared_ptr<ISPITransport> transport) : transport_(std::move(transport))
+{
+}
+
+CommandStream& CommandStream::command(uint8_t command)
+{
+    append(false, &command, 1);
+    return *this;
+}
+
+CommandStream& CommandStream::command(uint8_t command, const uint8_t* params, size_t length)
+{
+    append(false, &command, 1);
+    if (params && length > 0) {
+        append(true, params, length);
+    }
+    return *this;
+}
+
+CommandStream& CommandStream::data(const void* data, size_t length)
+{
+    if (!data || length == 0) {
+        return *this;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    length_ += length;
+
+    // 直前の参照区間とメモリ上で連続していれば延長する（画面幅いっぱいの行など）
+    if (!entries_.empty()) {
+        Entry& last = entries_.back();
+        if (last.dc && !last.owned && last.data + last.length == bytes) {
+            last.length += length;
+            return *this;
+        }
+    }
+    entries_.push_back(Entry{true, false, bytes, 0, length});
+    return *this;
+}
+
+bool CommandStream::run()
+{
+    if (!transport_) {
+        return false;
+    }
+    if (entries_.empty()) {
+        return true;
+    }
+
+    segments_.clear();
+    for (const auto& entry : entries_) {
+        segments_.push_back(
+            SPICommandSegment{entry.dc, entry.owned ? &storage_[entry.offset] : entry.data, entry.length});
+    }
+    return transport_->writeCommandStream(segments_.data(), segments_.size()) == static_cast<ssize_t>(length_);
+}
+
+void CommandStream::clear()
+{
+    storage_.clear();
+    entries_.clear();
+    length_ = 0;
+}
+
+void CommandStream::append(bool dc, const uint8_t* data, size_t length)
+{
+    size_t offset = storage_.size();
+    storage_.insert(storage_.end(), data, data + length);
+    length_ += length;
+
+    // 直前も同じDCの内部バッファの区間なら連続しているので延長する
+    if (!entries_.empty()) {
+        Entry& last = entries_.back();
+        if (last.owned && last.dc == dc && last.offset + last.length == offset) {
+            last.length += length;
+            return;
+        }
+    }
+    entries_.push_back(Entry{dc, true, nullptr, offset, length});
+}
+
+}  // namespace flexhal
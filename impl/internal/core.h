@@ -52,6 +52,15 @@ enum class PinLevel : uint8_t {
     Undefined = 255  ///< 未定義
 };
 
+/**
+ * @brief ピン割り込みのエッジ定義
+ */
+enum class PinEdge : uint8_t {
+    Rising  = 1,  ///< 立ち上がりエッジ
+    Falling = 2,  ///< 立ち下がりエッジ
+    Both    = 3   ///< 両エッジ
+};
+
 /**
  * @brief SPIモード定義
  */
@@ -0,0 +1,155 @@
+/**
+ * @file debounce.h
+ * @brief 複数入力ピンの一括チャタリング除去の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "gpio.h"
+#include "task.h"
+
+namespace flexhal {
+
+/**
+ * @brief 複数入力ピンの一括チャタリング除去
+ *
+ * IGPIOPort::getLevels() でバンク単位にサンプリングし、ビットスライスした縦型カウンタ
+ * （vertical counter）で全ピンを同時に積分する。1回のサンプリングの処理量はピン数によらず
+ * バンクあたり数回のワード演算で済む。
+ *
+ * 各ピンは、安定状態と異なるレベルが指定回数連続した時点で安定状態が反転する。
+ * start() ではサンプリングタスク（createTask()）を起動し、flexhal::sleep() で間隔を空けて update() を呼ぶ。
+ */
+class DebouncedInputs {
+public:
+    /**
+     * @brief 連続一致回数の最大値
+     */
+    static constexpr int MAX_SAMPLES = 15;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port サンプリングするGPIOポート
+     * @param samples 安定とみなす連続一致回数（1〜MAX_SAMPLES）
+     */
+    explicit DebouncedInputs(std::shared_ptr<IGPIOPort> port, int samples = 4);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~DebouncedInputs();
+
+    DebouncedInputs(const DebouncedInputs&)            = delete;
+    DebouncedInputs& operator=(const DebouncedInputs&) = delete;
+
+    /**
+     * @brief 1回分のサンプリングと積分を実行
+     *
+     * 外部のタイマーから駆動する場合に使用する。start()と併用しないこと
+     */
+    void update();
+
+    /**
+     * @brief 一定間隔でサンプリングするタスクを開始
+     *
+     * @param interval_us サンプリング間隔（マイクロ秒）
+     * @return true 開始成功
+     * @return false 開始失敗
+     */
+    bool start(uint32_t interval_us = 1000);
+
+    /**
+     * @brief サンプリングタスクを停止（タスクが終了するまで待機）
+     */
+    void stop();
+
+    /**
+     * @brief サンプリングタスクが実行中か
+     *
+     * @return true 実行中
+     * @return false 停止中
+     */
+    bool isRunning() const
+    {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief バンク数を取得
+     *
+     * @return int バンク数
+     */
+    int getBankCount() const
+    {
+        return static_cast<int>(banks_.size());
+    }
+
+    /**
+     * @brief チャタリング除去後の安定レベルを取得
+     *
+     * @param bank バンク番号
+     * @return uint32_t 安定レベル（ビットマップ）
+     */
+    uint32_t getStable(int bank = 0) const;
+
+    /**
+     * @brief 前回の取得以降に安定レベルが変化したピンを取得してクリア
+     *
+     * @param bank バンク番号
+     * @return uint32_t 変化したピン（ビットマップ）
+     */
+    uint32_t takeChanged(int bank = 0);
+
+    /**
+     * @brief 指定ピンの安定レベルを取得
+     *
+     * @param pin_number ピン番号
+     * @return PinLevel 安定レベル
+     */
+    PinLevel getLevel(int pin_number) const;
+
+private:
+    /**
+     * @brief バンクごとの積分状態
+     */
+    struct Bank {
+        uint32_t counter[4] = {0, 0, 0, 0};  ///< 縦型カウンタ（ビットプレーン）
+        std::atomic<uint32_t> stable{0};     ///< 安定レベル
+        std::atomic<uint32_t> changed{0};    ///< 未取得の変化
+    };
+
+    /**
+     * @brief サンプリングタスクの処理
+     */
+    void run();
+
+    /**
+     * @brief 指定時刻まで待機
+     *
+     * 1ミリ秒以上残っている間はスリープし、残りはyieldしながら待つ
+     *
+     * @param deadline 待機終了時刻（micros() の値）
+     */
+    static void waitUntil(uint32_t deadline);
+
+    std::shared_ptr<IGPIOPort> port_;
+    std::vector<std::unique_ptr<Bank>> banks_;
+    uint32_t threshold_;
+    int planes_;
+    bool primed_ = false;
+    uint32_t interval_us_ = 1000;
+    std::atomic<bool> running_{false};
+    std::shared_ptr<ITask> task_;  ///< サンプリングタスク（停止中はnullptr）
+};
+
+}  // namespace flexhal
@@ -0,0 +1,166 @@
+/**
+ * @file debounce.inl
+ * @brief 複数入力ピンの一括チャタリング除去の実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "debounce.h"
+#include "../../src/flexhal/rtos.hpp"
+
+namespace flexhal {
+
+// DebouncedInputs実装
+
+DebouncedInputs::DebouncedInputs(std::shared_ptr<IGPIOPort> port, int samples) : port_(std::move(port))
+{
+    if (samples < 1) {
+        samples = 1;
+    } else if (samples > MAX_SAMPLES) {
+        samples = MAX_SAMPLES;
+    }
+    threshold_ = static_cast<uint32_t>(samples);
+
+    // 閾値を表現できるだけのビットプレーンを使用
+    planes_ = 0;
+    while ((threshold_ >> planes_) != 0) {
+        ++planes_;
+    }
+
+    int bank_count = port_ ? port_->getBankCount() : 0;
+    for (int i = 0; i < bank_count; ++i) {
+        banks_.push_back(std::unique_ptr<Bank>(new Bank()));
+    }
+}
+
+DebouncedInputs::~DebouncedInputs()
+{
+    stop();
+}
+
+void DebouncedInputs::update()
+{
+    // 初回は現在のレベルをそのまま安定状態とする
+    if (!primed_) {
+        for (size_t i = 0; i < banks_.size(); ++i) {
+            banks_[i]->stable.store(port_->getLevels(static_cast<int>(i)), std::memory_order_release);
+        }
+        primed_ = true;
+        return;
+    }
+
+    for (size_t i = 0; i < banks_.size(); ++i) {
+        Bank& bank      = *banks_[i];
+        uint32_t stable = bank.stable.load(std::memory_order_relaxed);
+        uint32_t delta  = port_->getLevels(static_cast<int>(i)) ^ stable;
+
+        // 安定状態と一致したピンのカウンタをリセットし、不一致のピンを1増やす
+        uint32_t carry = delta;
+        for (int p = 0; p < planes_; ++p) {
+            uint32_t plane  = bank.counter[p] & delta;
+            bank.counter[p] = plane ^ carry;
+            carry &= plane;
+        }
+
+        // カウンタが閾値に達したピンの安定状態を反転
+        uint32_t reached = delta;
+        for (int p = 0; p < planes_; ++p) {
+            reached &= ((threshold_ >> p) & 0x01) ? bank.counter[p] : ~bank.counter[p];
+        }
+        if (reached) {
+            for (int p = 0; p < planes_; ++p) {
+                bank.counter[p] &= ~reached;
+            }
+            bank.stable.store(stable ^ reached, std::memory_order_release);
+            bank.changed.fetch_or(reached, std::memory_order_acq_rel);
+        }
+    }
+}
+
+bool DebouncedInputs::start(uint32_t interval_us)
+{
+    if (!port_ || running_.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    interval_us_ = interval_us > 0 ? interval_us : 1;
+    task_        = createTask("Debounce", [this]() { run(); });
+    if (!task_ || !task_->start()) {
+        task_.reset();
+        running_.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void DebouncedInputs::stop()
+{
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // サンプリングタスクがループを抜けるまで待つ
+    while (task_->isRunning()) {
+        flexhal::sleep(1);
+    }
+    task_.reset();
+}
+
+void DebouncedInputs::run()
+{
+    // 次回の時刻は前回の予定から積算し、処理時間による間隔のずれを防ぐ
+    uint32_t next = flexhal::micros();
+    while (running_.load(std::memory_order_acquire)) {
+        update();
+        next += interval_us_;
+
+        // 大きく遅れた場合は現在時刻から再開する（micros() の桁あふれを考慮して差で比較する）
+        uint32_t now = flexhal::micros();
+        if (static_cast<int32_t>(now - next) > static_cast<int32_t>(interval_us_)) {
+            next = now;
+        }
+        waitUntil(next);
+    }
+}
+
+void DebouncedInputs::waitUntil(uint32_t deadline)
+{
+    int32_t remaining;
+    while ((remaining = static_cast<int32_t>(deadline - flexhal::micros())) > 0) {
+        if (remaining >= 1000) {
+            flexhal::sleep(static_cast<uint32_t>(remaining) / 1000);
+        } else {
+            flexhal::yield();
+        }
+    }
+}
+
+uint32_t DebouncedInputs::getStable(int bank) const
+{
+    if (bank < 0 || static_cast<size_t>(bank) >= banks_.size()) {
+        return 0;
+    }
+    return banks_[bank]->stable.load(std::memory_order_acquire);
+}
+
+uint32_t DebouncedInputs::takeChanged(int bank)
+{
+    if (bank < 0 || static_cast<size_t>(bank) >= banks_.size()) {
+        return 0;
+    }
+    return banks_[bank]->changed.exchange(0, std::memory_order_acq_rel);
+}
+
+PinLevel DebouncedInputs::getLevel(int pin_number) const
+{
+    if (pin_number < 0) {
+        return PinLevel::Low;
+    }
+    uint32_t stable = getStable(pin_number / GPIO_PINS_PER_BANK);
+    return ((stable >> (pin_number % GPIO_PINS_PER_BANK)) & 0x01) ? PinLevel::High : PinLevel::Low;
+}
+
+}  // namespace flexhal
@@ -0,0 +1,292 @@
+/**
+ * @file display.h
+ * @brief フレームバッファ方式のSPIディスプレイの定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "command_stream.h"
+#include "pixel_format.h"
+#include "spi.h"
+
+namespace flexhal {
+
+/**
+ * @brief ディスプレイ上の矩形領域
+ */
+struct DisplayRect {
+    int x      = 0;
+    int y      = 0;
+    int width  = 0;
+    int height = 0;
+
+    /**
+     * @brief 空の領域か確認
+     *
+     * @return true 空
+     * @return false 空でない
+     */
+    bool isEmpty() const
+    {
+        return width <= 0 || height <= 0;
+    }
+
+    /**
+     * @brief 面積を取得
+     *
+     * @return int 面積（ピクセル数）
+     */
+    int getArea() const
+    {
+        return isEmpty() ? 0 : width * height;
+    }
+};
+
+/**
+ * @brief フレームバッファ方式のディスプレイの統計情報
+ */
+struct DisplayStatistics {
+    uint64_t flushes      = 0;  ///< flush() で矩形を送信した回数
+    uint64_t windows      = 0;  ///< 送信した矩形数
+    uint64_t pixels       = 0;  ///< 送信した画素数
+    uint64_t merged_rects = 0;  ///< 結合した矩形数
+};
+
+/**
+ * @brief フレームバッファ方式のSPIディスプレイ
+ *
+ * ST7789やILI9341などのMIPI DCSコマンド互換パネルを RGB565 で駆動する。
+ * 描画はフレームバッファに対して行い、変更された矩形を記録しておく。
+ * flush() では変更された矩形ごとに CASET/RASET/RAMWR と画素データを1つのコマンド列として
+ * 1回のCSアクティブ期間で送信し、画素データはフレームバッファの各行を参照してコピーせずに送る。
+ *
+ * 重なる・接する矩形は1つにまとめ、記録数が上限を超えた場合は結合しても面積の増加が
+ * 最も小さい組をまとめる
+ */
+class FramebufferDisplay {
+public:
+    static constexpr uint8_t CMD_SWRESET = 0x01;
+    static constexpr uint8_t CMD_SLPOUT  = 0x11;
+    static constexpr uint8_t CMD_DISPON  = 0x29;
+    static constexpr uint8_t CMD_CASET   = 0x2A;
+    static constexpr uint8_t CMD_RASET   = 0x2B;
+    static constexpr uint8_t CMD_RAMWR   = 0x2C;
+    static constexpr uint8_t CMD_COLMOD  = 0x3A;
+
+    /**
+     * @brief COLMODの16ビット/ピクセル（RGB565）指定
+     */
+    static constexpr uint8_t COLMOD_RGB565 = 0x55;
+
+    /**
+     * @brief 記録する矩形の上限
+     */
+    static constexpr size_t MAX_DIRTY_RECTS = 8;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param transport パネルに接続されたSPIトランスポート（DCピン設定済みであること）
+     * @param width 幅（ピクセル）
+     * @param height 高さ（ピクセル）
+     * @param offset_x パネルのメモリ上の表示開始列
+     * @param offset_y パネルのメモリ上の表示開始行
+     */
+    FramebufferDisplay(std::shared_ptr<ISPITransport> transport, int width, int height, int offset_x = 0,
+                       int offset_y = 0);
+
+    /**
+     * @brief 初期化（リセット、スリープ解除、RGB565設定、表示オン、全画面送信）
+     *
+     * @return true 初期化成功
+     * @return false 初期化失敗
+     */
+    bool begin();
+
+    /**
+     * @brief 幅を取得
+     *
+     * @return int 幅（ピクセル）
+     */
+    int getWidth() const
+    {
+        return width_;
+    }
+
+    /**
+     * @brief 高さを取得
+     *
+     * @return int 高さ（ピクセル）
+     */
+    int getHeight() const
+    {
+        return height_;
+    }
+
+    /**
+     * @brief 画素を設定
+     *
+     * @param x X座標
+     * @param y Y座標
+     * @param color 色（RGB565）
+     */
+    void setPixel(int x, int y, uint16_t color);
+
+    /**
+     * @brief 画素を取得
+     *
+     * @param x X座標
+     * @param y Y座標
+     * @return uint16_t 色（RGB565、範囲外は0）
+     */
+    uint16_t getPixel(int x, int y) const;
+
+    /**
+     * @brief 矩形を塗りつぶす
+     *
+     * @param x X座標
+     * @param y Y座標
+     * @param width 幅
+     * @param height 高さ
+     * @param color 色（RGB565）
+     */
+    void fillRect(int x, int y, int width, int height, uint16_t color);
+
+    /**
+     * @brief 画面全体を塗りつぶす
+     *
+     * @param color 色（RGB565）
+     */
+    void fillScreen(uint16_t color);
+
+    /**
+     * @brief 画像を描画
+     *
+     * @param x X座標
+     * @param y Y座標
+     * @param width 画像の幅
+     * @param height 画像の高さ
+     * @param pixels 画素データ（RGB565、行優先）
+     */
+    void drawBitmap(int x, int y, int width, int height, const uint16_t* pixels);
+
+    /**
+     * @brief フレームバッファを直接取得
+     *
+     * 画素はパネルへの送信順（上位バイトが先）で格納されている。
+     * 直接書き換えた場合は markDirty() で変更範囲を通知すること
+     *
+     * @return uint8_t* フレームバッファ
+     */
+    uint8_t* getBuffer()
+    {
+        return buffer_.data();
+    }
+
+    /**
+     * @brief 変更された範囲を記録
+     *
+     * @param x X座標
+     * @param y Y座標
+     * @param width 幅
+     * @param height 高さ
+     */
+    void markDirty(int x, int y, int width, int height);
+
+    /**
+     * @brief 記録されている矩形を取得
+     *
+     * @return const std::vector<DisplayRect>& 矩形のリスト
+     */
+    const std::vector<DisplayRect>& getDirtyRects() const
+    {
+        return dirty_;
+    }
+
+    /**
+     * @brief 変更された矩形をパネルへ送信
+     *
+     * 送信に失敗した矩形は変更された矩形として残り、次回の flush() で再送される
+     *
+     * @return true 送信成功
+     * @return false 1つ以上の矩形の送信失敗
+     */
+    bool flush();
+
+    /**
+     * @brief 統計情報を取得
+     *
+     * @return DisplayStatistics 統計情報
+     */
+    DisplayStatistics getStatistics() const
+    {
+        return statistics_;
+    }
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics()
+    {
+        statistics_ = DisplayStatistics();
+    }
+
+private:
+    /**
+     * @brief 矩形を画面内に切り詰める
+     *
+     * @param rect 矩形
+     * @return DisplayRect 切り詰めた矩形
+     */
+    DisplayRect clip(const DisplayRect& rect) const;
+
+    /**
+     * @brief 2つの矩形を囲む矩形を取得
+     */
+    static DisplayRect unite(const DisplayRect& a, const DisplayRect& b);
+
+    /**
+     * @brief 2つの矩形が重なるか接しているか
+     */
+    static bool touches(const DisplayRect& a, const DisplayRect& b);
+
+    /**
+     * @brief コマンドとパラメータを送信
+     *
+     * @param command コマンド
+     * @param params パラメータ
+     * @param length パラメータ長
+     * @return true 送信成功
+     * @return false 送信失敗
+     */
+    bool writeCommand(uint8_t command, const uint8_t* params = nullptr, size_t length = 0);
+
+    /**
+     * @brief 1つの矩形を送信
+     *
+     * @param rect 矩形
+     * @return true 送信成功
+     * @return false 送信失敗
+     */
+    bool sendWindow(const DisplayRect& rect);
+
+    std::shared_ptr<ISPITransport> transport_;
+    int width_;
+    int height_;
+    int offset_x_;
+    int offset_y_;
+    std::vector<uint8_t> buffer_;     ///< フレームバッファ（RGB565、上位バイトが先）
+    std::vector<DisplayRect> dirty_;  ///< 変更された矩形
+    CommandStream stream_;            ///< 矩形の送信に使うコマンド列
+    DisplayStatistics statistics_;
+};
+
+}  // namespace flexhal
@@ -0,0 +1,238 @@
+/**
+ * @file display.inl
+ * @brief フレームバッファ方式のSPIディスプレイの実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "display.h"
+#include <algorithm>
+#include "../../src/flexhal/rtos.hpp"
+
+namespace flexhal {
+
+// FramebufferDisplay実装
+
+FramebufferDisplay::FramebufferDisplay(std::shared_ptr<ISPITransport> transport, int width, int height, int offset_x,
+                                       int offset_y)
+    : transport_(std::move(transport)),
+      width_(std::max(width, 0)),
+      height_(std::max(height, 0)),
+      offset_x_(offset_x),
+      offset_y_(offset_y),
+      buffer_(static_cast<size_t>(width_) * height_ * 2, 0),
+      stream_(transport_)
+{
+    dirty_.reserve(MAX_DIRTY_RECTS + 1);
+}
+
+bool FramebufferDisplay::begin()
+{
+    if (!transport_ || !transport_->begin()) {
+        return false;
+    }
+
+    if (!writeCommand(CMD_SWRESET)) {
+        return false;
+    }
+    flexhal::sleep(150);
+    if (!writeCommand(CMD_SLPOUT)) {
+        return false;
+    }
+    flexhal::sleep(120);
+
+    uint8_t colmod = COLMOD_RGB565;
+    if (!writeCommand(CMD_COLMOD, &colmod, 1) || !writeCommand(CMD_DISPON)) {
+        return false;
+    }
+
+    // パネルのメモリは不定なので全画面を送信する
+    markDirty(0, 0, width_, height_);
+    return flush();
+}
+
+void FramebufferDisplay::setPixel(int x, int y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+        return;
+    }
+
+    uint8_t* p = &buffer_[(static_cast<size_t>(y) * width_ + x) * 2];
+    p[0]       = static_cast<uint8_t>(color >> 8);
+    p[1]       = static_cast<uint8_t>(color);
+    markDirty(x, y, 1, 1);
+}
+
+uint16_t FramebufferDisplay::getPixel(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+        return 0;
+    }
+
+    const uint8_t* p = &buffer_[(static_cast<size_t>(y) * width_ + x) * 2];
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+void FramebufferDisplay::fillRect(int x, int y, int width, int height, uint16_t color)
+{
+    DisplayRect rect = clip(DisplayRect{x, y, width, height});
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    uint8_t hi = static_cast<uint8_t>(color >> 8);
+    uint8_t lo = static_cast<uint8_t>(color);
+    for (int row = rect.y; row < rect.y + rect.height; ++row) {
+        uint8_t* p = &buffer_[(static_cast<size_t>(row) * width_ + rect.x) * 2];
+        for (int col = 0; col < rect.width; ++col) {
+            *p++ = hi;
+            *p++ = lo;
+        }
+    }
+    markDirty(rect.x, rect.y, rect.width, rect.height);
+}
+
+void FramebufferDisplay::fillScreen(uint16_t color)
+{
+    fillRect(0, 0, width_, height_, color);
+}
+
+void FramebufferDisplay::drawBitmap(int x, int y, int width, int height, const uint16_t* pixels)
+{
+    if (!pixels) {
+        return;
+    }
+    DisplayRect rect = clip(DisplayRect{x, y, width, height});
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    for (int row = rect.y; row < rect.y + rect.height; ++row) {
+        const uint16_t* src = pixels + static_cast<size_t>(row - y) * width + (rect.x - x);
+        pixel::swapRGB565(src, &buffer_[(static_cast<size_t>(row) * width_ + rect.x) * 2], rect.width);
+    }
+    markDirty(rect.x, rect.y, rect.width, rect.height);
+}
+
+void FramebufferDisplay::markDirty(int x, int y, int width, int height)
+{
+    DisplayRect rect = clip(DisplayRect{x, y, width, height});
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    // 重なる・接する矩形を吸収し、広がった結果さらに接するものがなくなるまで繰り返す
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < dirty_.size(); ++i) {
+            if (touches(dirty_[i], rect)) {
+                rect      = unite(dirty_[i], rect);
+                dirty_[i] = dirty_.back();
+                dirty_.pop_back();
+                ++statistics_.merged_rects;
+                merged = true;
+                break;
+            }
+        }
+    }
+    dirty_.push_back(rect);
+
+    // 上限を超えたら、結合による面積の増加が最も小さい組をまとめる
+    while (dirty_.size() > MAX_DIRTY_RECTS) {
+        size_t best_i = 0;
+        size_t best_j = 1;
+        int best_cost = -1;
+        for (size_t i = 0; i < dirty_.size(); ++i) {
+            for (size_t j = i + 1; j < dirty_.size(); ++j) {
+                int cost = unite(dirty_[i], dirty_[j]).getArea() - dirty_[i].getArea() - dirty_[j].getArea();
+                if (best_cost < 0 || cost < best_cost) {
+                    best_cost = cost;
+                    best_i    = i;
+                    best_j    = j;
+                }
+            }
+        }
+        dirty_[best_i] = unite(dirty_[best_i], dirty_[best_j]);
+        dirty_[best_j] = dirty_.back();
+        dirty_.pop_back();
+        ++statistics_.merged_rects;
+    }
+}
+
+bool FramebufferDisplay::flush()
+{
+    if (dirty_.empty()) {
+        return true;
+    }
+
+    // 送信できなかった矩形は次の flush() で再送するため残しておく
+    auto sent = std::remove_if(dirty_.begin(), dirty_.end(),
+                               [this](const DisplayRect& rect) { return sendWindow(rect); });
+    dirty_.erase(sent, dirty_.end());
+    ++statistics_.flushes;
+    return dirty_.empty();
+}
+
+DisplayRect FramebufferDisplay::clip(const DisplayRect& rect) const
+{
+    int x0 = std::max(rect.x, 0);
+    int y0 = std::max(rect.y, 0);
+    int x1 = std::min(rect.x + rect.width, width_);
+    int y1 = std::min(rect.y + rect.height, height_);
+    return DisplayRect{x0, y0, x1 - x0, y1 - y0};
+}
+
+DisplayRect FramebufferDisplay::unite(const DisplayRect& a, const DisplayRect& b)
+{
+    int x0 = std::min(a.x, b.x);
+    int y0 = std::min(a.y, b.y);
+    int x1 = std::max(a.x + a.width, b.x + b.width);
+    int y1 = std::max(a.y + a.height, b.y + b.height);
+    return DisplayRect{x0, y0, x1 - x0, y1 - y0};
+}
+
+bool FramebufferDisplay::touches(const DisplayRect& a, const DisplayRect& b)
+{
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+bool FramebufferDisplay::writeCommand(uint8_t command, const uint8_t* params, size_t length)
+{
+    SPICommandSegment segments[2] = {{false, &command, 1}, {true, params, length}};
+    return transport_->writeCommandStream(segments, length > 0 ? 2 : 1) == static_cast<ssize_t>(1 + length);
+}
+
+bool FramebufferDisplay::sendWindow(const DisplayRect& rect)
+{
+    int x0 = rect.x + offset_x_;
+    int y0 = rect.y + offset_y_;
+    int x1 = x0 + rect.width - 1;
+    int y1 = y0 + rect.height - 1;
+
+    uint8_t caset[4] = {static_cast<uint8_t>(x0 >> 8), static_cast<uint8_t>(x0), static_cast<uint8_t>(x1 >> 8),
+                        static_cast<uint8_t>(x1)};
+    uint8_t raset[4] = {static_cast<uint8_t>(y0 >> 8), static_cast<uint8_t>(y0), static_cast<uint8_t>(y1 >> 8),
+                        static_cast<uint8_t>(y1)};
+
+    // CASET/RASET/RAMWRと画素データを1つのコマンド列として1回のCSアクティブ期間で送信する。
+    // 各行はフレームバッファを直接参照し、画面幅いっぱいの矩形は連続しているので1区間にまとまる
+    size_t stride = static_cast<size_t>(width_) * 2;
+    stream_.clear();
+    stream_.command(CMD_CASET, caset, sizeof(caset)).command(CMD_RASET, raset, sizeof(raset)).command(CMD_RAMWR);
+    for (int row = rect.y; row < rect.y + rect.height; ++row) {
+        stream_.data(&buffer_[row * stride + rect.x * 2], static_cast<size_t>(rect.width) * 2);
+    }
+    bool result = stream_.run();
+
+    if (result) {
+        ++statistics_.windows;
+        statistics_.pixels += static_cast<uint64_t>(rect.getArea());
+    }
+    return result;
+}
+
+}  // namespace flexhal
@@ -10,6 +10,9 @@
 
 #pragma once
 
+#include <bitset>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <vector>
 #include "device.h"
@@ -26,6 +29,45 @@ enum class GPIOImplementation {
     Native    ///< ネイティブ実装を使用
 };
 
+/**
+ * @brief 1バンクあたりのピン数
+ *
+ * 一括操作APIはピンを32本ずつのバンクに分けて扱う（ピン番号 = バンク番号 * 32 + ビット位置）
+ */
+constexpr int GPIO_PINS_PER_BANK = 32;
+
+/**
+ * @brief 最下位の1ビットの位置を取得
+ *
+ * マスクの立っているビットだけを走査するために使用する
+ *
+ * @param bits ビットマップ（0以外）
+ * @return int 最下位の1ビットの位置
+ */
+inline int lowestBitIndex(uint32_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#else
+    int index = 0;
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief ピン割り込みコールバック
+ *
+ * 引数はピン番号と、エッジ発生後のピンレベル
+ */
+using PinInterruptCallback = std::function<void(int pin_number, PinLevel level)>;
+
+// 前方宣言
+class GPIOProgram;
+
 /**
  * @brief GPIOポートインターフェース
  */
@@ -56,6 +98,317 @@ public:
      * @return uint32_t 現在のレベル（ビットマップ）
      */
     virtual uint32_t getLevels() const = 0;
+
+    /**
+     * @brief ピンのモードを設定
+     *
+     * @param pin_number ピン番号
+     * @param mode ピンモード
+     */
+    virtual void setPinMode(int pin_number, PinMode mode)
+    {
+        std::shared_ptr<IPin> pin = getPin(pin_number);
+        if (pin) {
+            pin->setMode(mode);
+        }
+    }
+
+    /**
+     * @brief ピンのレベルを設定
+     *
+     * ピンオブジェクトを取得せずに直接設定する高速パス
+     *
+     * @param pin_number ピン番号
+     * @param level 設定するレベル
+     */
+    virtual void writePin(int pin_number, PinLevel level)
+    {
+        if (pin_number < 0) {
+            return;
+        }
+        uint32_t bit = 1u << (pin_number % GPIO_PINS_PER_BANK);
+        setLevels(pin_number / GPIO_PINS_PER_BANK, level == PinLevel::High ? bit : 0, bit);
+    }
+
+    /**
+     * @brief ピンのレベルを取得
+     *
+     * ピンオブジェクトを取得せずに直接読み取る高速パス
+     *
+     * @param pin_number ピン番号
+     * @return PinLevel 現在のレベル
+     */
+    virtual PinLevel readPin(int pin_number) const
+    {
+        if (pin_number < 0) {
+            return PinLevel::Low;
+        }
+        uint32_t levels = getLevels(pin_number / GPIO_PINS_PER_BANK);
+        return ((levels >> (pin_number % GPIO_PINS_PER_BANK)) & 0x01) ? PinLevel::High : PinLevel::Low;
+    }
+
+    /**
+     * @brief バンク数を取得
+     *
+     * @return int 一括操作できるバンク数
+     */
+    virtual int getBankCount() const
+    {
+        return 1;
+    }
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に設定
+     *
+     * 実装はバンク単位でアトミックに更新する
+     *
+     * @param bank バンク番号（ピン bank*32 〜 bank*32+31）
+     * @param values 設定する値（ビットマップ）
+     * @param mask 設定対象のピン（ビットマップ）
+     */
+    virtual void setLevels(int bank, uint32_t values, uint32_t mask)
+    {
+        if (bank == 0) {
+            setLevels(values, mask);
+        }
+    }
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に取得
+     *
+     * @param bank バンク番号
+     * @return uint32_t 現在のレベル（ビットマップ）
+     */
+    virtual uint32_t getLevels(int bank) const
+    {
+        return bank == 0 ? getLevels() : 0;
+    }
+
+    /**
+     * @brief ピン割り込みを登録
+     *
+     * コールバックは割り込みを検出したコンテキストとは別のコンテキストから呼び出されることがある
+     *
+     * @param pin_number ピン番号
+     * @param edge 検出するエッジ
+     * @param callback コールバック関数
+     * @return true 登録成功
+     * @return false 登録失敗（未サポートを含む）
+     */
+    virtual bool attachInterrupt(int pin_number, PinEdge edge, PinInterruptCallback callback)
+    {
+        (void)pin_number;
+        (void)edge;
+        (void)callback;
+        return false;
+    }
+
+    /**
+     * @brief ピン割り込みを解除
+     *
+     * @param pin_number ピン番号
+     */
+    virtual void detachInterrupt(int pin_number)
+    {
+        (void)pin_number;
+    }
+
+    /**
+     * @brief GPIOプログラムを実行
+     *
+     * 実行前にプログラム全体を検証し、バンク番号や読み取り結果の格納先が
+     * 不足している場合は何も実行せずに失敗する
+     *
+     * @param program 実行するプログラム
+     * @param samples 読み取りステップの結果の格納先（不要な場合はnullptr）
+     * @param sample_capacity 格納先の要素数
+     * @return true 実行成功
+     * @return false 未対応、検証失敗、またはレベル待ちのタイムアウト
+     */
+    virtual bool execute(const GPIOProgram& program, uint32_t* samples = nullptr, size_t sample_capacity = 0)
+    {
+        (void)program;
+        (void)samples;
+        (void)sample_capacity;
+        return false;
+    }
+
+    /**
+     * @brief 複数バンクのピンのレベルを一度に設定
+     *
+     * @param values 設定する値（バンク0から順に並んだワード配列）
+     * @param masks 設定対象のピン（バンク0から順に並んだワード配列）
+     * @param word_count ワード数
+     */
+    void setLevels(const uint32_t* values, const uint32_t* masks, size_t word_count)
+    {
+        int bank_count = getBankCount();
+        for (int bank = 0; bank < bank_count && static_cast<size_t>(bank) < word_count; ++bank) {
+            if (masks[bank]) {
+                setLevels(bank, values[bank], masks[bank]);
+            }
+        }
+    }
+
+    /**
+     * @brief 複数バンクのピンのレベルを一度に取得
+     *
+     * @param values 取得先のワード配列（バンク0から順に格納）
+     * @param word_count ワード数
+     * @return size_t 格納したワード数
+     */
+    size_t getLevels(uint32_t* values, size_t word_count) const
+    {
+        size_t count = 0;
+        int bank_count = getBankCount();
+        for (; static_cast<int>(count) < bank_count && count < word_count; ++count) {
+            values[count] = getLevels(static_cast<int>(count));
+        }
+        return count;
+    }
+
+    /**
+     * @brief ビットセットで複数ピンのレベルを一度に設定
+     *
+     * @tparam N ビット数（ピン数）
+     * @param values 設定する値
+     * @param mask 設定対象のピン
+     */
+    template <size_t N>
+    void setLevels(const std::bitset<N>& values, const std::bitset<N>& mask)
+    {
+        const std::bitset<N> word_mask(0xFFFFFFFFul);
+        int bank_count = getBankCount();
+        for (int bank = 0; bank < bank_count && static_cast<size_t>(bank) * GPIO_PINS_PER_BANK < N; ++bank) {
+            size_t shift  = static_cast<size_t>(bank) * GPIO_PINS_PER_BANK;
+            uint32_t bits = static_cast<uint32_t>(((mask >> shift) & word_mask).to_ulong());
+            if (bits) {
+                setLevels(bank, static_cast<uint32_t>(((values >> shift) & word_mask).to_ulong()), bits);
+            }
+        }
+    }
+
+    /**
+     * @brief ビットセットで複数ピンのレベルを一度に取得
+     *
+     * @tparam N ビット数（ピン数）
+     * @param values 取得先のビットセット
+     */
+    template <size_t N>
+    void getLevels(std::bitset<N>& values) const
+    {
+        values.reset();
+        int bank_count = getBankCount();
+        for (int bank = 0; bank < bank_count && static_cast<size_t>(bank) * GPIO_PINS_PER_BANK < N; ++bank) {
+            values |= std::bitset<N>(getLevels(bank)) << (static_cast<size_t>(bank) * GPIO_PINS_PER_BANK);
+        }
+    }
+};
+
+/**
+ * @brief ピンへの非所有ハンドル
+ *
+ * ポートへのポインタとピン番号のみを保持し、操作はポートの writePin/readPin へ直接委譲する。
+ * shared_ptrの参照カウント操作やピンの検索が発生しないため、頻繁にピンを操作する処理で使用する。
+ * ポートより長く保持してはならない。
+ */
+class PinRef {
+public:
+    /**
+     * @brief コンストラクタ（無効なハンドル）
+     */
+    PinRef() = default;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port ピンが属するポート
+     * @param pin_number ピン番号
+     */
+    PinRef(IGPIOPort& port, int pin_number) : port_(&port), pin_number_(pin_number)
+    {
+    }
+
+    /**
+     * @brief 有効なハンドルか
+     *
+     * @return true 有効
+     * @return false 無効
+     */
+    bool isValid() const
+    {
+        return port_ != nullptr && pin_number_ >= 0;
+    }
+
+    /**
+     * @brief ポートを取得
+     *
+     * @return IGPIOPort* ピンが属するポート
+     */
+    IGPIOPort* getPort() const
+    {
+        return port_;
+    }
+
+    /**
+     * @brief ピン番号を取得
+     *
+     * @return int ピン番号
+     */
+    int getPinNumber() const
+    {
+        return pin_number_;
+    }
+
+    /**
+     * @brief ピンモードを設定
+     *
+     * @param mode ピンモード
+     */
+    void setMode(PinMode mode) const
+    {
+        port_->setPinMode(pin_number_, mode);
+    }
+
+    /**
+     * @brief ピンレベルを設定
+     *
+     * @param level ピンレベル
+     */
+    void setLevel(PinLevel level) const
+    {
+        port_->writePin(pin_number_, level);
+    }
+
+    /**
+     * @brief ピンをHighに設定
+     */
+    void setHigh() const
+    {
+        port_->writePin(pin_number_, PinLevel::High);
+    }
+
+    /**
+     * @brief ピンをLowに設定
+     */
+    void setLow() const
+    {
+        port_->writePin(pin_number_, PinLevel::Low);
+    }
+
+    /**
+     * @brief ピンレベルを取得
+     *
+     * @return PinLevel 現在のピンレベル
+     */
+    PinLevel getLevel() const
+    {
+        return port_->readPin(pin_number_);
+    }
+
+private:
+    IGPIOPort* port_ = nullptr;
+    int pin_number_  = -1;
 };
 
 /**
@@ -84,6 +437,15 @@ public:
     std::shared_ptr<IPin> getPin(int pin_number, GPIOImplementation impl = GPIOImplementation::Arduino) override;
     void setLevels(uint32_t values, uint32_t mask) override;
     uint32_t getLevels() const override;
+    void setPinMode(int pin_number, PinMode mode) override;
+    void writePin(int pin_number, PinLevel level) override;
+    PinLevel readPin(int pin_number) const override;
+
+    using IGPIOPort::getLevels;
+    using IGPIOPort::setLevels;
+    int getBankCount() const override;
+    void setLevels(int bank, uint32_t values, uint32_t mask) override;
+    uint32_t getLevels(int bank) const override;
 
     /**
      * @brief ピンを追加
@@ -180,4 +542,114 @@ private:
     enum { SDA_INDEX = 0, SCL_INDEX = 1 };
 };
 
+/**
+ * @brief パラレルバスポート
+ *
+ * 8080系ディスプレイなどの8/16ビットパラレルデータバス用のピングループ。
+ * データ値から物理ピンのビットマスクへの変換テーブルを構築時に作成し、
+ * 1ワードの出力をバンクごとに1回の setLevels で行う
+ */
+class ParallelBusPort : public PinArrayPort {
+public:
+    /**
+     * @brief データバスの最大ビット幅
+     */
+    static constexpr int MAX_DATA_WIDTH = 16;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port データピンが属するGPIOポート
+     * @param data_pins データピンのピン番号（D0から順に、最大16本、重複不可）
+     * @param wr_pin WRストローブのピン番号（-1で使用しない、データピンとの重複不可）
+     */
+    ParallelBusPort(std::shared_ptr<IGPIOPort> port, const std::vector<int>& data_pins, int wr_pin = -1);
+
+    /**
+     * @brief デバイスを初期化
+     *
+     * データピンを出力に、WRピンを出力（High）に設定する
+     *
+     * @return true 初期化成功
+     * @return false ピン構成が不正
+     */
+    bool begin() override;
+
+    /**
+     * @brief データバスのビット幅を取得
+     *
+     * @return int ビット幅（ピン構成が不正な場合は0）
+     */
+    int getDataWidth() const
+    {
+        return data_width_;
+    }
+
+    /**
+     * @brief データバスに値を出力
+     *
+     * @param value 出力する値（下位からD0, D1, ...）
+     */
+    void write(uint32_t value);
+
+    /**
+     * @brief データ列をWRストローブ付きで連続出力
+     *
+     * 各データについて、データ出力とWRのLowを同時に行い、続けてWRをHighにする
+     *
+     * @param data 出力するデータ
+     * @param length データ数
+     */
+    void writeBlock(const uint8_t* data, size_t length);
+
+    /**
+     * @brief 16ビットデータ列をWRストローブ付きで連続出力
+     *
+     * @param data 出力するデータ
+     * @param length データ数
+     */
+    void writeBlock(const uint16_t* data, size_t length);
+
+private:
+    /**
+     * @brief バンクごとの変換テーブル
+     */
+    struct BankTable {
+        int bank;                   ///< 物理バンク番号
+        uint32_t mask;              ///< このバンクに属するデータピン
+        std::vector<uint32_t> lut;  ///< 8ビットレーンごとの値→ピンマスク変換テーブル
+    };
+
+    /**
+     * @brief データ値をバンク内のピンレベルに変換
+     *
+     * @param table 変換テーブル
+     * @param value データ値
+     * @return uint32_t バンク内のピンレベル（ビットマップ）
+     */
+    uint32_t lookup(const BankTable& table, uint32_t value) const
+    {
+        uint32_t levels = table.lut[value & 0xFF];
+        for (int lane = 1; lane < lane_count_; ++lane) {
+            levels |= table.lut[lane * 256 + ((value >> (lane * 8)) & 0xFF)];
+        }
+        return levels;
+    }
+
+    /**
+     * @brief 1ワードをWRストローブ付きで出力
+     *
+     * @param value 出力する値
+     */
+    void strobe(uint32_t value);
+
+    std::shared_ptr<IGPIOPort> port_;
+    std::vector<BankTable> tables_;
+    int data_width_   = 0;
+    int lane_count_   = 0;
+    int wr_bank_      = -1;
+    uint32_t wr_mask_ = 0;
+    bool wr_shared_   = false;  ///< WRピンがデータピンと同じバンクにあるか
+};
+
 }  // namespace flexhal
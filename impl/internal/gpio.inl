@@ -0,0 +1,325 @@
+/**
+ * @file gpio.inl
+ * @brief FlexHAL - 共通GPIOポート（ピン配列ポート）の実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "gpio.h"
+
+namespace flexhal {
+
+// PinArrayPort実装
+
+PinArrayPort::PinArrayPort()
+{
+}
+
+PinArrayPort::PinArrayPort(const std::vector<std::shared_ptr<IPin>>& pins) : pins_(pins)
+{
+}
+
+bool PinArrayPort::begin()
+{
+    initialized_ = true;
+    return true;
+}
+
+void PinArrayPort::end()
+{
+    initialized_ = false;
+}
+
+bool PinArrayPort::isReady() const
+{
+    return initialized_;
+}
+
+std::shared_ptr<IPin> PinArrayPort::getPin(int pin_number, GPIOImplementation impl)
+{
+    (void)impl;
+
+    // ピン番号は配列のインデックスとして扱う
+    if (pin_number < 0 || static_cast<size_t>(pin_number) >= pins_.size()) {
+        return nullptr;
+    }
+
+    return pins_[pin_number];
+}
+
+void PinArrayPort::setLevels(uint32_t values, uint32_t mask)
+{
+    setLevels(0, values, mask);
+}
+
+uint32_t PinArrayPort::getLevels() const
+{
+    return getLevels(0);
+}
+
+void PinArrayPort::setPinMode(int pin_number, PinMode mode)
+{
+    if (pin_number >= 0 && static_cast<size_t>(pin_number) < pins_.size() && pins_[pin_number]) {
+        pins_[pin_number]->setMode(mode);
+    }
+}
+
+void PinArrayPort::writePin(int pin_number, PinLevel level)
+{
+    // shared_ptrをコピーせずに配列内のピンを直接操作する
+    if (pin_number >= 0 && static_cast<size_t>(pin_number) < pins_.size() && pins_[pin_number]) {
+        pins_[pin_number]->setLevel(level);
+    }
+}
+
+PinLevel PinArrayPort::readPin(int pin_number) const
+{
+    if (pin_number >= 0 && static_cast<size_t>(pin_number) < pins_.size() && pins_[pin_number]) {
+        return pins_[pin_number]->getLevel();
+    }
+    return PinLevel::Low;
+}
+
+int PinArrayPort::getBankCount() const
+{
+    return static_cast<int>((pins_.size() + GPIO_PINS_PER_BANK - 1) / GPIO_PINS_PER_BANK);
+}
+
+void PinArrayPort::setLevels(int bank, uint32_t values, uint32_t mask)
+{
+    if (bank < 0 || bank >= getBankCount()) {
+        return;
+    }
+
+    // 任意のピンの集まりなので、マスクの立っているピンだけを個別に設定する
+    size_t base = static_cast<size_t>(bank) * GPIO_PINS_PER_BANK;
+    for (uint32_t bits = mask; bits; bits &= bits - 1) {
+        int bit      = lowestBitIndex(bits);
+        size_t index = base + bit;
+        if (index < pins_.size() && pins_[index]) {
+            pins_[index]->setLevel(((values >> bit) & 0x01) ? PinLevel::High : PinLevel::Low);
+        }
+    }
+}
+
+uint32_t PinArrayPort::getLevels(int bank) const
+{
+    if (bank < 0 || bank >= getBankCount()) {
+        return 0;
+    }
+
+    uint32_t result = 0;
+    size_t base     = static_cast<size_t>(bank) * GPIO_PINS_PER_BANK;
+    for (size_t i = 0; i < GPIO_PINS_PER_BANK && base + i < pins_.size(); ++i) {
+        if (pins_[base + i] && pins_[base + i]->getLevel() == PinLevel::High) {
+            result |= (1u << i);
+        }
+    }
+    return result;
+}
+
+void PinArrayPort::addPin(std::shared_ptr<IPin> pin)
+{
+    pins_.push_back(pin);
+}
+
+// SPIPinPort実装
+
+SPIPinPort::SPIPinPort(std::shared_ptr<IPin> sck, std::shared_ptr<IPin> miso, std::shared_ptr<IPin> mosi,
+                       std::shared_ptr<IPin> cs)
+    : PinArrayPort({sck, miso, mosi, cs})
+{
+}
+
+std::shared_ptr<IPin> SPIPinPort::getSCK() const
+{
+    return pins_[SCK_INDEX];
+}
+
+std::shared_ptr<IPin> SPIPinPort::getMISO() const
+{
+    return pins_[MISO_INDEX];
+}
+
+std::shared_ptr<IPin> SPIPinPort::getMOSI() const
+{
+    return pins_[MOSI_INDEX];
+}
+
+std::shared_ptr<IPin> SPIPinPort::getCS() const
+{
+    return pins_[CS_INDEX];
+}
+
+// I2CPinPort実装
+
+I2CPinPort::I2CPinPort(std::shared_ptr<IPin> sda, std::shared_ptr<IPin> scl) : PinArrayPort({sda, scl})
+{
+}
+
+std::shared_ptr<IPin> I2CPinPort::getSDA() const
+{
+    return pins_[SDA_INDEX];
+}
+
+std::shared_ptr<IPin> I2CPinPort::getSCL() const
+{
+    return pins_[SCL_INDEX];
+}
+
+// ParallelBusPort実装
+
+ParallelBusPort::ParallelBusPort(std::shared_ptr<IGPIOPort> port, const std::vector<int>& data_pins, int wr_pin)
+    : port_(std::move(port))
+{
+    if (!port_ || data_pins.empty() || data_pins.size() > static_cast<size_t>(MAX_DATA_WIDTH)) {
+        return;
+    }
+
+    // 同じピンが複数のビット（またはWR）に割り当てられていると変換テーブルのマスクが重なり、
+    // 出力値が壊れるため拒否する
+    for (size_t i = 0; i < data_pins.size(); ++i) {
+        if (data_pins[i] == wr_pin) {
+            return;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (data_pins[j] == data_pins[i]) {
+                return;
+            }
+        }
+    }
+
+    // データピン（D0から順）とWRピンをピン配列として保持
+    for (int pin_number : data_pins) {
+        std::shared_ptr<IPin> pin = port_->getPin(pin_number);
+        if (!pin) {
+            pins_.clear();
+            return;
+        }
+        pins_.push_back(pin);
+    }
+    if (wr_pin >= 0) {
+        std::shared_ptr<IPin> pin = port_->getPin(wr_pin);
+        if (!pin) {
+            pins_.clear();
+            return;
+        }
+        pins_.push_back(pin);
+        wr_bank_ = wr_pin / GPIO_PINS_PER_BANK;
+        wr_mask_ = 1u << (wr_pin % GPIO_PINS_PER_BANK);
+    }
+
+    data_width_ = static_cast<int>(data_pins.size());
+    lane_count_ = (data_width_ + 7) / 8;
+
+    // 物理バンクごとに、各8ビットレーンの値からピンマスクへの変換テーブルを作成
+    for (size_t bit = 0; bit < data_pins.size(); ++bit) {
+        int bank         = data_pins[bit] / GPIO_PINS_PER_BANK;
+        uint32_t pin_bit = 1u << (data_pins[bit] % GPIO_PINS_PER_BANK);
+
+        BankTable* table = nullptr;
+        for (BankTable& t : tables_) {
+            if (t.bank == bank) {
+                table = &t;
+                break;
+            }
+        }
+        if (!table) {
+            tables_.push_back(BankTable{bank, 0, std::vector<uint32_t>(lane_count_ * 256, 0)});
+            table = &tables_.back();
+        }
+
+        table->mask |= pin_bit;
+        int lane     = static_cast<int>(bit / 8);
+        uint32_t sel = 1u << (bit % 8);
+        for (uint32_t value = 0; value < 256; ++value) {
+            if (value & sel) {
+                table->lut[lane * 256 + value] |= pin_bit;
+            }
+        }
+    }
+
+    for (const BankTable& table : tables_) {
+        if (table.bank == wr_bank_) {
+            wr_shared_ = true;
+        }
+    }
+}
+
+bool ParallelBusPort::begin()
+{
+    if (data_width_ == 0) {
+        return false;
+    }
+
+    for (int i = 0; i < data_width_; ++i) {
+        pins_[i]->setMode(PinMode::Output);
+    }
+    if (wr_mask_) {
+        pins_[data_width_]->setMode(PinMode::Output);
+        pins_[data_width_]->setLevel(PinLevel::High);
+    }
+
+    return PinArrayPort::begin();
+}
+
+void ParallelBusPort::write(uint32_t value)
+{
+    for (const BankTable& table : tables_) {
+        port_->setLevels(table.bank, lookup(table, value), table.mask);
+    }
+}
+
+void ParallelBusPort::strobe(uint32_t value)
+{
+    // データ出力と同時にWRをLowにし（同一バンクの場合）、その後の立ち上がりでラッチさせる
+    if (!wr_shared_) {
+        port_->setLevels(wr_bank_, 0, wr_mask_);
+    }
+    for (const BankTable& table : tables_) {
+        uint32_t mask = table.bank == wr_bank_ ? table.mask | wr_mask_ : table.mask;
+        port_->setLevels(table.bank, lookup(table, value), mask);
+    }
+    port_->setLevels(wr_bank_, wr_mask_, wr_mask_);
+}
+
+void ParallelBusPort::writeBlock(const uint8_t* data, size_t length)
+{
+    if (data_width_ == 0 || !data) {
+        return;
+    }
+
+    if (!wr_mask_) {
+        for (size_t i = 0; i < length; ++i) {
+            write(data[i]);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        strobe(data[i]);
+    }
+}
+
+void ParallelBusPort::writeBlock(const uint16_t* data, size_t length)
+{
+    if (data_width_ == 0 || !data) {
+        return;
+    }
+
+    if (!wr_mask_) {
+        for (size_t i = 0; i < length; ++i) {
+            write(data[i]);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        strobe(data[i]);
+    }
+}
+
+}  // namespace flexhal
@@ -0,0 +1,305 @@
+/**
+ * @file gpio_program.h
+ * @brief GPIO操作列（GPIOプログラム）の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core.h"
+#include "gpio.h"
+
+namespace flexhal {
+
+/**
+ * @brief GPIO操作列（GPIOプログラム）
+ *
+ * レベル一括設定・待機・レベル待ち・サンプリングの各ステップを32ビットワード列の
+ * バイトコードとして記録し、IGPIOPort::execute() で一度に実行する。
+ * 初期化シーケンスやハンドシェイクのように決まった手順のピン操作を、
+ * ステップごとの仮想関数呼び出しやピンの取得なしで実行できる。
+ *
+ * 命令形式（先頭ワードの下位8ビットが命令コード）：
+ * - SetLevels: [op | bank << 8] [values] [mask]
+ * - Delay:     [op] [マイクロ秒]
+ * - WaitLevel: [op | pin << 8 | level << 24] [タイムアウト（マイクロ秒）]
+ * - Sample:    [op | bank << 8] [mask]
+ */
+class GPIOProgram {
+public:
+    /**
+     * @brief 命令コード
+     */
+    enum class OpCode : uint8_t {
+        SetLevels = 1,  ///< バンクのレベルを一括設定
+        Delay     = 2,  ///< 指定時間待機
+        WaitLevel = 3,  ///< ピンが指定レベルになるまで待機
+        Sample    = 4   ///< バンクのレベルを読み取り結果に格納
+    };
+
+    /**
+     * @brief 使用できる最大のバンク番号
+     */
+    static constexpr int MAX_BANK = 0xFF;
+
+    /**
+     * @brief 使用できる最大のピン番号
+     */
+    static constexpr int MAX_PIN = 0xFFFF;
+
+    /**
+     * @brief バンクのレベルを一括設定するステップを追加
+     *
+     * @param bank バンク番号
+     * @param values 設定する値（ビットマップ）
+     * @param mask 設定対象のピン（ビットマップ）
+     * @return GPIOProgram& このプログラム
+     */
+    GPIOProgram& setLevels(int bank, uint32_t values, uint32_t mask)
+    {
+        if (bank < 0 || bank > MAX_BANK) {
+            valid_ = false;
+            return *this;
+        }
+        code_.push_back(encode(OpCode::SetLevels, static_cast<uint32_t>(bank)));
+        code_.push_back(values);
+        code_.push_back(mask);
+        updateMaxBank(bank);
+        return *this;
+    }
+
+    /**
+     * @brief ピンのレベルを設定するステップを追加
+     *
+     * @param pin_number ピン番号
+     * @param level 設定するレベル
+     * @return GPIOProgram& このプログラム
+     */
+    GPIOProgram& setLevel(int pin_number, PinLevel level)
+    {
+        if (pin_number < 0) {
+            valid_ = false;
+            return *this;
+        }
+        uint32_t bit = 1u << (pin_number % GPIO_PINS_PER_BANK);
+        return setLevels(pin_number / GPIO_PINS_PER_BANK, level == PinLevel::High ? bit : 0, bit);
+    }
+
+    /**
+     * @brief 待機するステップを追加
+     *
+     * @param us 待機時間（マイクロ秒）
+     * @return GPIOProgram& このプログラム
+     */
+    GPIOProgram& delayMicroseconds(uint32_t us)
+    {
+        code_.push_back(encode(OpCode::Delay, 0));
+        code_.push_back(us);
+        return *this;
+    }
+
+    /**
+     * @brief ピンが指定レベルになるまで待機するステップを追加
+     *
+     * タイムアウトした場合、プログラムの実行はそこで失敗する
+     *
+     * @param pin_number ピン番号
+     * @param level 待機するレベル
+     * @param timeout_us タイムアウト（マイクロ秒）
+     * @return GPIOProgram& このプログラム
+     */
+    GPIOProgram& waitLevel(int pin_number, PinLevel level, uint32_t timeout_us)
+    {
+        if (pin_number < 0 || pin_number > MAX_PIN) {
+            valid_ = false;
+            return *this;
+        }
+        uint32_t operand = static_cast<uint32_t>(pin_number) | ((level == PinLevel::High ? 1u : 0u) << 16);
+        code_.push_back(encode(OpCode::WaitLevel, operand));
+        code_.push_back(timeout_us);
+        updateMaxBank(pin_number / GPIO_PINS_PER_BANK);
+        return *this;
+    }
+
+    /**
+     * @brief バンクのレベルを読み取るステップを追加
+     *
+     * 読み取り結果は execute() に渡した配列へ、ステップの順に格納される
+     *
+     * @param bank バンク番号
+     * @param mask 読み取り対象のピン（ビットマップ）
+     * @return GPIOProgram& このプログラム
+     */
+    GPIOProgram& sample(int bank, uint32_t mask = 0xFFFFFFFF)
+    {
+        if (bank < 0 || bank > MAX_BANK) {
+            valid_ = false;
+            return *this;
+        }
+        code_.push_back(encode(OpCode::Sample, static_cast<uint32_t>(bank)));
+        code_.push_back(mask);
+        updateMaxBank(bank);
+        ++sample_count_;
+        return *this;
+    }
+
+    /**
+     * @brief すべてのステップを削除
+     */
+    void clear()
+    {
+        code_.clear();
+        sample_count_ = 0;
+        max_bank_     = -1;
+        valid_        = true;
+    }
+
+    /**
+     * @brief 不正な引数のステップが追加されていないか
+     *
+     * @return true 正常
+     * @return false 不正なステップがある
+     */
+    bool isValid() const
+    {
+        return valid_;
+    }
+
+    /**
+     * @brief 実行可能か検証
+     *
+     * @param bank_count 実行するポートのバンク数
+     * @param sample_capacity 読み取り結果の格納先の要素数
+     * @return true 実行可能
+     * @return false 実行不可
+     */
+    bool validate(int bank_count, size_t sample_capacity) const
+    {
+        return valid_ && max_bank_ < bank_count && sample_count_ <= sample_capacity;
+    }
+
+    /**
+     * @brief バイトコードを取得
+     *
+     * @return const uint32_t* バイトコードの先頭
+     */
+    const uint32_t* getCode() const
+    {
+        return code_.data();
+    }
+
+    /**
+     * @brief バイトコードのワード数を取得
+     *
+     * @return size_t ワード数
+     */
+    size_t getCodeSize() const
+    {
+        return code_.size();
+    }
+
+    /**
+     * @brief 読み取りステップの数を取得
+     *
+     * @return size_t 読み取りステップの数
+     */
+    size_t getSampleCount() const
+    {
+        return sample_count_;
+    }
+
+private:
+    static uint32_t encode(OpCode op, uint32_t operand)
+    {
+        return static_cast<uint32_t>(op) | (operand << 8);
+    }
+
+    void updateMaxBank(int bank)
+    {
+        if (bank > max_bank_) {
+            max_bank_ = bank;
+        }
+    }
+
+    std::vector<uint32_t> code_;
+    size_t sample_count_ = 0;
+    int max_bank_        = -1;
+    bool valid_          = true;
+};
+
+/**
+ * @brief GPIOプログラムを実行
+ *
+ * 各ポートの execute() から、ポート固有の操作を直接呼び出す実行器を渡して使用する。
+ * プログラムは事前に GPIOProgram::validate() で検証済みであること。
+ *
+ * 実行器は以下の関数を提供する必要がある：
+ * - void setLevels(int bank, uint32_t values, uint32_t mask)
+ * - uint32_t getLevels(int bank, uint32_t mask)
+ * - void delayMicroseconds(uint32_t us)
+ * - uint32_t micros()
+ *
+ * @tparam Executor 実行器の型
+ * @param program 実行するプログラム
+ * @param executor 実行器
+ * @param samples 読み取り結果の格納先
+ * @return true 実行成功
+ * @return false レベル待ちがタイムアウトした、または不正な命令があった
+ */
+template <class Executor>
+bool runGPIOProgram(const GPIOProgram& program, Executor& executor, uint32_t* samples)
+{
+    const uint32_t* code = program.getCode();
+    size_t size          = program.getCodeSize();
+    size_t sample_index  = 0;
+
+    for (size_t pc = 0; pc < size;) {
+        uint32_t word    = code[pc];
+        uint32_t operand = word >> 8;
+        switch (static_cast<GPIOProgram::OpCode>(word & 0xFF)) {
+            case GPIOProgram::OpCode::SetLevels:
+                executor.setLevels(static_cast<int>(operand), code[pc + 1], code[pc + 2]);
+                pc += 3;
+                break;
+
+            case GPIOProgram::OpCode::Delay:
+                executor.delayMicroseconds(code[pc + 1]);
+                pc += 2;
+                break;
+
+            case GPIOProgram::OpCode::WaitLevel: {
+                int pin_number = static_cast<int>(operand & 0xFFFF);
+                int bank       = pin_number / GPIO_PINS_PER_BANK;
+                uint32_t bit   = 1u << (pin_number % GPIO_PINS_PER_BANK);
+                uint32_t level = (operand >> 16) ? bit : 0;
+                uint32_t start = executor.micros();
+                while (executor.getLevels(bank, bit) != level) {
+                    if (executor.micros() - start >= code[pc + 1]) {
+                        return false;
+                    }
+                }
+                pc += 2;
+                break;
+            }
+
+            case GPIOProgram::OpCode::Sample:
+                samples[sample_index++] = executor.getLevels(static_cast<int>(operand), code[pc + 1]);
+                pc += 2;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace flexhal
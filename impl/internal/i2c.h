@@ -10,14 +10,23 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include "core.h"
 #include "transport.h"
+#include "transport_cache.h"
+#include "i2c_presence.h"
 #include "pin.h"
 
 namespace flexhal {
 
+/**
+ * @brief スキャンするアドレスの範囲（予約アドレスを除く7ビットアドレス）
+ */
+constexpr I2CAddress I2C_SCAN_FIRST_ADDRESS = 0x08;
+constexpr I2CAddress I2C_SCAN_LAST_ADDRESS  = 0x77;
+
 /**
  * @brief I2Cバス設定
  */
@@ -49,7 +58,27 @@ public:
     virtual void setAddress(I2CAddress address) = 0;
 
     /**
-     * @brief バス上のデバイスをスキャン
+     * @brief データを書き込んでから読み込み（レジスタ読み出しなど）
+     *
+     * リピーテッドスタートに対応する実装では、書き込みと読み込みの間にSTOPを挟まない。
+     * 既定の実装は write() と read() を順に呼び出す
+     *
+     * @param tx_data 書き込むデータ
+     * @param tx_length 書き込むバイト数
+     * @param rx_data 読み込み先バッファ
+     * @param rx_length 読み込むバイト数
+     * @return ssize_t 読み込んだバイト数（負の値はエラー）
+     */
+    virtual ssize_t writeRead(const void* tx_data, size_t tx_length, void* rx_data, size_t rx_length)
+    {
+        if (tx_length > 0 && write(tx_data, tx_length) != static_cast<ssize_t>(tx_length)) {
+            return -1;
+        }
+        return read(rx_data, rx_length);
+    }
+
+    /**
+     * @brief バス上のデバイスをスキャン（I2C_SCAN_FIRST_ADDRESS から I2C_SCAN_LAST_ADDRESS まで）
      *
      * @return std::vector<I2CAddress> 見つかったデバイスのアドレスリスト
      */
@@ -63,6 +92,34 @@ public:
      * @return false デバイスが存在しない
      */
     virtual bool probe(I2CAddress address) = 0;
+
+    /**
+     * @brief 転送でアドレスにNACKが返されたときの通知先を設定
+     *
+     * I2CBusが在否キャッシュの無効化に使用する。probe() のNACKは通知しない
+     *
+     * @param handler 通知先（nullptrで解除）
+     */
+    void setNackHandler(std::function<void(I2CAddress address)> handler)
+    {
+        nack_handler_ = std::move(handler);
+    }
+
+protected:
+    /**
+     * @brief アドレスにNACKが返されたことを通知（実装クラスが転送の失敗時に呼び出す）
+     *
+     * @param address NACKを返したアドレス
+     */
+    void notifyNack(I2CAddress address) const
+    {
+        if (nack_handler_) {
+            nack_handler_(address);
+        }
+    }
+
+private:
+    std::function<void(I2CAddress address)> nack_handler_;
 };
 
 /**
@@ -115,10 +172,71 @@ public:
      */
     virtual std::shared_ptr<II2CTransport> getTransport(const I2CDeviceConfig& device_config,
                                                         std::shared_ptr<I2CBusImplementation> implementation) = 0;
+
+    /**
+     * @brief 範囲内のデバイスをスキャン
+     *
+     * 前回までに確認したアドレスは在否キャッシュから応答し、未確認のアドレスだけをプローブする。
+     * 既定の実装はキャッシュを持たず、範囲内のすべてのアドレスを毎回プローブする
+     *
+     * @param first 先頭アドレス
+     * @param last 末尾アドレス（範囲に含む）
+     * @return std::vector<I2CAddress> 見つかったデバイスのアドレスリスト
+     */
+    virtual std::vector<I2CAddress> scan(I2CAddress first, I2CAddress last)
+    {
+        std::vector<I2CAddress> found;
+        auto transport = getTransport(I2CDeviceConfig());
+        if (!transport || (!transport->isReady() && !transport->begin())) {
+            return found;
+        }
+        for (int address = first; address <= last; ++address) {
+            if (transport->probe(static_cast<I2CAddress>(address))) {
+                found.push_back(static_cast<I2CAddress>(address));
+            }
+        }
+        return found;
+    }
+
+    /**
+     * @brief 範囲の在否キャッシュを破棄してから再スキャン
+     *
+     * 既定の実装は notifyHotPlug() の後に scan() を呼び出す
+     *
+     * @param first 先頭アドレス
+     * @param last 末尾アドレス（範囲に含む）
+     * @return std::vector<I2CAddress> 見つかったデバイスのアドレスリスト
+     */
+    virtual std::vector<I2CAddress> rescan(I2CAddress first, I2CAddress last)
+    {
+        notifyHotPlug(first, last);
+        return scan(first, last);
+    }
+
+    /**
+     * @brief デバイスの抜き差しを通知（範囲の在否キャッシュを破棄し、次のスキャンで再確認する）
+     *
+     * 既定の実装は何もしない（キャッシュを持たない実装）
+     *
+     * @param first 先頭アドレス
+     * @param last 末尾アドレス（範囲に含む）
+     */
+    virtual void notifyHotPlug(I2CAddress first, I2CAddress last)
+    {
+        (void)first;
+        (void)last;
+    }
 };
 
 /**
  * @brief I2Cバス実装
+ *
+ * 取得したトランスポートはデバイス設定（アドレス、クロック）と実装をキーにキャッシュされ、
+ * 同じ設定での取得には同じインスタンスが共有される。共有されたトランスポートの設定を
+ * 変更したり end() を呼び出したりすると、他の利用者にも影響する点に注意すること。
+ * 設定を変更しながら使う場合は I2CBusImplementation::createTransport() で専用のトランスポートを作成すること。
+ * スキャン結果は在否キャッシュに保持し、取得したトランスポートの転送でアドレスにNACKが
+ * 返された場合や、notifyHotPlug() が呼び出された場合に該当するアドレスを破棄する
  */
 class I2CBus : public II2CBus {
 public:
@@ -137,6 +255,10 @@ public:
     std::shared_ptr<II2CTransport> getTransport(const I2CDeviceConfig& device_config,
                                                 std::shared_ptr<I2CBusImplementation> implementation) override;
 
+    std::vector<I2CAddress> scan(I2CAddress first, I2CAddress last) override;
+    std::vector<I2CAddress> rescan(I2CAddress first, I2CAddress last) override;
+    void notifyHotPlug(I2CAddress first, I2CAddress last) override;
+
     /**
      * @brief 実装を追加
      *
@@ -144,9 +266,93 @@ public:
      */
     void addImplementation(std::shared_ptr<I2CBusImplementation> implementation);
 
+    /**
+     * @brief トランスポートキャッシュの統計情報を取得
+     *
+     * @return TransportCacheStatistics 統計情報
+     */
+    TransportCacheStatistics getTransportCacheStatistics() const
+    {
+        return transport_cache_.getStatistics();
+    }
+
+    /**
+     * @brief トランスポートキャッシュの統計情報をリセット
+     */
+    void resetTransportCacheStatistics()
+    {
+        transport_cache_.resetStatistics();
+    }
+
+    /**
+     * @brief トランスポートキャッシュの容量を設定
+     *
+     * @param capacity 容量
+     */
+    void setTransportCacheCapacity(size_t capacity)
+    {
+        transport_cache_.setCapacity(capacity);
+    }
+
+    /**
+     * @brief トランスポートキャッシュを空にする
+     */
+    void clearTransportCache()
+    {
+        transport_cache_.clear();
+    }
+
+    /**
+     * @brief 在否キャッシュの統計情報を取得
+     *
+     * @return I2CPresenceStatistics 統計情報
+     */
+    I2CPresenceStatistics getPresenceStatistics() const
+    {
+        return presence_->getStatistics();
+    }
+
+    /**
+     * @brief 在否キャッシュの統計情報をリセット
+     */
+    void resetPresenceStatistics()
+    {
+        presence_->resetStatistics();
+    }
+
+    /**
+     * @brief 在否キャッシュで確認済みのアドレスを取得
+     *
+     * @return I2CAddressBitmap 確認済みのアドレス
+     */
+    I2CAddressBitmap getKnownAddresses() const
+    {
+        return presence_->getKnown();
+    }
+
 private:
+    /**
+     * @brief トランスポートキャッシュのキー
+     */
+    struct TransportKey {
+        I2CDeviceConfig config;
+        const I2CBusImplementation* implementation;  ///< 指定された実装（自動選択の場合はnullptr）
+
+        bool operator==(const TransportKey& other) const;
+    };
+
+    /**
+     * @brief 新しく作成したトランスポートのNACKで在否キャッシュを破棄するよう設定
+     *
+     * @param transport トランスポート
+     * @return std::shared_ptr<II2CTransport> 同じトランスポート
+     */
+    std::shared_ptr<II2CTransport> watchNacks(std::shared_ptr<II2CTransport> transport) const;
+
     I2CBusConfig config_;
     std::vector<std::shared_ptr<I2CBusImplementation>> implementations_;
+    TransportCache<TransportKey, II2CTransport> transport_cache_;
+    std::shared_ptr<I2CPresenceCache> presence_;  ///< トランスポートより先に破棄されても安全なよう共有する
     bool initialized_ = false;
 };
 
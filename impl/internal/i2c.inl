@@ -0,0 +1,174 @@
+/**
+ * @file i2c.inl
+ * @brief FlexHAL - I2Cバスの共通実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "i2c.h"
+#include "../../src/flexhal/i2c.hpp"
+#include <thread>
+
+namespace flexhal {
+
+// I2CBus実装
+
+I2CBus::I2CBus(const I2CBusConfig& config) : config_(config), presence_(std::make_shared<I2CPresenceCache>())
+{
+}
+
+bool I2CBus::begin()
+{
+    initialized_ = true;
+    return true;
+}
+
+void I2CBus::end()
+{
+    transport_cache_.clear();
+    presence_->invalidate(0, I2CAddressBitmap::MAX_ADDRESS);
+    initialized_ = false;
+}
+
+bool I2CBus::isReady() const
+{
+    return initialized_;
+}
+
+std::shared_ptr<II2CTransport> I2CBus::getTransport(const I2CDeviceConfig& device_config)
+{
+    TransportKey key{device_config, nullptr};
+    if (auto transport = transport_cache_.find(key)) {
+        return transport;
+    }
+
+    // 追加された順に、トランスポートを作成できた最初の実装を使用する
+    for (const auto& implementation : implementations_) {
+        if (implementation && implementation->isAvailable()) {
+            auto transport = implementation->createTransport(config_, device_config);
+            if (transport) {
+                return transport_cache_.insert(key, watchNacks(transport));
+            }
+        }
+    }
+
+    // 利用可能な実装がなければソフトウェアI2Cを使用する
+    return transport_cache_.insert(
+        key, watchNacks(createSoftwareI2CImplementation()->createTransport(config_, device_config)));
+}
+
+std::shared_ptr<II2CTransport> I2CBus::getTransport(const I2CDeviceConfig& device_config,
+                                                    std::shared_ptr<I2CBusImplementation> implementation)
+{
+    if (!implementation || !implementation->isAvailable()) {
+        return nullptr;
+    }
+
+    TransportKey key{device_config, implementation.get()};
+    if (auto transport = transport_cache_.find(key)) {
+        return transport;
+    }
+    return transport_cache_.insert(key, watchNacks(implementation->createTransport(config_, device_config)));
+}
+
+std::vector<I2CAddress> I2CBus::scan(I2CAddress first, I2CAddress last)
+{
+    auto transport = getTransport(I2CDeviceConfig());
+    if (!transport || (!transport->isReady() && !transport->begin())) {
+        return {};
+    }
+    return presence_->scan(*transport, first, last);
+}
+
+std::vector<I2CAddress> I2CBus::rescan(I2CAddress first, I2CAddress last)
+{
+    presence_->invalidate(first, last);
+    return scan(first, last);
+}
+
+void I2CBus::notifyHotPlug(I2CAddress first, I2CAddress last)
+{
+    presence_->invalidate(first, last);
+}
+
+void I2CBus::addImplementation(std::shared_ptr<I2CBusImplementation> implementation)
+{
+    if (implementation) {
+        implementations_.push_back(implementation);
+
+        // 自動選択の結果が変わる可能性があるため、キャッシュを破棄する
+        transport_cache_.clear();
+        presence_->invalidate(0, I2CAddressBitmap::MAX_ADDRESS);
+    }
+}
+
+std::shared_ptr<II2CTransport> I2CBus::watchNacks(std::shared_ptr<II2CTransport> transport) const
+{
+    if (transport) {
+        // バスが先に破棄された場合は何もしない
+        std::weak_ptr<I2CPresenceCache> presence = presence_;
+        transport->setNackHandler([presence](I2CAddress address) {
+            if (auto cache = presence.lock()) {
+                cache->invalidate(address, address);
+            }
+        });
+    }
+    return transport;
+}
+
+bool I2CBus::TransportKey::operator==(const TransportKey& other) const
+{
+    return config.address == other.config.address && config.clock_hz == other.config.clock_hz &&
+           implementation == other.implementation;
+}
+
+// I2Cバスを作成
+std::shared_ptr<II2CBus> createI2CBus(const I2CBusConfig& config)
+{
+    return std::make_shared<I2CBus>(config);
+}
+
+// ソフトウェアI2C実装を作成
+std::shared_ptr<I2CBusImplementation> createSoftwareI2CImplementation()
+{
+    return std::make_shared<SoftwareI2CImplementation>();
+}
+
+// I2Cバス上のデバイスをスキャン
+std::vector<I2CAddress> scanI2CDevices(std::shared_ptr<II2CBus> bus)
+{
+    if (!bus) {
+        return {};
+    }
+
+    return bus->scan(I2C_SCAN_FIRST_ADDRESS, I2C_SCAN_LAST_ADDRESS);
+}
+
+// 複数のI2Cバス上のデバイスをスキャン
+std::vector<std::vector<I2CAddress>> scanI2CBuses(const std::vector<std::shared_ptr<II2CBus>>& buses, bool parallel)
+{
+    std::vector<std::vector<I2CAddress>> results(buses.size());
+    if (!parallel || buses.size() < 2) {
+        for (size_t i = 0; i < buses.size(); ++i) {
+            results[i] = scanI2CDevices(buses[i]);
+        }
+        return results;
+    }
+
+    // バスごとのスレッドで同時にプローブし、先頭のバスは呼び出し元のスレッドが担当する
+    std::vector<std::thread> threads;
+    threads.reserve(buses.size() - 1);
+    for (size_t i = 1; i < buses.size(); ++i) {
+        threads.emplace_back([&results, &buses, i]() { results[i] = scanI2CDevices(buses[i]); });
+    }
+    results[0] = scanI2CDevices(buses[0]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+}  // namespace flexhal
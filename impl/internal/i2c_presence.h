@@ -0,0 +1,239 @@
+/**
+ * @file i2c_presence.h
+ * @brief I2Cデバイスの在否キャッシュ
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "core.h"
+
+namespace flexhal {
+
+class II2CTransport;
+
+/**
+ * @brief 7ビットアドレス空間を1ビットずつで表す128ビットのビットマップ
+ *
+ * 範囲外のアドレスに対する操作は無視する
+ */
+class I2CAddressBitmap {
+public:
+    /**
+     * @brief 7ビットアドレスの最大値
+     */
+    static constexpr I2CAddress MAX_ADDRESS = 0x7F;
+
+    /**
+     * @brief 範囲内のアドレスだけが立ったビットマップを作成
+     *
+     * @param first 先頭アドレス
+     * @param last 末尾アドレス（範囲に含む）
+     * @return I2CAddressBitmap ビットマップ（first > last の場合は空）
+     */
+    static I2CAddressBitmap range(I2CAddress first, I2CAddress last);
+
+    /**
+     * @brief アドレスのビットを立てる
+     *
+     * @param address 7ビットアドレス
+     */
+    void set(I2CAddress address)
+    {
+        if (address <= MAX_ADDRESS) {
+            words_[address / 32] |= 1u << (address % 32);
+        }
+    }
+
+    /**
+     * @brief アドレスのビットを下ろす
+     *
+     * @param address 7ビットアドレス
+     */
+    void reset(I2CAddress address)
+    {
+        if (address <= MAX_ADDRESS) {
+            words_[address / 32] &= ~(1u << (address % 32));
+        }
+    }
+
+    /**
+     * @brief アドレスのビットが立っているか確認
+     *
+     * @param address 7ビットアドレス
+     * @return true 立っている
+     * @return false 立っていない、または範囲外
+     */
+    bool test(I2CAddress address) const
+    {
+        return address <= MAX_ADDRESS && ((words_[address / 32] >> (address % 32)) & 1u);
+    }
+
+    /**
+     * @brief 立っているビットの数を取得
+     *
+     * @return size_t ビット数
+     */
+    size_t count() const;
+
+    /**
+     * @brief ビットが1つも立っていないか確認
+     *
+     * @return true 空
+     * @return false 1つ以上立っている
+     */
+    bool none() const
+    {
+        return (words_[0] | words_[1] | words_[2] | words_[3]) == 0;
+    }
+
+    /**
+     * @brief 立っているアドレスを昇順に取得（立っているビットだけを走査する）
+     *
+     * @return std::vector<I2CAddress> アドレスのリスト
+     */
+    std::vector<I2CAddress> toVector() const;
+
+    I2CAddressBitmap operator&(const I2CAddressBitmap& other) const
+    {
+        I2CAddressBitmap result;
+        for (int i = 0; i < WORD_COUNT; ++i) {
+            result.words_[i] = words_[i] & other.words_[i];
+        }
+        return result;
+    }
+
+    I2CAddressBitmap operator|(const I2CAddressBitmap& other) const
+    {
+        I2CAddressBitmap result;
+        for (int i = 0; i < WORD_COUNT; ++i) {
+            result.words_[i] = words_[i] | other.words_[i];
+        }
+        return result;
+    }
+
+    I2CAddressBitmap operator~() const
+    {
+        I2CAddressBitmap result;
+        for (int i = 0; i < WORD_COUNT; ++i) {
+            result.words_[i] = ~words_[i];
+        }
+        return result;
+    }
+
+    bool operator==(const I2CAddressBitmap& other) const
+    {
+        for (int i = 0; i < WORD_COUNT; ++i) {
+            if (words_[i] != other.words_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr int WORD_COUNT = (MAX_ADDRESS + 1) / 32;
+
+    uint32_t words_[WORD_COUNT] = {};
+};
+
+/**
+ * @brief 在否キャッシュの統計情報
+ */
+struct I2CPresenceStatistics {
+    uint64_t cached        = 0;  ///< キャッシュから応答したアドレス数
+    uint64_t probes        = 0;  ///< バス上でプローブしたアドレス数
+    uint64_t invalidations = 0;  ///< 無効化の回数（NACKとホットプラグ通知を含む）
+};
+
+/**
+ * @brief I2Cバスのデバイス在否キャッシュ
+ *
+ * 確認済みのアドレスと、そのうち応答したアドレスを2つの128ビットのビットマップで保持する。
+ * スキャンは確認済みの範囲をビットマップから応答し、未確認のアドレスだけをバス上でプローブする。
+ * 無効化された範囲は次のスキャンで再びプローブされる。
+ * プローブ中に無効化されたアドレスは、そのスキャンの結果をキャッシュに反映しない
+ * （他のアドレスの結果は反映する）
+ */
+class I2CPresenceCache {
+public:
+    /**
+     * @brief 範囲内のデバイスをスキャン
+     *
+     * プローブはロックを保持せずに行うため、プローブ中も他のスレッドから無効化できる
+     *
+     * @param transport 未確認のアドレスのプローブに使うトランスポート
+     * @param first 先頭アドレス
+     * @param last 末尾アドレス（範囲に含む）
+     * @return std::vector<I2CAddress> 応答したアドレスのリスト（昇順）
+     */
+    std::vector<I2CAddress> scan(II2CTransport& transport, I2CAddress first, I2CAddress last);
+
+    /**
+     * @brief 範囲の確認結果を破棄
+     *
+     * @param first 先頭アドレス
+     * @param last 末尾アドレス（範囲に含む）
+     */
+    void invalidate(I2CAddress first, I2CAddress last);
+
+    /**
+     * @brief 確認済みのアドレスを取得
+     *
+     * @return I2CAddressBitmap 確認済みのアドレス
+     */
+    I2CAddressBitmap getKnown() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return known_;
+    }
+
+    /**
+     * @brief 応答したアドレスを取得（確認済みのアドレスのみ）
+     *
+     * @return I2CAddressBitmap 応答したアドレス
+     */
+    I2CAddressBitmap getPresent() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return present_;
+    }
+
+    /**
+     * @brief 統計情報を取得
+     *
+     * @return I2CPresenceStatistics 統計情報
+     */
+    I2CPresenceStatistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        statistics_ = I2CPresenceStatistics();
+    }
+
+private:
+    I2CAddressBitmap known_;    ///< 確認済みのアドレス
+    I2CAddressBitmap present_;  ///< 応答したアドレス
+    I2CAddressBitmap dirty_;    ///< 実行中のスキャンの間に無効化されたアドレス
+    int active_scans_ = 0;      ///< 実行中のスキャン数（0になったら dirty_ を消去する）
+    I2CPresenceStatistics statistics_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace flexhal
@@ -0,0 +1,113 @@
+/**
+ * @file i2c_presence.inl
+ * @brief I2Cデバイスの在否キャッシュの実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "i2c_presence.h"
+#include "gpio.h"
+#include "i2c.h"
+
+namespace flexhal {
+
+// I2CAddressBitmap実装
+
+I2CAddressBitmap I2CAddressBitmap::range(I2CAddress first, I2CAddress last)
+{
+    I2CAddressBitmap result;
+    if (last > MAX_ADDRESS) {
+        last = MAX_ADDRESS;
+    }
+    if (first > last) {
+        return result;
+    }
+
+    // 先頭と末尾のワードだけを部分的にマスクする
+    for (int word = first / 32; word <= last / 32; ++word) {
+        uint32_t bits = ~0u;
+        if (word == first / 32) {
+            bits &= ~0u << (first % 32);
+        }
+        if (word == last / 32 && last % 32 != 31) {
+            bits &= (1u << (last % 32 + 1)) - 1;
+        }
+        result.words_[word] = bits;
+    }
+    return result;
+}
+
+size_t I2CAddressBitmap::count() const
+{
+    size_t total = 0;
+    for (int i = 0; i < WORD_COUNT; ++i) {
+        for (uint32_t bits = words_[i]; bits; bits &= bits - 1) {
+            ++total;
+        }
+    }
+    return total;
+}
+
+std::vector<I2CAddress> I2CAddressBitmap::toVector() const
+{
+    std::vector<I2CAddress> addresses;
+    for (int i = 0; i < WORD_COUNT; ++i) {
+        for (uint32_t bits = words_[i]; bits; bits &= bits - 1) {
+            addresses.push_back(static_cast<I2CAddress>(i * 32 + lowestBitIndex(bits)));
+        }
+    }
+    return addresses;
+}
+
+// I2CPresenceCache実装
+
+std::vector<I2CAddress> I2CPresenceCache::scan(II2CTransport& transport, I2CAddress first, I2CAddress last)
+{
+    I2CAddressBitmap range = I2CAddressBitmap::range(first, last);
+    I2CAddressBitmap unknown;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unknown = range & ~known_;
+        ++active_scans_;
+        statistics_.cached += (range & known_).count();
+    }
+
+    // 未確認のアドレスだけをバス上でプローブする
+    std::vector<I2CAddress> candidates = unknown.toVector();
+    I2CAddressBitmap found;
+    for (I2CAddress address : candidates) {
+        if (transport.probe(address)) {
+            found.set(address);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.probes += candidates.size();
+
+    // プローブ中に無効化されたアドレスの結果は古い可能性があるため、キャッシュに反映しない
+    I2CAddressBitmap fresh = unknown & ~dirty_;
+    known_                 = known_ | fresh;
+    present_               = (present_ & ~fresh) | (found & fresh);
+    if (--active_scans_ == 0) {
+        dirty_ = I2CAddressBitmap();
+    }
+    return (((present_ & known_ & ~unknown) | found) & range).toVector();
+}
+
+void I2CPresenceCache::invalidate(I2CAddress first, I2CAddress last)
+{
+    I2CAddressBitmap keep = ~I2CAddressBitmap::range(first, last);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    known_   = known_ & keep;
+    present_ = present_ & keep;
+    if (active_scans_ > 0) {
+        dirty_ = dirty_ | ~keep;
+    }
+    ++statistics_.invalidations;
+}
+
+}  // namespace flexhal
@@ -0,0 +1,221 @@
+/**
+ * @file i2c_register_cache.h
+ * @brief I2Cデバイスのレジスタキャッシュ
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "i2c.h"
+
+namespace flexhal {
+
+/**
+ * @brief レジスタの種類
+ */
+enum class I2CRegisterKind : uint8_t {
+    Volatile,   ///< デバイス側で変化する（ステータス、測定値など）。毎回バスから読み込む。未宣言のレジスタの既定
+    Cacheable,  ///< デバイス側で変化しない（設定レジスタなど）。一度読み込んだ後はキャッシュから応答する
+    WriteOnly,  ///< 読み込めない。最後に書き込んだ値をキャッシュから応答する
+};
+
+/**
+ * @brief レジスタキャッシュの統計情報
+ */
+struct I2CRegisterCacheStatistics {
+    uint64_t hits           = 0;  ///< キャッシュから応答したレジスタ数
+    uint64_t misses         = 0;  ///< バスから読み込んだレジスタ数
+    uint64_t bus_reads      = 0;  ///< 発行した読み込みトランザクション数
+    uint64_t bus_writes     = 0;  ///< 発行した書き込みトランザクション数
+    uint64_t skipped_writes = 0;  ///< 値が変わらないため省略した updateBits() の書き込み数
+};
+
+/**
+ * @brief I2Cデバイスのレジスタキャッシュ
+ *
+ * 8ビットのレジスタアドレスを送ってから読み書きし、連続したレジスタはアドレスの自動インクリメントで
+ * 1回のトランザクションにまとめるデバイスを対象とする。
+ * キャッシュ可能なレジスタの読み込みはRAMから応答し、書き込みはデバイスへ書き込んだ後にキャッシュを
+ * 更新する（ライトスルー）。キャッシュ済みのレジスタの一部のビットの変更は、読み込みを省いて
+ * 1回の書き込みで行う。デバイスをリセットした場合は invalidate() でキャッシュを破棄すること
+ */
+class I2CRegisterCache {
+public:
+    /**
+     * @brief レジスタ数
+     */
+    static constexpr size_t REGISTER_COUNT = 256;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param transport デバイスのアドレスを設定したI2Cトランスポート
+     */
+    explicit I2CRegisterCache(std::shared_ptr<II2CTransport> transport);
+
+    I2CRegisterCache(const I2CRegisterCache&)            = delete;
+    I2CRegisterCache& operator=(const I2CRegisterCache&) = delete;
+
+    /**
+     * @brief レジスタの種類を宣言（キャッシュ済みの値は破棄する）
+     *
+     * @param first 先頭のレジスタアドレス
+     * @param last 末尾のレジスタアドレス（範囲に含む）
+     * @param kind レジスタの種類
+     */
+    void declare(uint8_t first, uint8_t last, I2CRegisterKind kind);
+
+    /**
+     * @brief レジスタの種類を宣言（キャッシュ済みの値は破棄する）
+     *
+     * @param address レジスタアドレス
+     * @param kind レジスタの種類
+     */
+    void declare(uint8_t address, I2CRegisterKind kind)
+    {
+        declare(address, address, kind);
+    }
+
+    /**
+     * @brief レジスタの値をバスを使わずに設定（書き込み専用レジスタのリセット値など）
+     *
+     * 揮発性のレジスタには効果がない
+     *
+     * @param address レジスタアドレス
+     * @param value 値
+     */
+    void preload(uint8_t address, uint8_t value);
+
+    /**
+     * @brief レジスタを読み込み
+     *
+     * @param address レジスタアドレス
+     * @param value 読み込んだ値の格納先
+     * @return true 成功
+     * @return false 転送エラー、または値が不明な書き込み専用レジスタ
+     */
+    bool readRegister(uint8_t address, uint8_t& value)
+    {
+        return readRegisters(address, &value, 1);
+    }
+
+    /**
+     * @brief 連続したレジスタを読み込み
+     *
+     * キャッシュにないレジスタを含む最小の範囲だけを1回のトランザクションでバスから読み込み、
+     * 残りはキャッシュから応答する。書き込み専用レジスタはバスから読み込まないため、
+     * 範囲はその前後で分割する
+     *
+     * @param address 先頭のレジスタアドレス
+     * @param data 読み込み先バッファ
+     * @param length レジスタ数（先頭アドレスから REGISTER_COUNT を越えないこと）
+     * @return true 成功
+     * @return false 転送エラー、範囲外、または値が不明な書き込み専用レジスタを含む
+     */
+    bool readRegisters(uint8_t address, uint8_t* data, size_t length);
+
+    /**
+     * @brief レジスタに書き込み
+     *
+     * @param address レジスタアドレス
+     * @param value 値
+     * @return true 成功
+     * @return false 転送エラー
+     */
+    bool writeRegister(uint8_t address, uint8_t value)
+    {
+        return writeRegisters(address, &value, 1);
+    }
+
+    /**
+     * @brief 連続したレジスタに1回のトランザクションで書き込み
+     *
+     * 失敗した場合は、範囲内のキャッシュ済みの値を破棄する
+     *
+     * @param address 先頭のレジスタアドレス
+     * @param data 書き込むデータ
+     * @param length レジスタ数（先頭アドレスから REGISTER_COUNT を越えないこと）
+     * @return true 成功
+     * @return false 転送エラーまたは範囲外
+     */
+    bool writeRegisters(uint8_t address, const uint8_t* data, size_t length);
+
+    /**
+     * @brief レジスタの一部のビットを変更（リード・モディファイ・ライト）
+     *
+     * キャッシュ済みのレジスタは読み込みを行わず、値が変わらない場合は書き込みも省略する
+     *
+     * @param address レジスタアドレス
+     * @param mask 変更するビット
+     * @param value 設定する値（mask のビットのみ使用）
+     * @return true 成功
+     * @return false 転送エラー、または値が不明な書き込み専用レジスタ
+     */
+    bool updateBits(uint8_t address, uint8_t mask, uint8_t value);
+
+    /**
+     * @brief キャッシュ済みの値をすべて破棄（デバイスのリセット後など）
+     */
+    void invalidate();
+
+    /**
+     * @brief レジスタのキャッシュ済みの値を破棄
+     *
+     * @param address レジスタアドレス
+     */
+    void invalidate(uint8_t address);
+
+    /**
+     * @brief 統計情報を取得
+     *
+     * @return I2CRegisterCacheStatistics 統計情報
+     */
+    I2CRegisterCacheStatistics getStatistics() const;
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics();
+
+private:
+    /**
+     * @brief 連続したレジスタを1回のトランザクションで読み込み（ロック取得済みで呼び出す）
+     *
+     * @param address 先頭のレジスタアドレス
+     * @param data 読み込み先バッファ
+     * @param length レジスタ数
+     * @return true 成功
+     * @return false 転送エラー
+     */
+    bool readFromBus(uint8_t address, uint8_t* data, size_t length);
+
+    /**
+     * @brief 連続したレジスタに1回のトランザクションで書き込み（ロック取得済みで呼び出す）
+     *
+     * @param address 先頭のレジスタアドレス
+     * @param data 書き込むデータ
+     * @param length レジスタ数
+     * @return true 成功
+     * @return false 転送エラー
+     */
+    bool writeToBus(uint8_t address, const uint8_t* data, size_t length);
+
+    std::shared_ptr<II2CTransport> transport_;
+    uint8_t values_[REGISTER_COUNT] = {};
+    std::bitset<REGISTER_COUNT> retained_;    ///< 値を保持するレジスタ（キャッシュ可能または書き込み専用）
+    std::bitset<REGISTER_COUNT> write_only_;  ///< 書き込み専用レジスタ
+    std::bitset<REGISTER_COUNT> valid_;       ///< 値がキャッシュ済みのレジスタ
+    I2CRegisterCacheStatistics statistics_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace flexhal
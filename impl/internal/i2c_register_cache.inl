@@ -0,0 +1,189 @@
+/**
+ * @file i2c_register_cache.inl
+ * @brief I2Cデバイスのレジスタキャッシュの実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "i2c_register_cache.h"
+#include <algorithm>
+
+namespace flexhal {
+
+// I2CRegisterCache実装
+
+I2CRegisterCache::I2CRegisterCache(std::shared_ptr<II2CTransport> transport) : transport_(std::move(transport))
+{
+}
+
+void I2CRegisterCache::declare(uint8_t first, uint8_t last, I2CRegisterKind kind)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t address = first; address <= last; ++address) {
+        retained_[address]   = kind != I2CRegisterKind::Volatile;
+        write_only_[address] = kind == I2CRegisterKind::WriteOnly;
+        valid_[address]      = false;
+    }
+}
+
+void I2CRegisterCache::preload(uint8_t address, uint8_t value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (retained_[address]) {
+        values_[address] = value;
+        valid_[address]  = true;
+    }
+}
+
+bool I2CRegisterCache::readRegisters(uint8_t address, uint8_t* data, size_t length)
+{
+    if (!data || address + length > REGISTER_COUNT) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 値が不明な書き込み専用レジスタを含む場合は、バスを使う前に失敗する
+    size_t end = address + length;
+    for (size_t i = address; i < end; ++i) {
+        if (write_only_[i] && !valid_[i]) {
+            return false;
+        }
+    }
+
+    size_t i = address;
+    while (i < end) {
+        if (valid_[i]) {
+            data[i - address] = values_[i];
+            ++statistics_.hits;
+            ++i;
+            continue;
+        }
+
+        // 書き込み専用レジスタの手前までで、キャッシュにないレジスタを含む最小の範囲をバスから読み込む
+        size_t first = i;
+        size_t last  = i;
+        for (size_t j = i + 1; j < end && !write_only_[j]; ++j) {
+            if (!valid_[j]) {
+                last = j;
+            }
+        }
+
+        size_t count = last - first + 1;
+        if (!readFromBus(static_cast<uint8_t>(first), data + (first - address), count)) {
+            return false;
+        }
+        statistics_.misses += count;
+
+        for (size_t k = first; k <= last; ++k) {
+            if (retained_[k] && !valid_[k]) {
+                values_[k] = data[k - address];
+                valid_[k]  = true;
+            }
+        }
+        i = last + 1;
+    }
+    return true;
+}
+
+bool I2CRegisterCache::writeRegisters(uint8_t address, const uint8_t* data, size_t length)
+{
+    if ((!data && length > 0) || address + length > REGISTER_COUNT) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool written = writeToBus(address, data, length);
+    for (size_t i = address; i < address + length; ++i) {
+        if (written && retained_[i]) {
+            values_[i] = data[i - address];
+            valid_[i]  = true;
+        } else {
+            // 途中でNACKされた場合はデバイス上の値が不明になる
+            valid_[i] = false;
+        }
+    }
+    return written;
+}
+
+bool I2CRegisterCache::updateBits(uint8_t address, uint8_t mask, uint8_t value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint8_t current = 0;
+    if (valid_[address]) {
+        current = values_[address];
+        ++statistics_.hits;
+    } else {
+        if (write_only_[address] || !readFromBus(address, &current, 1)) {
+            return false;
+        }
+        ++statistics_.misses;
+    }
+
+    uint8_t updated = static_cast<uint8_t>((current & ~mask) | (value & mask));
+
+    // 揮発性のレジスタは書き込み自体に意味がある場合があるため、値が同じでも省略しない
+    if (updated == current && retained_[address]) {
+        values_[address] = current;
+        valid_[address]  = true;
+        ++statistics_.skipped_writes;
+        return true;
+    }
+
+    bool written = writeToBus(address, &updated, 1);
+    if (retained_[address]) {
+        values_[address] = updated;
+        valid_[address]  = written;
+    }
+    return written;
+}
+
+void I2CRegisterCache::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    valid_.reset();
+}
+
+void I2CRegisterCache::invalidate(uint8_t address)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    valid_[address] = false;
+}
+
+I2CRegisterCacheStatistics I2CRegisterCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void I2CRegisterCache::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_ = I2CRegisterCacheStatistics();
+}
+
+bool I2CRegisterCache::readFromBus(uint8_t address, uint8_t* data, size_t length)
+{
+    // レジスタアドレスを書き込んだ後、リピーテッドスタートで読み込む
+    ++statistics_.bus_reads;
+    return transport_->writeRead(&address, 1, data, length) == static_cast<ssize_t>(length);
+}
+
+bool I2CRegisterCache::writeToBus(uint8_t address, const uint8_t* data, size_t length)
+{
+    // レジスタアドレスとデータを結合せずに1回のトランザクションで送る
+    TransferSegment segments[2];
+    segments[0].tx_data = &address;
+    segments[0].length  = 1;
+    segments[1].tx_data = data;
+    segments[1].length  = length;
+
+    ++statistics_.bus_writes;
+    return transport_->writev(segments, length > 0 ? 2 : 1) == static_cast<ssize_t>(length + 1);
+}
+
+}  // namespace flexhal
@@ -0,0 +1,29 @@
+/**
+ * @file impl_includes.h
+ * @brief FlexHAL - プラットフォーム共通の実装ファイルのインクルード
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+// プラットフォームに依存しない共通実装ファイルをインクルード
+#include "async_transfer.inl"
+#include "gpio.inl"
+#include "soft_pwm.inl"
+#include "debounce.inl"
+#include "bit_reverse.inl"
+#include "software_spi.inl"
+#include "spi.inl"
+#include "spi_arbiter.inl"
+#include "spi_flash.inl"
+#include "command_stream.inl"
+#include "pixel_format.inl"
+#include "display.inl"
+#include "i2c_presence.inl"
+#include "software_i2c.inl"
+#include "i2c.inl"
+#include "i2c_register_cache.inl"
@@ -0,0 +1,124 @@
+/**
+ * @file lockfree_queue.h
+ * @brief 固定長ロックフリーキュー
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace flexhal {
+
+/**
+ * @brief 固定長のロックフリーキュー（複数プロデューサ・複数コンシューマ対応）
+ *
+ * 各スロットにシーケンス番号を持たせる方式のリングバッファ。
+ * メモリはすべて構築時に確保され、push/popでヒープ確保もロックも行わない。
+ *
+ * @tparam T 要素の型（コピー可能であること）
+ * @tparam Capacity 容量（2のべき乗）
+ */
+template <typename T, size_t Capacity>
+class LockFreeQueue {
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    /**
+     * @brief コンストラクタ
+     */
+    LockFreeQueue()
+    {
+        for (size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue&)            = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    /**
+     * @brief 要素を追加
+     *
+     * @param value 追加する要素
+     * @return true 追加成功
+     * @return false キューが満杯
+     */
+    bool push(const T& value)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot    = slots_[pos & (Capacity - 1)];
+            size_t seq    = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 満杯
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief 要素を取り出す
+     *
+     * @param value 取り出した要素の格納先
+     * @return true 取り出し成功
+     * @return false キューが空
+     */
+    bool pop(T& value)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot    = slots_[pos & (Capacity - 1)];
+            size_t seq    = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = slot.value;
+                    slot.sequence.store(pos + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 空
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief キューが空か確認（目安）
+     *
+     * @return true 空
+     * @return false 要素あり
+     */
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    Slot slots_[Capacity];
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace flexhal
@@ -0,0 +1,94 @@
+/**
+ * @file pixel_format.h
+ * @brief ディスプレイ転送用のピクセルフォーマット変換の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "simd_detect.h"
+
+namespace flexhal {
+
+/**
+ * @brief ピクセルフォーマット変換
+ *
+ * ISPITransport::write() の前にドライバが行う変換をまとめたもの。出力はパネルへの送信順
+ * （RGB565は上位バイトが先）のバイト列で、そのまま転送できる。
+ * 入力と出力の領域は重ならないこと
+ */
+namespace pixel {
+
+/**
+ * @brief 使用しているSIMD実装の名前を取得
+ *
+ * @return const char* "AVX2"、"SSSE3"、"SSE2"、"NEON"、"scalar" のいずれか
+ */
+const char* getBackendName();
+
+/**
+ * @brief RGB565（ネイティブエンディアン）を送信順に並べ替え
+ *
+ * @param src 入力画素
+ * @param dst 出力（2バイト/画素）
+ * @param count 画素数
+ */
+void swapRGB565(const uint16_t* src, uint8_t* dst, size_t count);
+
+/**
+ * @brief RGB888（R・G・Bの順の3バイト）をRGB565に変換
+ *
+ * @param src 入力（3バイト/画素）
+ * @param dst 出力（2バイト/画素）
+ * @param count 画素数
+ */
+void convertRGB888ToRGB565(const uint8_t* src, uint8_t* dst, size_t count);
+
+/**
+ * @brief ARGB8888（0xAARRGGBB）をRGB565に変換（アルファは無視）
+ *
+ * @param src 入力画素
+ * @param dst 出力（2バイト/画素）
+ * @param count 画素数
+ */
+void convertARGB8888ToRGB565(const uint32_t* src, uint8_t* dst, size_t count);
+
+/**
+ * @brief RGB565（ネイティブエンディアン）をRGB666に変換
+ *
+ * 各色を上位6ビットに詰めた3バイト（R・G・Bの順）で出力する。5ビットの赤・青は
+ * 上位ビットを下位に複製して6ビットに拡張する
+ *
+ * @param src 入力画素
+ * @param dst 出力（3バイト/画素）
+ * @param count 画素数
+ */
+void convertRGB565ToRGB666(const uint16_t* src, uint8_t* dst, size_t count);
+
+/**
+ * @brief 8ビットグレースケールをRGB565に変換
+ *
+ * @param src 入力（1バイト/画素）
+ * @param dst 出力（2バイト/画素）
+ * @param count 画素数
+ */
+void convertGray8ToRGB565(const uint8_t* src, uint8_t* dst, size_t count);
+
+/**
+ * @brief 8ビットインデックスカラーをパレットでRGB565に変換
+ *
+ * @param src 入力（1バイト/画素）
+ * @param dst 出力（2バイト/画素）
+ * @param count 画素数
+ * @param palette パレット（RGB565、ネイティブエンディアン、256要素）
+ */
+void convertIndexed8ToRGB565(const uint8_t* src, uint8_t* dst, size_t count, const uint16_t* palette);
+
+}  // namespace pixel
+}  // namespace flexhal
@@ -0,0 +1,332 @@
+/**
+ * @file pixel_format.inl
+ * @brief ディスプレイ転送用のピクセルフォーマット変換の実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "pixel_format.h"
+
+#if defined(FLEXHAL_SIMD_AVX2)
+#include <immintrin.h>
+#endif
+#if defined(FLEXHAL_SIMD_SSSE3)
+#include <tmmintrin.h>
+#endif
+#if defined(FLEXHAL_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(FLEXHAL_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace flexhal {
+namespace pixel {
+
+// スカラー実装の共通処理
+
+static inline void storeRGB565(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b)
+{
+    dst[0] = static_cast<uint8_t>((r & 0xF8) | (g >> 5));
+    dst[1] = static_cast<uint8_t>(((g << 3) & 0xE0) | (b >> 3));
+}
+
+static inline void storeRGB666(uint8_t* dst, uint16_t color)
+{
+    uint8_t r5 = static_cast<uint8_t>(color >> 11);
+    uint8_t b5 = static_cast<uint8_t>(color & 0x1F);
+    dst[0]     = static_cast<uint8_t>(((r5 << 3) | (r5 >> 2)) & 0xFC);
+    dst[1]     = static_cast<uint8_t>((color >> 3) & 0xFC);
+    dst[2]     = static_cast<uint8_t>(((b5 << 3) | (b5 >> 2)) & 0xFC);
+}
+
+#if defined(FLEXHAL_SIMD_SSE2)
+/**
+ * @brief 0x00RRGGBB の32ビットレーンを送信順のRGB565（下位16ビット）に変換
+ */
+static inline __m128i packRGB565x4(__m128i p)
+{
+    __m128i r = _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0xF800));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x001F));
+    __m128i v = _mm_or_si128(_mm_or_si128(r, g), b);
+    v         = _mm_or_si128(_mm_srli_epi32(v, 8), _mm_and_si128(_mm_slli_epi32(v, 8), _mm_set1_epi32(0xFF00)));
+    // packs_epi32 は符号付き飽和なので、16ビット値を符号拡張しておく
+    return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+}
+
+/**
+ * @brief 16画素分のグレースケールを送信順のRGB565に変換して格納
+ */
+static inline void storeGray8x16(uint8_t* dst, __m128i g)
+{
+    __m128i hi = _mm_or_si128(_mm_and_si128(g, _mm_set1_epi8(static_cast<char>(0xF8))),
+                              _mm_and_si128(_mm_srli_epi16(g, 5), _mm_set1_epi8(0x07)));
+    __m128i lo = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(g, 3), _mm_set1_epi8(static_cast<char>(0xE0))),
+                              _mm_and_si128(_mm_srli_epi16(g, 3), _mm_set1_epi8(0x1F)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(hi, lo));
+}
+#endif
+
+#if defined(FLEXHAL_SIMD_AVX2)
+/**
+ * @brief packRGB565x4 の256ビット版
+ */
+static inline __m256i packRGB565x8(__m256i p)
+{
+    __m256i r = _mm256_and_si256(_mm256_srli_epi32(p, 8), _mm256_set1_epi32(0xF800));
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07E0));
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 3), _mm256_set1_epi32(0x001F));
+    __m256i v = _mm256_or_si256(_mm256_or_si256(r, g), b);
+    v = _mm256_or_si256(_mm256_srli_epi32(v, 8), _mm256_and_si256(_mm256_slli_epi32(v, 8), _mm256_set1_epi32(0xFF00)));
+    return _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+}
+#endif
+
+#if defined(FLEXHAL_SIMD_NEON)
+/**
+ * @brief 16画素分のR・G・Bを送信順のRGB565に変換して格納
+ */
+static inline void storeRGB565x16(uint8_t* dst, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+    uint8x16x2_t out;
+    out.val[0] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)), vshrq_n_u8(g, 5));
+    out.val[1] = vorrq_u8(vandq_u8(vshlq_n_u8(g, 3), vdupq_n_u8(0xE0)), vshrq_n_u8(b, 3));
+    vst2q_u8(dst, out);
+}
+#endif
+
+const char* getBackendName()
+{
+#if defined(FLEXHAL_SIMD_AVX2)
+    return "AVX2";
+#elif defined(FLEXHAL_SIMD_SSSE3)
+    return "SSSE3";
+#elif defined(FLEXHAL_SIMD_SSE2)
+    return "SSE2";
+#elif defined(FLEXHAL_SIMD_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void swapRGB565(const uint16_t* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(FLEXHAL_SIMD_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        v         = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), v);
+    }
+#endif
+#if defined(FLEXHAL_SIMD_SSE2)
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        v         = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), v);
+    }
+#endif
+#if defined(FLEXHAL_SIMD_NEON)
+    for (; i + 8 <= count; i += 8) {
+        uint8x16_t v = vreinterpretq_u8_u16(vld1q_u16(src + i));
+        vst1q_u8(dst + i * 2, vrev16q_u8(v));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i * 2]     = static_cast<uint8_t>(src[i] >> 8);
+        dst[i * 2 + 1] = static_cast<uint8_t>(src[i]);
+    }
+}
+
+void convertRGB888ToRGB565(const uint8_t* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(FLEXHAL_SIMD_SSSE3)
+    // 8画素（24バイト）を先頭16バイトと8バイト目からの16バイトの2回で読み込み、0x00RRGGBBに展開する
+    const __m128i expand_lo = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i expand_hi = _mm_setr_epi8(6, 5, 4, -1, 9, 8, 7, -1, 12, 11, 10, -1, 15, 14, 13, -1);
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* p = src + i * 3;
+        __m128i lo       = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), expand_lo);
+        __m128i hi       = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8)), expand_hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2),
+                         _mm_packs_epi32(packRGB565x4(lo), packRGB565x4(hi)));
+    }
+#endif
+#if defined(FLEXHAL_SIMD_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+        storeRGB565x16(dst + i * 2, rgb.val[0], rgb.val[1], rgb.val[2]);
+    }
+#endif
+    for (; i < count; ++i) {
+        storeRGB565(dst + i * 2, src[i * 3], src[i * 3 + 1], src[i * 3 + 2]);
+    }
+}
+
+void convertARGB8888ToRGB565(const uint32_t* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(FLEXHAL_SIMD_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = packRGB565x8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+        __m256i b = packRGB565x8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8)));
+        // packs_epi32 は128ビットレーンごとに結合するので、64ビット単位で並べ直す
+        __m256i v = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), v);
+    }
+#endif
+#if defined(FLEXHAL_SIMD_SSE2)
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = packRGB565x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        __m128i b = packRGB565x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_packs_epi32(a, b));
+    }
+#endif
+#if defined(FLEXHAL_SIMD_NEON)
+    for (; i + 16 <= count; i += 16) {
+        // リトルエンディアンでは B・G・R・A の順に並んでいる
+        uint8x16x4_t bgra = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        storeRGB565x16(dst + i * 2, bgra.val[2], bgra.val[1], bgra.val[0]);
+    }
+#endif
+    for (; i < count; ++i) {
+        uint32_t c = src[i];
+        storeRGB565(dst + i * 2, static_cast<uint8_t>(c >> 16), static_cast<uint8_t>(c >> 8),
+                    static_cast<uint8_t>(c));
+    }
+}
+
+void convertRGB565ToRGB666(const uint16_t* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(FLEXHAL_SIMD_SSSE3)
+    const __m128i mask_fc = _mm_set1_epi8(static_cast<char>(0xFC));
+    const __m128i mask_f8 = _mm_set1_epi8(static_cast<char>(0xF8));
+    const __m128i mask_e0 = _mm_set1_epi8(static_cast<char>(0xE0));
+    const __m128i mask_1c = _mm_set1_epi8(0x1C);
+    const __m128i mask_07 = _mm_set1_epi8(0x07);
+    const __m128i mask_ff = _mm_set1_epi16(0x00FF);
+
+    // 16画素分のR・G・Bの各バイトを48バイトに並べる並べ替え表
+    const __m128i r0 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+    const __m128i g0 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+    const __m128i b0 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+    const __m128i r1 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+    const __m128i g1 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+    const __m128i b1 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+    const __m128i r2 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+    const __m128i g2 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+    const __m128i b2 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        __m128i l = _mm_packus_epi16(_mm_and_si128(a, mask_ff), _mm_and_si128(b, mask_ff));
+        __m128i h = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+
+        // 8ビット単位のシフトは16ビットシフトと不要ビットのマスクで代用する
+        __m128i h5    = _mm_and_si128(h, mask_f8);
+        __m128i l3    = _mm_and_si128(_mm_slli_epi16(l, 3), mask_f8);
+        __m128i red   = _mm_and_si128(_mm_or_si128(h5, _mm_and_si128(_mm_srli_epi16(h5, 5), mask_07)), mask_fc);
+        __m128i green = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(h, 5), mask_e0),
+                                     _mm_and_si128(_mm_srli_epi16(l, 3), mask_1c));
+        __m128i blue  = _mm_and_si128(_mm_or_si128(l3, _mm_and_si128(_mm_srli_epi16(l3, 5), mask_07)), mask_fc);
+
+        uint8_t* p = dst + i * 3;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                         _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(red, r0), _mm_shuffle_epi8(green, g0)),
+                                      _mm_shuffle_epi8(blue, b0)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16),
+                         _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(red, r1), _mm_shuffle_epi8(green, g1)),
+                                      _mm_shuffle_epi8(blue, b1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 32),
+                         _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(red, r2), _mm_shuffle_epi8(green, g2)),
+                                      _mm_shuffle_epi8(blue, b2)));
+    }
+#endif
+#if defined(FLEXHAL_SIMD_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x2_t lh = vld2q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        uint8x16_t l    = lh.val[0];
+        uint8x16_t h    = lh.val[1];
+        uint8x16_t l3   = vshlq_n_u8(l, 3);
+        uint8x16x3_t out;
+        out.val[0] = vandq_u8(vorrq_u8(vandq_u8(h, vdupq_n_u8(0xF8)), vshrq_n_u8(h, 5)), vdupq_n_u8(0xFC));
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(h, 5), vshrq_n_u8(l, 3)), vdupq_n_u8(0xFC));
+        out.val[2] = vandq_u8(vorrq_u8(l3, vshrq_n_u8(l3, 5)), vdupq_n_u8(0xFC));
+        vst3q_u8(dst + i * 3, out);
+    }
+#endif
+    for (; i < count; ++i) {
+        storeRGB666(dst + i * 3, src[i]);
+    }
+}
+
+void convertGray8ToRGB565(const uint8_t* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(FLEXHAL_SIMD_AVX2)
+    const __m256i mask_f8 = _mm256_set1_epi8(static_cast<char>(0xF8));
+    const __m256i mask_e0 = _mm256_set1_epi8(static_cast<char>(0xE0));
+    const __m256i mask_07 = _mm256_set1_epi8(0x07);
+    const __m256i mask_1f = _mm256_set1_epi8(0x1F);
+    for (; i + 32 <= count; i += 32) {
+        // unpack は128ビットレーンごとに行われるので、先に64ビット単位で並べ直しておく
+        __m256i g  = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), 0xD8);
+        __m256i hi = _mm256_or_si256(_mm256_and_si256(g, mask_f8), _mm256_and_si256(_mm256_srli_epi16(g, 5), mask_07));
+        __m256i lo = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(g, 3), mask_e0),
+                                     _mm256_and_si256(_mm256_srli_epi16(g, 3), mask_1f));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), _mm256_unpacklo_epi8(hi, lo));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2 + 32), _mm256_unpackhi_epi8(hi, lo));
+    }
+#endif
+#if defined(FLEXHAL_SIMD_SSE2)
+    for (; i + 16 <= count; i += 16) {
+        storeGray8x16(dst + i * 2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    }
+#endif
+#if defined(FLEXHAL_SIMD_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t g = vld1q_u8(src + i);
+        storeRGB565x16(dst + i * 2, g, g, g);
+    }
+#endif
+    for (; i < count; ++i) {
+        storeRGB565(dst + i * 2, src[i], src[i], src[i]);
+    }
+}
+
+void convertIndexed8ToRGB565(const uint8_t* src, uint8_t* dst, size_t count, const uint16_t* palette)
+{
+    // 表引きはギャザーになりベクトル化の効果が小さいため、4画素ずつ展開するにとどめる
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint16_t c0 = palette[src[i]];
+        uint16_t c1 = palette[src[i + 1]];
+        uint16_t c2 = palette[src[i + 2]];
+        uint16_t c3 = palette[src[i + 3]];
+        uint8_t* p  = dst + i * 2;
+        p[0]        = static_cast<uint8_t>(c0 >> 8);
+        p[1]        = static_cast<uint8_t>(c0);
+        p[2]        = static_cast<uint8_t>(c1 >> 8);
+        p[3]        = static_cast<uint8_t>(c1);
+        p[4]        = static_cast<uint8_t>(c2 >> 8);
+        p[5]        = static_cast<uint8_t>(c2);
+        p[6]        = static_cast<uint8_t>(c3 >> 8);
+        p[7]        = static_cast<uint8_t>(c3);
+    }
+    for (; i < count; ++i) {
+        dst[i * 2]     = static_cast<uint8_t>(palette[src[i]] >> 8);
+        dst[i * 2 + 1] = static_cast<uint8_t>(palette[src[i]]);
+    }
+}
+
+}  // namespace pixel
+}  // namespace flexhal
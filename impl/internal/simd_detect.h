@@ -0,0 +1,32 @@
+/**
+ * @file simd_detect.h
+ * @brief 使用可能なSIMD命令セットの検出（コンパイル時）
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+//=============================================================================
+// SIMD命令セット検出
+//
+// FLEXHAL_NO_SIMD を定義するとすべてスカラー実装になる
+//=============================================================================
+
+#if !defined(FLEXHAL_NO_SIMD)
+#if defined(__AVX2__)
+#define FLEXHAL_SIMD_AVX2
+#endif
+#if defined(__SSSE3__)
+#define FLEXHAL_SIMD_SSSE3
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLEXHAL_SIMD_SSE2
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FLEXHAL_SIMD_NEON
+#endif
+#endif
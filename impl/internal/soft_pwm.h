@@ -0,0 +1,236 @@
+/**
+ * @file soft_pwm.h
+ * @brief ソフトウェアPWM（多チャンネル・サーボ対応）の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "gpio.h"
+#include "task.h"
+
+namespace flexhal {
+
+/**
+ * @brief ソフトウェアPWMエンジン
+ *
+ * 1つのタイマータスク（createTask()）で任意の数のピンにPWM信号を出力する。
+ * 周期の先頭で全チャンネルのエッジ予定を時刻順に並べ、同時刻・同一バンクのエッジを
+ * まとめて1回の setLevels で出力するため、チャンネル数が増えてもピン操作の回数は
+ * 異なるエッジ時刻の数に比例する。
+ *
+ * デューティの変更は次の周期の先頭で反映される。チャンネル表は登録できる最大数（ポートのピン数）を
+ * 最初に確保して再確保しないため、デューティの変更とタイマータスクの出力はロックを取得しない。
+ * エッジ予定はチャンネルの設定が変わった後の周期でのみ作り直し、変わらない間は前回の予定を再利用する。
+ *
+ * 待機は flexhal::sleep() がミリ秒単位のため、エッジの直前の短い区間だけ micros() を見ながら
+ * flexhal::yield() でビジーウェイトする。
+ */
+class SoftPWM {
+public:
+    /**
+     * @brief デューティの最大値（100%）
+     */
+    static constexpr uint16_t DUTY_MAX = 0xFFFF;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port 出力先のGPIOポート
+     * @param period_us PWM周期（マイクロ秒、デフォルトはサーボ用の20ms）
+     */
+    explicit SoftPWM(std::shared_ptr<IGPIOPort> port, uint32_t period_us = 20000);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~SoftPWM();
+
+    SoftPWM(const SoftPWM&)            = delete;
+    SoftPWM& operator=(const SoftPWM&) = delete;
+
+    /**
+     * @brief ピンをチャンネルとして登録
+     *
+     * ピンは出力モード・Lowに設定される。失敗した場合はピンを変更しない
+     *
+     * @param pin_number ピン番号
+     * @param duty 初期デューティ（0〜DUTY_MAX）
+     * @return int チャンネル番号（ピンが無効、登録済み、または空きチャンネルがない場合は-1）
+     */
+    int attach(int pin_number, uint16_t duty = 0);
+
+    /**
+     * @brief ピンをチャンネルとして登録
+     *
+     * @param pin 出力するピン（このエンジンのポートに属すること）
+     * @param duty 初期デューティ（0〜DUTY_MAX）
+     * @return int チャンネル番号（失敗時は-1）
+     */
+    int attach(std::shared_ptr<IPin> pin, uint16_t duty = 0);
+
+    /**
+     * @brief チャンネルの登録を解除
+     *
+     * ピンはLowに設定される。タイマータスクの実行中は、作成済みの周期の出力と競合しないよう
+     * タイマータスクが次の周期の先頭でLowにする
+     *
+     * @param channel チャンネル番号
+     */
+    void detach(int channel);
+
+    /**
+     * @brief デューティを設定
+     *
+     * @param channel チャンネル番号
+     * @param duty デューティ（0〜DUTY_MAX）
+     * @return true 設定成功
+     * @return false チャンネルが無効
+     */
+    bool setDuty(int channel, uint16_t duty);
+
+    /**
+     * @brief パルス幅を設定（サーボ用）
+     *
+     * @param channel チャンネル番号
+     * @param width_us Highの時間（マイクロ秒、周期を超える場合は常にHigh）
+     * @return true 設定成功
+     * @return false チャンネルが無効
+     */
+    bool setPulseWidth(int channel, uint32_t width_us);
+
+    /**
+     * @brief パルス幅を取得
+     *
+     * @param channel チャンネル番号
+     * @return uint32_t Highの時間（マイクロ秒、チャンネルが無効な場合は0）
+     */
+    uint32_t getPulseWidth(int channel) const;
+
+    /**
+     * @brief PWM周期を取得
+     *
+     * @return uint32_t 周期（マイクロ秒）
+     */
+    uint32_t getPeriod() const
+    {
+        return period_us_;
+    }
+
+    /**
+     * @brief タイマータスクを開始
+     *
+     * @return true 開始成功
+     * @return false 開始失敗
+     */
+    bool start();
+
+    /**
+     * @brief タイマータスクを停止
+     *
+     * 全チャンネルのピンはLowに設定される
+     */
+    void stop();
+
+    /**
+     * @brief タイマータスクが実行中か
+     *
+     * @return true 実行中
+     * @return false 停止中
+     */
+    bool isRunning() const
+    {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 1周期分の出力を呼び出し元のタスクで実行
+     *
+     * 外部のタイマーから駆動する場合に使用する。start()と併用しないこと
+     */
+    void runPeriod();
+
+private:
+    /**
+     * @brief チャンネル
+     */
+    struct Channel {
+        std::atomic<int> pin_number{-1};    ///< ピン番号（-1は未使用）
+        std::atomic<uint32_t> width_us{0};  ///< Highの時間（マイクロ秒）
+    };
+
+    /**
+     * @brief 立ち下がりエッジの予定
+     */
+    struct Edge {
+        uint32_t time_us;  ///< 周期先頭からの時刻（マイクロ秒）
+        int bank;          ///< バンク番号
+        uint32_t mask;     ///< 立ち下がるピン（ビットマップ）
+    };
+
+    /**
+     * @brief 1周期分を出力（チャンネルの設定が変わっていればエッジ予定を作り直す）
+     *
+     * @param period_start 周期の開始時刻（micros() の値）
+     */
+    void runPeriod(uint32_t period_start);
+
+    /**
+     * @brief 全チャンネルから周期先頭のレベルと立ち下がりエッジの予定を作成
+     */
+    void buildSchedule();
+
+    /**
+     * @brief チャンネルが登録済みか
+     *
+     * @param channel チャンネル番号
+     * @return true 登録済み
+     * @return false 範囲外または未使用
+     */
+    bool isAttached(int channel) const;
+
+    /**
+     * @brief 解除されたピンを、作成済みのエッジ予定に含まれていなければLowにする
+     */
+    void releaseDetached();
+
+    /**
+     * @brief 指定時刻まで待機
+     *
+     * 直前まではスリープし、最後の短い区間のみビジーウェイトする
+     *
+     * @param deadline 待機終了時刻（micros() の値）
+     */
+    static void waitUntil(uint32_t deadline);
+
+    /**
+     * @brief タイマータスクの処理
+     */
+    void run();
+
+    std::shared_ptr<IGPIOPort> port_;
+    uint32_t period_us_;
+    std::unique_ptr<Channel[]> channels_;                ///< ピン数分を確保し、以後再確保しない
+    size_t channel_capacity_ = 0;                        ///< channels_ の要素数
+    std::atomic<size_t> channel_count_{0};               ///< 一度でも使用したチャンネル数（走査範囲）
+    std::atomic<uint32_t> generation_{0};                ///< チャンネルの設定を変更するたびに進める
+    uint32_t schedule_generation_ = 0;                   ///< エッジ予定を作成した時点の generation_
+    std::mutex channels_mutex_;                          ///< attach()/detach()/start()/stop() 同士の排他
+    std::unique_ptr<std::atomic<uint32_t>[]> detached_;  ///< 実行中に解除され、まだLowにしていないピン（バンクごと）
+    std::vector<Edge> edges_;
+    std::vector<uint32_t> start_values_;
+    std::vector<uint32_t> start_masks_;
+    std::atomic<bool> running_{false};
+    std::shared_ptr<ITask> task_;  ///< タイマータスク（停止中はnullptr）
+};
+
+}  // namespace flexhal
@@ -0,0 +1,311 @@
+/**
+ * @file soft_pwm.inl
+ * @brief ソフトウェアPWM（多チャンネル・サーボ対応）の実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "soft_pwm.h"
+#include <algorithm>
+#include "../../src/flexhal/rtos.hpp"
+
+namespace flexhal {
+
+// SoftPWM実装
+
+SoftPWM::SoftPWM(std::shared_ptr<IGPIOPort> port, uint32_t period_us)
+    : port_(std::move(port)), period_us_(period_us > 0 ? period_us : 1)
+{
+    int bank_count    = port_ ? port_->getBankCount() : 0;
+    channel_capacity_ = static_cast<size_t>(bank_count) * GPIO_PINS_PER_BANK;
+    channels_.reset(new Channel[channel_capacity_]);
+    detached_.reset(new std::atomic<uint32_t>[bank_count]());
+    start_values_.resize(bank_count, 0);
+    start_masks_.resize(bank_count, 0);
+}
+
+SoftPWM::~SoftPWM()
+{
+    stop();
+}
+
+int SoftPWM::attach(int pin_number, uint16_t duty)
+{
+    if (!port_ || pin_number < 0 || pin_number / GPIO_PINS_PER_BANK >= static_cast<int>(start_masks_.size())) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+
+    // 同じピンを2つのチャンネルで出力しないよう、登録済みのピンは拒否する
+    size_t count   = channel_count_.load(std::memory_order_relaxed);
+    size_t channel = count;
+    for (size_t i = 0; i < count; ++i) {
+        int attached = channels_[i].pin_number.load(std::memory_order_relaxed);
+        if (attached == pin_number) {
+            return -1;
+        }
+        if (attached < 0 && channel == count) {
+            channel = i;  // 空いているチャンネルを再利用
+        }
+    }
+    if (channel == channel_capacity_) {
+        return -1;
+    }
+
+    // 登録できることを確認してからピンを変更する
+    std::shared_ptr<IPin> pin = port_->getPin(pin_number);
+    if (!pin) {
+        return -1;
+    }
+    pin->setMode(PinMode::Output);
+    pin->setLevel(PinLevel::Low);
+
+    // パルス幅を設定してからピン番号を公開し、タイマータスクが古い幅で出力しないようにする
+    channels_[channel].width_us.store(static_cast<uint32_t>(static_cast<uint64_t>(period_us_) * duty / DUTY_MAX),
+                                      std::memory_order_relaxed);
+    channels_[channel].pin_number.store(pin_number, std::memory_order_release);
+    if (channel == count) {
+        channel_count_.store(count + 1, std::memory_order_release);
+    }
+    generation_.fetch_add(1, std::memory_order_release);
+    return static_cast<int>(channel);
+}
+
+int SoftPWM::attach(std::shared_ptr<IPin> pin, uint16_t duty)
+{
+    if (!pin) {
+        return -1;
+    }
+    return attach(pin->getPinNumber(), duty);
+}
+
+void SoftPWM::detach(int channel)
+{
+    int pin_number;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        if (!isAttached(channel)) {
+            return;
+        }
+        pin_number = channels_[channel].pin_number.exchange(-1, std::memory_order_relaxed);
+
+        // タイマータスクは解除前のエッジ予定で周期の先頭を出力済みの場合があるため、
+        // 呼び出し元ではなくタイマータスクが予定を作り直す際にLowにする
+        uint32_t bit = 1u << (pin_number % GPIO_PINS_PER_BANK);
+        if (task_) {
+            detached_[pin_number / GPIO_PINS_PER_BANK].fetch_or(bit, std::memory_order_relaxed);
+        } else {
+            port_->setLevels(pin_number / GPIO_PINS_PER_BANK, 0, bit);
+        }
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+bool SoftPWM::setDuty(int channel, uint16_t duty)
+{
+    return setPulseWidth(channel, static_cast<uint32_t>(static_cast<uint64_t>(period_us_) * duty / DUTY_MAX));
+}
+
+bool SoftPWM::setPulseWidth(int channel, uint32_t width_us)
+{
+    if (!isAttached(channel)) {
+        return false;
+    }
+
+    // 値が変わった場合のみ、次の周期でエッジ予定を作り直させる
+    if (channels_[channel].width_us.exchange(width_us, std::memory_order_relaxed) != width_us) {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+    return true;
+}
+
+uint32_t SoftPWM::getPulseWidth(int channel) const
+{
+    if (!isAttached(channel)) {
+        return 0;
+    }
+    return channels_[channel].width_us.load(std::memory_order_relaxed);
+}
+
+bool SoftPWM::start()
+{
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    if (!port_ || task_) {
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    task_ = createTask("SoftPWM", [this]() { run(); }, 4096, TaskPriority::High);
+    if (!task_ || !task_->start()) {
+        task_.reset();
+        running_.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void SoftPWM::stop()
+{
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    if (!task_) {
+        return;
+    }
+
+    // タイマータスクが周期の終わりでループを抜けるまで待つ
+    running_.store(false, std::memory_order_release);
+    while (task_->isRunning()) {
+        flexhal::sleep(1);
+    }
+    task_.reset();
+
+    // 全チャンネルと、解除後にまだLowにしていないピンをLowにする
+    // （エッジ予定は再開時に再利用するため、別のマスクを使う）
+    std::vector<uint32_t> masks(start_masks_.size(), 0);
+    for (size_t bank = 0; bank < masks.size(); ++bank) {
+        masks[bank] = detached_[bank].exchange(0, std::memory_order_relaxed);
+    }
+    size_t count = channel_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        int pin_number = channels_[i].pin_number.load(std::memory_order_relaxed);
+        if (pin_number >= 0) {
+            masks[pin_number / GPIO_PINS_PER_BANK] |= 1u << (pin_number % GPIO_PINS_PER_BANK);
+        }
+    }
+    for (size_t bank = 0; bank < masks.size(); ++bank) {
+        if (masks[bank]) {
+            port_->setLevels(static_cast<int>(bank), 0, masks[bank]);
+        }
+    }
+}
+
+void SoftPWM::runPeriod()
+{
+    if (port_) {
+        runPeriod(flexhal::micros());
+    }
+}
+
+void SoftPWM::run()
+{
+    // 周期の開始時刻は前回の開始時刻から積算し、処理時間による周期のずれを防ぐ
+    uint32_t period_start = flexhal::micros();
+    while (running_.load(std::memory_order_acquire)) {
+        runPeriod(period_start);
+        period_start += period_us_;
+
+        // 大きく遅れた場合は現在時刻から再開する（micros() の桁あふれを考慮して差で比較する）
+        uint32_t now = flexhal::micros();
+        if (static_cast<int32_t>(now - period_start) > static_cast<int32_t>(period_us_)) {
+            period_start = now;
+        }
+    }
+}
+
+void SoftPWM::runPeriod(uint32_t period_start)
+{
+    // 前回の周期からチャンネルの設定が変わっていなければ、エッジ予定をそのまま使う
+    uint32_t generation = generation_.load(std::memory_order_acquire);
+    if (generation != schedule_generation_) {
+        schedule_generation_ = generation;
+        buildSchedule();
+        releaseDetached();
+    }
+
+    // 周期先頭：デューティが0でないピンをHighにする
+    waitUntil(period_start);
+    for (size_t bank = 0; bank < start_masks_.size(); ++bank) {
+        if (start_masks_[bank]) {
+            port_->setLevels(static_cast<int>(bank), start_values_[bank], start_masks_[bank]);
+        }
+    }
+
+    // 各時刻の立ち下がりエッジを出力
+    for (const Edge& edge : edges_) {
+        waitUntil(period_start + edge.time_us);
+        port_->setLevels(edge.bank, 0, edge.mask);
+    }
+
+    waitUntil(period_start + period_us_);
+}
+
+void SoftPWM::buildSchedule()
+{
+    std::fill(start_values_.begin(), start_values_.end(), 0);
+    std::fill(start_masks_.begin(), start_masks_.end(), 0);
+    edges_.clear();
+
+    // 全チャンネルのパルス幅を読み取り、周期先頭のレベルと立ち下がりエッジの予定を作成
+    size_t count = channel_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        int pin_number = channels_[i].pin_number.load(std::memory_order_acquire);
+        if (pin_number < 0) {
+            continue;
+        }
+
+        int bank       = pin_number / GPIO_PINS_PER_BANK;
+        uint32_t bit   = 1u << (pin_number % GPIO_PINS_PER_BANK);
+        uint32_t width = channels_[i].width_us.load(std::memory_order_relaxed);
+
+        start_masks_[bank] |= bit;
+        if (width == 0) {
+            continue;  // 常にLow
+        }
+        start_values_[bank] |= bit;
+        if (width < period_us_) {
+            edges_.push_back(Edge{width, bank, bit});
+        }
+    }
+
+    // 時刻順（同時刻はバンク順）に並べ、同時刻・同一バンクのエッジを1つにまとめる
+    std::sort(edges_.begin(), edges_.end(), [](const Edge& a, const Edge& b) {
+        return a.time_us != b.time_us ? a.time_us < b.time_us : a.bank < b.bank;
+    });
+    size_t merged = 0;
+    for (size_t i = 0; i < edges_.size(); ++i) {
+        Edge* last = merged > 0 ? &edges_[merged - 1] : nullptr;
+        if (last && last->time_us == edges_[i].time_us && last->bank == edges_[i].bank) {
+            last->mask |= edges_[i].mask;
+        } else {
+            edges_[merged++] = edges_[i];
+        }
+    }
+    edges_.resize(merged);
+}
+
+void SoftPWM::releaseDetached()
+{
+    // 前の周期は終わっているため、ここでLowにすれば再びHighになることはない。
+    // 解除後すぐに同じピンが再登録された場合は、新しいエッジ予定に任せる
+    for (size_t bank = 0; bank < start_masks_.size(); ++bank) {
+        uint32_t released = detached_[bank].exchange(0, std::memory_order_relaxed) & ~start_masks_[bank];
+        if (released) {
+            port_->setLevels(static_cast<int>(bank), 0, released);
+        }
+    }
+}
+
+bool SoftPWM::isAttached(int channel) const
+{
+    return channel >= 0 && static_cast<size_t>(channel) < channel_count_.load(std::memory_order_acquire) &&
+           channels_[channel].pin_number.load(std::memory_order_relaxed) >= 0;
+}
+
+void SoftPWM::waitUntil(uint32_t deadline)
+{
+    // flexhal::sleep() はミリ秒単位で長めに眠る場合もあるため、残りが短くなってからはビジーウェイトする
+    const int32_t spin_threshold_us = 2000;
+
+    int32_t remaining = static_cast<int32_t>(deadline - flexhal::micros());
+    if (remaining > spin_threshold_us) {
+        flexhal::sleep(static_cast<uint32_t>(remaining - spin_threshold_us / 2) / 1000);
+    }
+    while (static_cast<int32_t>(deadline - flexhal::micros()) > 0) {
+        flexhal::yield();
+    }
+}
+
+}  // namespace flexhal
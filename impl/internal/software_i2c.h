@@ -0,0 +1,287 @@
+/**
+ * @file software_i2c.h
+ * @brief ソフトウェアI2C（ビットバンギング）実装の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include "gpio.h"
+#include "i2c.h"
+
+namespace flexhal {
+
+/**
+ * @brief ソフトウェアI2Cの統計情報
+ */
+struct SoftwareI2CStatistics {
+    uint64_t starts           = 0;  ///< 送信したSTART数（リピーテッドスタートを含む）
+    uint64_t bytes            = 0;  ///< 送受信したバイト数（アドレスを含む）
+    uint64_t nacks            = 0;  ///< NACKを受け取った回数
+    uint64_t clock_stretches  = 0;  ///< クロックストレッチで待機した回数
+    uint64_t stretch_timeouts = 0;  ///< クロックストレッチのタイムアウト回数
+    uint64_t bus_recoveries   = 0;  ///< SDAの固着を解除した回数
+};
+
+/**
+ * @brief ソフトウェアI2Cトランスポート
+ *
+ * I2CPinPortのSDA/SCLをオープンドレインで駆動する。Highは出力を開放してプルアップに任せ、
+ * Lowは出力で引き込む。SDAの設定、SCLの開放、SCLの引き込みの各フェーズは、それぞれ対象ピンの
+ * バンクへの1回のマスク付き setLevels で出力する。
+ * SCLを開放した後はレベルを読み返し、スレーブがLowに保持している間（クロックストレッチ）は
+ * タイムアウトまで待機する
+ */
+class SoftwareI2CTransport : public II2CTransport {
+public:
+    /**
+     * @brief クロックストレッチのデフォルトのタイムアウト（マイクロ秒、SMBusの上限に合わせる）
+     */
+    static constexpr uint32_t DEFAULT_STRETCH_TIMEOUT_US = 25000;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port ピンが属するGPIOポート
+     * @param bus_config バス設定
+     * @param device_config デバイス設定
+     */
+    SoftwareI2CTransport(std::shared_ptr<IGPIOPort> port, const I2CBusConfig& bus_config,
+                         const I2CDeviceConfig& device_config);
+
+    /**
+     * @brief デストラクタ
+     */
+    virtual ~SoftwareI2CTransport() = default;
+
+    bool begin() override;
+    void end() override;
+    bool isReady() const override;
+
+    ssize_t write(const void* data, size_t length) override;
+
+    /**
+     * @brief 複数区間のデータを1回のトランザクションで書き込み
+     *
+     * 各区間をコピーせずに、1組のSTART/STOPの間で順にクロック出力する
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return ssize_t ACKされたバイト数（負の値はエラー）
+     */
+    ssize_t writev(const TransferSegment* segments, size_t count) override;
+
+    ssize_t read(void* data, size_t length) override;
+    ssize_t transfer(const void* tx_data, void* rx_data, size_t length) override;
+    ssize_t writeRead(const void* tx_data, size_t tx_length, void* rx_data, size_t rx_length) override;
+
+    bool supportsAsync() const override
+    {
+        return false;
+    }
+
+    void setAddress(I2CAddress address) override;
+    std::vector<I2CAddress> scan() override;
+    bool probe(I2CAddress address) override;
+
+    /**
+     * @brief クロック周波数を設定
+     *
+     * @param hz クロック周波数（Hz、0で待機なし）
+     */
+    void setClockFrequency(uint32_t hz);
+
+    /**
+     * @brief クロックストレッチのタイムアウトを設定
+     *
+     * @param timeout_us タイムアウト（マイクロ秒）
+     */
+    void setStretchTimeout(uint32_t timeout_us);
+
+    /**
+     * @brief 使用しているピンを取得
+     *
+     * @return const I2CPinPort& I2Cピンポート
+     */
+    const I2CPinPort& getPinPort() const
+    {
+        return pins_;
+    }
+
+    /**
+     * @brief 統計情報を取得
+     *
+     * @return SoftwareI2CStatistics 統計情報
+     */
+    SoftwareI2CStatistics getStatistics() const
+    {
+        return statistics_;
+    }
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics()
+    {
+        statistics_ = SoftwareI2CStatistics();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief SDAを設定（trueで開放、falseで引き込み）
+     */
+    void setSDA(bool high)
+    {
+        port_->setLevels(sda_bank_, high ? sda_bit_ : 0, sda_bit_);
+    }
+
+    /**
+     * @brief SCLを引き込む
+     */
+    void pullSCL()
+    {
+        port_->setLevels(scl_bank_, 0, scl_bit_);
+    }
+
+    /**
+     * @brief SDAのレベルを読み取る
+     */
+    bool readSDA() const
+    {
+        return (port_->getLevels(sda_bank_) & sda_bit_) != 0;
+    }
+
+    /**
+     * @brief SCLを開放し、Highになるまで待機（クロックストレッチ）
+     *
+     * @param edge 前回のエッジ時刻（待機した場合はHighになった時刻に更新される）
+     * @return true SCLがHighになった
+     * @return false タイムアウト
+     */
+    bool releaseSCL(Clock::time_point& edge);
+
+    /**
+     * @brief START（またはリピーテッドスタート）を送信し、アドレスを送信
+     *
+     * @param address 7ビットアドレス
+     * @param read 読み込み方向か
+     * @param repeated リピーテッドスタートか
+     * @param edge 前回のエッジ時刻
+     * @return true スレーブがACKを返した
+     * @return false NACKまたはタイムアウト（STOPは送信しない）
+     */
+    bool startTransaction(I2CAddress address, bool read, bool repeated, Clock::time_point& edge);
+
+    /**
+     * @brief STOPを送信
+     *
+     * @param edge 前回のエッジ時刻
+     * @return true 成功
+     * @return false クロックストレッチのタイムアウト（STOPを送信できていない）
+     */
+    bool stop(Clock::time_point& edge);
+
+    /**
+     * @brief 1バイト送信
+     *
+     * @param value 送信するバイト
+     * @param edge 前回のエッジ時刻
+     * @param ack スレーブがACKを返したか
+     * @return true 送信完了
+     * @return false タイムアウト
+     */
+    bool writeByte(uint8_t value, Clock::time_point& edge, bool& ack);
+
+    /**
+     * @brief 1バイト受信
+     *
+     * @param value 受信したバイト
+     * @param ack ACKを返すか（最後のバイトではNACK）
+     * @param edge 前回のエッジ時刻
+     * @return true 受信完了
+     * @return false タイムアウト
+     */
+    bool readByte(uint8_t& value, bool ack, Clock::time_point& edge);
+
+    /**
+     * @brief バイト列を送信
+     *
+     * @param data 送信データ
+     * @param length データ長
+     * @param edge 前回のエッジ時刻
+     * @return ssize_t ACKされたバイト数（タイムアウトの場合は-1）
+     */
+    ssize_t writeBytes(const uint8_t* data, size_t length, Clock::time_point& edge);
+
+    /**
+     * @brief バイト列を受信（最後のバイトにNACKを返す）
+     *
+     * @param data 受信データ
+     * @param length データ長
+     * @param edge 前回のエッジ時刻
+     * @return true 受信完了
+     * @return false タイムアウト
+     */
+    bool readBytes(uint8_t* data, size_t length, Clock::time_point& edge);
+
+    /**
+     * @brief SDAがLowに固着している場合に、SCLを最大9クロック送出して解除する
+     *
+     * @return true バスが開放されている
+     * @return false 解除できなかった
+     */
+    bool recoverBus();
+
+    /**
+     * @brief 半クロック周期だけ待機
+     *
+     * @param deadline 前回のエッジ時刻（次のエッジ時刻に更新される）
+     */
+    void waitHalfPeriod(Clock::time_point& deadline) const;
+
+    std::shared_ptr<IGPIOPort> port_;
+    I2CPinPort pins_;
+    I2CDeviceConfig config_;
+    bool initialized_ = false;
+
+    int sda_bank_     = 0;
+    uint32_t sda_bit_ = 0;
+    int scl_bank_     = 0;
+    uint32_t scl_bit_ = 0;
+
+    Clock::duration half_period_{0};
+    Clock::duration stretch_timeout_{std::chrono::microseconds(DEFAULT_STRETCH_TIMEOUT_US)};
+    SoftwareI2CStatistics statistics_;
+};
+
+/**
+ * @brief ソフトウェアI2C実装
+ *
+ * 任意のGPIOピンでI2C通信を行うトランスポートを作成する
+ */
+class SoftwareI2CImplementation : public I2CBusImplementation {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port 使用するGPIOポート（nullptrの場合はデフォルトのGPIOポート）
+     */
+    explicit SoftwareI2CImplementation(std::shared_ptr<IGPIOPort> port = nullptr);
+
+    bool isAvailable() const override;
+    std::shared_ptr<II2CTransport> createTransport(const I2CBusConfig& bus_config,
+                                                   const I2CDeviceConfig& device_config) override;
+
+private:
+    std::shared_ptr<IGPIOPort> port_;
+};
+
+}  // namespace flexhal
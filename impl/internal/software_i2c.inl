@@ -0,0 +1,394 @@
+/**
+ * @file software_i2c.inl
+ * @brief ソフトウェアI2C（ビットバンギング）実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "software_i2c.h"
+#include "../../src/flexhal/gpio.hpp"
+
+namespace flexhal {
+
+// SoftwareI2CTransport実装
+
+SoftwareI2CTransport::SoftwareI2CTransport(std::shared_ptr<IGPIOPort> port, const I2CBusConfig& bus_config,
+                                           const I2CDeviceConfig& device_config)
+    : port_(port), pins_(port->getPin(bus_config.sda_pin), port->getPin(bus_config.scl_pin)), config_(device_config)
+{
+    sda_bank_ = bus_config.sda_pin / GPIO_PINS_PER_BANK;
+    sda_bit_  = 1u << (bus_config.sda_pin % GPIO_PINS_PER_BANK);
+    scl_bank_ = bus_config.scl_pin / GPIO_PINS_PER_BANK;
+    scl_bit_  = 1u << (bus_config.scl_pin % GPIO_PINS_PER_BANK);
+
+    setClockFrequency(config_.clock_hz);
+}
+
+bool SoftwareI2CTransport::begin()
+{
+    if (initialized_) {
+        return true;
+    }
+    if (!pins_.getSDA() || !pins_.getSCL()) {
+        return false;
+    }
+
+    // 両方の線を開放した状態でオープンドレインにする
+    pins_.getSCL()->setMode(PinMode::OpenDrain);
+    pins_.getSDA()->setMode(PinMode::OpenDrain);
+    port_->setLevels(scl_bank_, scl_bit_, scl_bit_);
+    setSDA(true);
+
+    if (!recoverBus()) {
+        return false;
+    }
+    initialized_ = true;
+    return true;
+}
+
+void SoftwareI2CTransport::end()
+{
+    initialized_ = false;
+}
+
+bool SoftwareI2CTransport::isReady() const
+{
+    return initialized_;
+}
+
+ssize_t SoftwareI2CTransport::write(const void* data, size_t length)
+{
+    TransferSegment segment;
+    segment.tx_data = data;
+    segment.length  = length;
+    return writev(&segment, 1);
+}
+
+ssize_t SoftwareI2CTransport::writev(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].tx_data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+
+    Clock::time_point edge = Clock::now();
+    if (!startTransaction(config_.address, false, false, edge)) {
+        stop(edge);
+        notifyNack(config_.address);
+        return -1;
+    }
+
+    // 各区間を続けてクロック出力し、NACKされた時点で打ち切る
+    ssize_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ssize_t result = writeBytes(static_cast<const uint8_t*>(segments[i].tx_data), segments[i].length, edge);
+        if (result < 0) {
+            total = -1;
+            break;
+        }
+        total += result;
+        if (static_cast<size_t>(result) < segments[i].length) {
+            break;
+        }
+    }
+    if (!stop(edge)) {
+        return -1;
+    }
+    return total;
+}
+
+ssize_t SoftwareI2CTransport::read(void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return -1;
+    }
+
+    Clock::time_point edge = Clock::now();
+    bool addressed = startTransaction(config_.address, true, false, edge);
+    bool completed = addressed && readBytes(static_cast<uint8_t*>(data), length, edge);
+    completed      = stop(edge) && completed;
+    if (!addressed) {
+        notifyNack(config_.address);
+    }
+    return completed ? static_cast<ssize_t>(length) : -1;
+}
+
+ssize_t SoftwareI2CTransport::transfer(const void* tx_data, void* rx_data, size_t length)
+{
+    // I2Cは全二重ではないため、送信データを書き込んだ後にリピーテッドスタートで同じ長さを読み込む
+    return writeRead(tx_data, tx_data ? length : 0, rx_data, rx_data ? length : 0);
+}
+
+ssize_t SoftwareI2CTransport::writeRead(const void* tx_data, size_t tx_length, void* rx_data, size_t rx_length)
+{
+    if (!initialized_ || (!tx_data && tx_length > 0) || (!rx_data && rx_length > 0)) {
+        return -1;
+    }
+
+    // 書き込みの後はSTOPを挟まずにリピーテッドスタートで読み込み方向に切り替える
+    Clock::time_point edge = Clock::now();
+    bool addressed = startTransaction(config_.address, false, false, edge);
+    bool completed = addressed &&
+                     writeBytes(static_cast<const uint8_t*>(tx_data), tx_length, edge) ==
+                         static_cast<ssize_t>(tx_length) &&
+                     startTransaction(config_.address, true, true, edge) &&
+                     readBytes(static_cast<uint8_t*>(rx_data), rx_length, edge);
+    completed = stop(edge) && completed;
+    if (!addressed) {
+        notifyNack(config_.address);
+    }
+    return completed ? static_cast<ssize_t>(rx_length) : -1;
+}
+
+void SoftwareI2CTransport::setAddress(I2CAddress address)
+{
+    config_.address = address;
+}
+
+std::vector<I2CAddress> SoftwareI2CTransport::scan()
+{
+    std::vector<I2CAddress> found;
+    for (I2CAddress address = I2C_SCAN_FIRST_ADDRESS; address <= I2C_SCAN_LAST_ADDRESS; ++address) {
+        if (probe(address)) {
+            found.push_back(address);
+        }
+    }
+    return found;
+}
+
+bool SoftwareI2CTransport::probe(I2CAddress address)
+{
+    if (!initialized_) {
+        return false;
+    }
+
+    // 書き込み方向のアドレスだけを送り、ACKの有無を確認する
+    Clock::time_point edge = Clock::now();
+    bool ack               = startTransaction(address, false, false, edge);
+    return stop(edge) && ack;
+}
+
+void SoftwareI2CTransport::setClockFrequency(uint32_t hz)
+{
+    config_.clock_hz = hz;
+
+    // 0は待機なし（ポートの操作速度の上限で動作）
+    half_period_ = hz > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(500000000ull / hz))
+                          : Clock::duration::zero();
+}
+
+void SoftwareI2CTransport::setStretchTimeout(uint32_t timeout_us)
+{
+    stretch_timeout_ = std::chrono::microseconds(timeout_us);
+}
+
+bool SoftwareI2CTransport::releaseSCL(Clock::time_point& edge)
+{
+    port_->setLevels(scl_bank_, scl_bit_, scl_bit_);
+    if (port_->getLevels(scl_bank_) & scl_bit_) {
+        return true;
+    }
+
+    // スレーブがSCLを保持している。Highになった時刻からHigh期間を数える
+    ++statistics_.clock_stretches;
+    Clock::time_point deadline = Clock::now() + stretch_timeout_;
+    while (!(port_->getLevels(scl_bank_) & scl_bit_)) {
+        if (Clock::now() >= deadline) {
+            ++statistics_.stretch_timeouts;
+            return false;
+        }
+    }
+    edge = Clock::now();
+    return true;
+}
+
+bool SoftwareI2CTransport::startTransaction(I2CAddress address, bool read, bool repeated, Clock::time_point& edge)
+{
+    if (repeated) {
+        // SCLがLowの間にSDAを開放してから、SCLを開放する
+        setSDA(true);
+        waitHalfPeriod(edge);
+        if (!releaseSCL(edge)) {
+            return false;
+        }
+        waitHalfPeriod(edge);
+    }
+
+    // SCLがHighの間にSDAを引き込む
+    setSDA(false);
+    waitHalfPeriod(edge);
+    pullSCL();
+    ++statistics_.starts;
+
+    bool ack = false;
+    if (!writeByte(static_cast<uint8_t>((address << 1) | (read ? 0x01 : 0x00)), edge, ack)) {
+        return false;
+    }
+    return ack;
+}
+
+bool SoftwareI2CTransport::stop(Clock::time_point& edge)
+{
+    // SCLがLowの間にSDAを引き込み、SCL、SDAの順に開放する
+    setSDA(false);
+    waitHalfPeriod(edge);
+    if (!releaseSCL(edge)) {
+        // SCLが開放されないとSTOPを送信できないため、SDAだけ開放して失敗を返す
+        setSDA(true);
+        return false;
+    }
+    waitHalfPeriod(edge);
+    setSDA(true);
+    waitHalfPeriod(edge);
+    return true;
+}
+
+bool SoftwareI2CTransport::writeByte(uint8_t value, Clock::time_point& edge, bool& ack)
+{
+    for (int n = 7; n >= 0; --n) {
+        setSDA((value >> n) & 0x01);
+        waitHalfPeriod(edge);
+        if (!releaseSCL(edge)) {
+            return false;
+        }
+        waitHalfPeriod(edge);
+        pullSCL();
+    }
+
+    // 9クロック目でスレーブのACKを読み取る
+    setSDA(true);
+    waitHalfPeriod(edge);
+    if (!releaseSCL(edge)) {
+        return false;
+    }
+    waitHalfPeriod(edge);
+    ack = !readSDA();
+    pullSCL();
+
+    ++statistics_.bytes;
+    if (!ack) {
+        ++statistics_.nacks;
+    }
+    return true;
+}
+
+bool SoftwareI2CTransport::readByte(uint8_t& value, bool ack, Clock::time_point& edge)
+{
+    // SDAを開放してスレーブに駆動させ、High期間の終わりに読み取る
+    setSDA(true);
+    uint8_t in = 0;
+    for (int n = 7; n >= 0; --n) {
+        waitHalfPeriod(edge);
+        if (!releaseSCL(edge)) {
+            return false;
+        }
+        waitHalfPeriod(edge);
+        in = static_cast<uint8_t>((in << 1) | (readSDA() ? 0x01 : 0x00));
+        pullSCL();
+    }
+
+    // 9クロック目でACK/NACKを返す
+    setSDA(!ack);
+    waitHalfPeriod(edge);
+    if (!releaseSCL(edge)) {
+        return false;
+    }
+    waitHalfPeriod(edge);
+    pullSCL();
+
+    value = in;
+    ++statistics_.bytes;
+    return true;
+}
+
+ssize_t SoftwareI2CTransport::writeBytes(const uint8_t* data, size_t length, Clock::time_point& edge)
+{
+    for (size_t i = 0; i < length; ++i) {
+        bool ack = false;
+        if (!writeByte(data[i], edge, ack)) {
+            return -1;
+        }
+        if (!ack) {
+            return static_cast<ssize_t>(i);
+        }
+    }
+    return static_cast<ssize_t>(length);
+}
+
+bool SoftwareI2CTransport::readBytes(uint8_t* data, size_t length, Clock::time_point& edge)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (!readByte(data[i], i + 1 < length, edge)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SoftwareI2CTransport::recoverBus()
+{
+    if (readSDA()) {
+        return true;
+    }
+
+    // 読み込み途中で止まったスレーブがSDAを離すまでクロックを送り、STOPで終える
+    ++statistics_.bus_recoveries;
+    Clock::time_point edge = Clock::now();
+    for (int i = 0; i < 9 && !readSDA(); ++i) {
+        pullSCL();
+        waitHalfPeriod(edge);
+        if (!releaseSCL(edge)) {
+            return false;
+        }
+        waitHalfPeriod(edge);
+    }
+    if (!readSDA()) {
+        return false;
+    }
+    pullSCL();
+    waitHalfPeriod(edge);
+    return stop(edge) && readSDA();
+}
+
+void SoftwareI2CTransport::waitHalfPeriod(Clock::time_point& deadline) const
+{
+    if (half_period_ == Clock::duration::zero()) {
+        return;
+    }
+
+    // 前回のエッジ時刻から積算し、ポート操作にかかった時間を差し引いて待機する
+    deadline += half_period_;
+    while (Clock::now() < deadline) {
+    }
+}
+
+// SoftwareI2CImplementation実装
+
+SoftwareI2CImplementation::SoftwareI2CImplementation(std::shared_ptr<IGPIOPort> port) : port_(std::move(port))
+{
+}
+
+bool SoftwareI2CImplementation::isAvailable() const
+{
+    return port_ || getDefaultGPIOPort();
+}
+
+std::shared_ptr<II2CTransport> SoftwareI2CImplementation::createTransport(const I2CBusConfig& bus_config,
+                                                                          const I2CDeviceConfig& device_config)
+{
+    std::shared_ptr<IGPIOPort> port = port_ ? port_ : getDefaultGPIOPort();
+    if (!port || bus_config.sda_pin < 0 || bus_config.scl_pin < 0) {
+        return nullptr;
+    }
+
+    return std::make_shared<SoftwareI2CTransport>(port, bus_config, device_config);
+}
+
+}  // namespace flexhal
@@ -0,0 +1,184 @@
+/**
+ * @file software_spi.h
+ * @brief ソフトウェアSPI（ビットバンギング）実装の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include "gpio.h"
+#include "spi.h"
+
+namespace flexhal {
+
+/**
+ * @brief ソフトウェアSPIトランスポート
+ *
+ * SPIPinPortのピンをGPIOポートのバンク一括操作で駆動する。
+ * SPIモードから各ビットの「データ設定エッジ」「ラッチエッジ」で出力するSCK/MOSIの値とマスクを
+ * 事前に計算しておき、1エッジにつき1回の setLevels で出力する。MISOはラッチエッジの直後に
+ * getLevels で読み取る。
+ */
+class SoftwareSPITransport : public ISPITransport {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port ピンが属するGPIOポート
+     * @param bus_config バス設定
+     * @param device_config デバイス設定
+     */
+    SoftwareSPITransport(std::shared_ptr<IGPIOPort> port, const SPIBusConfig& bus_config,
+                         const SPIDeviceConfig& device_config);
+
+    /**
+     * @brief デストラクタ
+     */
+    virtual ~SoftwareSPITransport() = default;
+
+    bool begin() override;
+    void end() override;
+    bool isReady() const override;
+
+    ssize_t write(const void* data, size_t length) override;
+    ssize_t read(void* data, size_t length) override;
+    ssize_t transfer(const void* tx_data, void* rx_data, size_t length) override;
+
+    ssize_t writev(const TransferSegment* segments, size_t count) override;
+    ssize_t readv(const TransferSegment* segments, size_t count) override;
+    ssize_t transferv(const TransferSegment* segments, size_t count) override;
+
+    bool supportsAsync() const override
+    {
+        return false;
+    }
+
+    void setClockFrequency(uint32_t hz) override;
+    void setMode(SPIMode mode) override;
+    void setLSBFirst(bool lsb_first) override;
+    void setDC(bool dc_level) override;
+    bool setCSHold(bool hold) override;
+    bool isCSHeld() const override;
+    ssize_t writeCommandStream(const SPICommandSegment* segments, size_t count) override;
+
+    /**
+     * @brief 使用しているピンを取得
+     *
+     * @return const SPIPinPort& SPIピンポート
+     */
+    const SPIPinPort& getPinPort() const
+    {
+        return pins_;
+    }
+
+    /**
+     * @brief read()で送信するダミーデータ
+     */
+    static constexpr uint8_t READ_FILL = 0xFF;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief LSBファースト時に一度にビット順を反転するバイト数
+     */
+    static constexpr size_t BIT_REVERSE_CHUNK = 64;
+
+    /**
+     * @brief SPIモードからエッジごとの出力値を再計算
+     */
+    void updateEdgeMasks();
+
+    /**
+     * @brief バイト列を送受信
+     *
+     * @param tx_data 送信データ（nullptrの場合はREAD_FILLを送信）
+     * @param rx_data 受信データ（nullptrの場合はMISOを読み取らない）
+     * @param length データ長
+     */
+    void transferBytes(const uint8_t* tx_data, uint8_t* rx_data, size_t length);
+
+    /**
+     * @brief バイト列をMSBファーストで送受信
+     *
+     * @param tx_data 送信データ（nullptrの場合はREAD_FILLを送信）
+     * @param rx_data 受信データ（nullptrの場合はMISOを読み取らない）
+     * @param length データ長
+     * @param edge 前回のエッジ時刻（最後のエッジ時刻に更新される）
+     */
+    void shiftBytes(const uint8_t* tx_data, uint8_t* rx_data, size_t length, Clock::time_point& edge);
+
+    /**
+     * @brief CSを選択した状態で各区間を順に送受信
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return ssize_t 転送したバイト数
+     */
+    ssize_t transferSegments(const TransferSegment* segments, size_t count);
+
+    /**
+     * @brief 半クロック周期だけ待機
+     *
+     * @param deadline 前回のエッジ時刻（次のエッジ時刻に更新される）
+     */
+    void waitHalfPeriod(Clock::time_point& deadline) const;
+
+    /**
+     * @brief CSピンのレベルを設定（保持中は何もしない）
+     *
+     * @param active trueでアクティブ（Low）
+     */
+    void selectDevice(bool active);
+
+    std::shared_ptr<IGPIOPort> port_;
+    SPIPinPort pins_;
+    SPIDeviceConfig config_;
+    bool initialized_ = false;
+    bool cs_held_     = false;
+
+    int sck_bank_      = 0;
+    uint32_t sck_bit_  = 0;
+    int mosi_bank_     = 0;
+    uint32_t mosi_bit_ = 0;
+    int miso_bank_     = 0;
+    uint32_t miso_bit_ = 0;
+    bool mosi_shared_  = false;  ///< MOSIがSCKと同じバンクにあるか
+
+    uint32_t setup_values_[2] = {0, 0};  ///< データ設定エッジの出力値（MOSIのビット値ごと）
+    uint32_t setup_mask_      = 0;       ///< データ設定エッジの出力マスク
+    uint32_t latch_value_     = 0;       ///< ラッチエッジのSCK出力値
+    uint32_t idle_value_      = 0;       ///< アイドル時のSCK出力値
+    bool cpha_                = false;
+    Clock::duration half_period_{0};
+};
+
+/**
+ * @brief ソフトウェアSPI実装
+ *
+ * 任意のGPIOピンでSPI通信を行うトランスポートを作成する
+ */
+class SoftwareSPIImplementation : public SPIBusImplementation {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param port 使用するGPIOポート（nullptrの場合はデフォルトのGPIOポート）
+     */
+    explicit SoftwareSPIImplementation(std::shared_ptr<IGPIOPort> port = nullptr);
+
+    bool isAvailable() const override;
+    std::shared_ptr<ISPITransport> createTransport(const SPIBusConfig& bus_config,
+                                                   const SPIDeviceConfig& device_config) override;
+
+private:
+    std::shared_ptr<IGPIOPort> port_;
+};
+
+}  // namespace flexhal
@@ -0,0 +1,370 @@
+/**
+ * @file software_spi.inl
+ * @brief ソフトウェアSPI（ビットバンギング）実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "software_spi.h"
+#include <algorithm>
+#include "bit_reverse.h"
+#include "../../src/flexhal/gpio.hpp"
+
+namespace flexhal {
+
+// SoftwareSPITransport実装
+
+SoftwareSPITransport::SoftwareSPITransport(std::shared_ptr<IGPIOPort> port, const SPIBusConfig& bus_config,
+                                           const SPIDeviceConfig& device_config)
+    : port_(port),
+      pins_(port->getPin(bus_config.sck_pin), bus_config.miso_pin >= 0 ? port->getPin(bus_config.miso_pin) : nullptr,
+            bus_config.mosi_pin >= 0 ? port->getPin(bus_config.mosi_pin) : nullptr,
+            device_config.cs_pin >= 0 ? port->getPin(device_config.cs_pin) : nullptr),
+      config_(device_config)
+{
+    sck_bank_ = bus_config.sck_pin / GPIO_PINS_PER_BANK;
+    sck_bit_  = 1u << (bus_config.sck_pin % GPIO_PINS_PER_BANK);
+    if (bus_config.mosi_pin >= 0) {
+        mosi_bank_   = bus_config.mosi_pin / GPIO_PINS_PER_BANK;
+        mosi_bit_    = 1u << (bus_config.mosi_pin % GPIO_PINS_PER_BANK);
+        mosi_shared_ = mosi_bank_ == sck_bank_;
+    }
+    if (bus_config.miso_pin >= 0) {
+        miso_bank_ = bus_config.miso_pin / GPIO_PINS_PER_BANK;
+        miso_bit_  = 1u << (bus_config.miso_pin % GPIO_PINS_PER_BANK);
+    }
+
+    updateEdgeMasks();
+    setClockFrequency(config_.clock_hz);
+}
+
+bool SoftwareSPITransport::begin()
+{
+    if (initialized_) {
+        return true;
+    }
+    if (!pins_.getSCK()) {
+        return false;
+    }
+
+    // SCKはアイドルレベル、CSは非選択状態で出力にする
+    pins_.getSCK()->setMode(PinMode::Output);
+    port_->setLevels(sck_bank_, idle_value_, sck_bit_);
+    if (pins_.getMOSI()) {
+        pins_.getMOSI()->setMode(PinMode::Output);
+    }
+    if (pins_.getMISO()) {
+        pins_.getMISO()->setMode(PinMode::Input);
+    }
+    if (pins_.getCS()) {
+        pins_.getCS()->setMode(PinMode::Output);
+        pins_.getCS()->setLevel(PinLevel::High);
+    }
+    if (config_.dc_pin >= 0) {
+        port_->setPinMode(config_.dc_pin, PinMode::Output);
+    }
+
+    initialized_ = true;
+    return true;
+}
+
+void SoftwareSPITransport::end()
+{
+    if (!initialized_) {
+        return;
+    }
+
+    if (pins_.getCS()) {
+        pins_.getCS()->setLevel(PinLevel::High);
+    }
+    cs_held_     = false;
+    initialized_ = false;
+}
+
+bool SoftwareSPITransport::isReady() const
+{
+    return initialized_;
+}
+
+ssize_t SoftwareSPITransport::write(const void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return -1;
+    }
+
+    selectDevice(true);
+    transferBytes(static_cast<const uint8_t*>(data), nullptr, length);
+    selectDevice(false);
+    return static_cast<ssize_t>(length);
+}
+
+ssize_t SoftwareSPITransport::read(void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return -1;
+    }
+
+    selectDevice(true);
+    transferBytes(nullptr, static_cast<uint8_t*>(data), length);
+    selectDevice(false);
+    return static_cast<ssize_t>(length);
+}
+
+ssize_t SoftwareSPITransport::transfer(const void* tx_data, void* rx_data, size_t length)
+{
+    if (!initialized_ || (!tx_data && !rx_data && length > 0)) {
+        return -1;
+    }
+
+    selectDevice(true);
+    transferBytes(static_cast<const uint8_t*>(tx_data), static_cast<uint8_t*>(rx_data), length);
+    selectDevice(false);
+    return static_cast<ssize_t>(length);
+}
+
+ssize_t SoftwareSPITransport::writev(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].tx_data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+    return transferSegments(segments, count);
+}
+
+ssize_t SoftwareSPITransport::readv(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].rx_data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+    return transferSegments(segments, count);
+}
+
+ssize_t SoftwareSPITransport::transferv(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    return transferSegments(segments, count);
+}
+
+void SoftwareSPITransport::setClockFrequency(uint32_t hz)
+{
+    config_.clock_hz = hz;
+
+    // 0は待機なし（ポートの操作速度の上限で動作）
+    half_period_ = hz > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(500000000ull / hz))
+                          : Clock::duration::zero();
+}
+
+void SoftwareSPITransport::setMode(SPIMode mode)
+{
+    config_.mode = mode;
+    updateEdgeMasks();
+    if (initialized_) {
+        port_->setLevels(sck_bank_, idle_value_, sck_bit_);
+    }
+}
+
+void SoftwareSPITransport::setLSBFirst(bool lsb_first)
+{
+    config_.bit_order = lsb_first ? SPIBitOrder::LSBFirst : SPIBitOrder::MSBFirst;
+}
+
+void SoftwareSPITransport::setDC(bool dc_level)
+{
+    if (config_.dc_pin >= 0) {
+        port_->writePin(config_.dc_pin, dc_level ? PinLevel::High : PinLevel::Low);
+    }
+}
+
+bool SoftwareSPITransport::setCSHold(bool hold)
+{
+    if (!initialized_) {
+        return false;
+    }
+    if (hold != cs_held_) {
+        cs_held_ = false;
+        selectDevice(hold);
+        cs_held_ = hold;
+    }
+    return true;
+}
+
+bool SoftwareSPITransport::isCSHeld() const
+{
+    return cs_held_;
+}
+
+ssize_t SoftwareSPITransport::writeCommandStream(const SPICommandSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+
+    // DCはSCKが止まっている区間の境目でだけ切り替える
+    size_t total = 0;
+    selectDevice(true);
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0 || segments[i].dc != segments[i - 1].dc) {
+            setDC(segments[i].dc);
+        }
+        transferBytes(static_cast<const uint8_t*>(segments[i].data), nullptr, segments[i].length);
+        total += segments[i].length;
+    }
+    selectDevice(false);
+    return static_cast<ssize_t>(total);
+}
+
+void SoftwareSPITransport::updateEdgeMasks()
+{
+    bool cpol = config_.mode == SPIMode::Mode2 || config_.mode == SPIMode::Mode3;
+    cpha_     = config_.mode == SPIMode::Mode1 || config_.mode == SPIMode::Mode3;
+
+    idle_value_         = cpol ? sck_bit_ : 0;
+    uint32_t active_sck = cpol ? 0 : sck_bit_;
+
+    // CPHA=0: SCKをアイドルに戻すと同時にデータを設定し、アクティブへの遷移でラッチ
+    // CPHA=1: SCKをアクティブにすると同時にデータを設定し、アイドルへの遷移でラッチ
+    uint32_t setup_sck = cpha_ ? active_sck : idle_value_;
+    latch_value_       = cpha_ ? idle_value_ : active_sck;
+
+    uint32_t mosi_bit = mosi_shared_ ? mosi_bit_ : 0;
+    setup_values_[0]  = setup_sck;
+    setup_values_[1]  = setup_sck | mosi_bit;
+    setup_mask_       = sck_bit_ | mosi_bit;
+}
+
+void SoftwareSPITransport::transferBytes(const uint8_t* tx_data, uint8_t* rx_data, size_t length)
+{
+    Clock::time_point edge = Clock::now();
+
+    if (config_.bit_order == SPIBitOrder::LSBFirst) {
+        // LSBファーストはビット順を一括で反転してからMSBファーストで送受信する。
+        // READ_FILL(0xFF)は反転しても変わらないので、送信データがない場合はそのまま渡す
+        uint8_t reversed[BIT_REVERSE_CHUNK];
+        for (size_t offset = 0; offset < length; offset += BIT_REVERSE_CHUNK) {
+            size_t count = std::min(length - offset, BIT_REVERSE_CHUNK);
+            if (tx_data) {
+                reverseBitOrder(tx_data + offset, reversed, count);
+            }
+            shiftBytes(tx_data ? reversed : nullptr, rx_data ? rx_data + offset : nullptr, count, edge);
+            if (rx_data) {
+                reverseBitOrder(rx_data + offset, count);
+            }
+        }
+    } else {
+        shiftBytes(tx_data, rx_data, length, edge);
+    }
+
+    // CPHA=0ではSCKがアクティブのまま終わるためアイドルに戻す
+    if (!cpha_ && length > 0) {
+        port_->setLevels(sck_bank_, idle_value_, sck_bit_);
+    }
+}
+
+void SoftwareSPITransport::shiftBytes(const uint8_t* tx_data, uint8_t* rx_data, size_t length,
+                                      Clock::time_point& edge)
+{
+    bool separate_mosi = mosi_bit_ && !mosi_shared_;
+    bool sample_miso   = rx_data && miso_bit_;
+
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t out = tx_data ? tx_data[i] : READ_FILL;
+        uint8_t in  = 0;
+
+        for (int n = 7; n >= 0; --n) {
+            uint32_t bit = (out >> n) & 0x01;
+
+            // データ設定エッジ（MOSIが別バンクの場合のみ2回に分かれる）
+            if (separate_mosi) {
+                port_->setLevels(mosi_bank_, bit ? mosi_bit_ : 0, mosi_bit_);
+            }
+            port_->setLevels(sck_bank_, setup_values_[bit], setup_mask_);
+            waitHalfPeriod(edge);
+
+            // ラッチエッジ（スレーブと同じタイミングでMISOを読み取る）
+            port_->setLevels(sck_bank_, latch_value_, sck_bit_);
+            if (sample_miso && (port_->getLevels(miso_bank_) & miso_bit_)) {
+                in |= static_cast<uint8_t>(1u << n);
+            }
+            waitHalfPeriod(edge);
+        }
+
+        if (rx_data) {
+            rx_data[i] = in;
+        }
+    }
+}
+
+ssize_t SoftwareSPITransport::transferSegments(const TransferSegment* segments, size_t count)
+{
+    size_t total = 0;
+    selectDevice(true);
+    for (size_t i = 0; i < count; ++i) {
+        transferBytes(static_cast<const uint8_t*>(segments[i].tx_data), static_cast<uint8_t*>(segments[i].rx_data),
+                      segments[i].length);
+        total += segments[i].length;
+    }
+    selectDevice(false);
+    return static_cast<ssize_t>(total);
+}
+
+void SoftwareSPITransport::waitHalfPeriod(Clock::time_point& deadline) const
+{
+    if (half_period_ == Clock::duration::zero()) {
+        return;
+    }
+
+    // 前回のエッジ時刻から積算し、ポート操作にかかった時間を差し引いて待機する
+    deadline += half_period_;
+    while (Clock::now() < deadline) {
+    }
+}
+
+void SoftwareSPITransport::selectDevice(bool active)
+{
+    if (!cs_held_ && config_.cs_pin >= 0) {
+        port_->writePin(config_.cs_pin, active ? PinLevel::Low : PinLevel::High);
+    }
+}
+
+// SoftwareSPIImplementation実装
+
+SoftwareSPIImplementation::SoftwareSPIImplementation(std::shared_ptr<IGPIOPort> port) : port_(std::move(port))
+{
+}
+
+bool SoftwareSPIImplementation::isAvailable() const
+{
+    return port_ || getDefaultGPIOPort();
+}
+
+std::shared_ptr<ISPITransport> SoftwareSPIImplementation::createTransport(const SPIBusConfig& bus_config,
+                                                                          const SPIDeviceConfig& device_config)
+{
+    std::shared_ptr<IGPIOPort> port = port_ ? port_ : getDefaultGPIOPort();
+    if (!port || bus_config.sck_pin < 0 || (bus_config.mosi_pin < 0 && bus_config.miso_pin < 0)) {
+        return nullptr;
+    }
+
+    return std::make_shared<SoftwareSPITransport>(port, bus_config, device_config);
+}
+
+}  // namespace flexhal
@@ -11,8 +11,10 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "core.h"
 #include "transport.h"
+#include "transport_cache.h"
 #include "pin.h"
 
 namespace flexhal {
@@ -31,11 +33,23 @@ struct SPIBusConfig {
  */
 struct SPIDeviceConfig {
     int cs_pin            = -1;                     ///< CSピン番号
+    int dc_pin            = -1;                     ///< DCピン番号（ディスプレイなどで使用）
     uint32_t clock_hz     = 1000000;                ///< クロック周波数（Hz）
     SPIMode mode          = SPIMode::Mode0;         ///< SPIモード
     SPIBitOrder bit_order = SPIBitOrder::MSBFirst;  ///< ビットオーダー
 };
 
+/**
+ * @brief DCピンのレベルを伴う送信区間
+ *
+ * ディスプレイなどのコマンド（DC=Low）とパラメータ・データ（DC=High）を区別して送る
+ */
+struct SPICommandSegment {
+    bool dc;           ///< 送信中のDCピンのレベル
+    const void* data;  ///< 送信データ
+    size_t length;     ///< データ長
+};
+
 /**
  * @brief SPIトランスポートインターフェース
  */
@@ -70,6 +84,69 @@ public:
      * @param dc_level DCピンのレベル
      */
     virtual void setDC(bool dc_level) = 0;
+
+    /**
+     * @brief CSをアクティブのまま保持するか設定
+     *
+     * 保持中は write() などの呼び出しごとにCSを切り替えず、複数の呼び出しを1回の
+     * CSアクティブ期間として転送する。解除するとCSを非アクティブに戻す
+     *
+     * @param hold trueで保持開始（CSをアクティブにする）、falseで解除
+     * @return true 設定成功
+     * @return false 未対応または未初期化
+     */
+    virtual bool setCSHold(bool hold)
+    {
+        (void)hold;
+        return false;
+    }
+
+    /**
+     * @brief CSを保持中か確認
+     *
+     * @return true 保持中（setCSHold(true) 済み）
+     * @return false 保持していない、またはCSの保持に未対応
+     */
+    virtual bool isCSHeld() const
+    {
+        return false;
+    }
+
+    /**
+     * @brief DCピンを切り替えながら各区間を1回のCSアクティブ期間で送信
+     *
+     * 既定の実装はCSを保持し、DCが変わる区間でだけ setDC() を呼んで write() する。
+     * 呼び出し元（SPITransaction など）がすでにCSを保持している場合は、終了後もそのまま保持する。
+     * CSを保持できないトランスポートでは区間ごとにCSが切り替わる
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return ssize_t 送信したバイト数（エラー時は-1）
+     */
+    virtual ssize_t writeCommandStream(const SPICommandSegment* segments, size_t count)
+    {
+        // 外側で保持されているCSは解除しないよう、ここで保持を開始した場合だけ解除する
+        bool acquired = !isCSHeld() && setCSHold(true);
+        ssize_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (i == 0 || segments[i].dc != segments[i - 1].dc) {
+                setDC(segments[i].dc);
+            }
+            if (segments[i].length == 0) {
+                continue;
+            }
+            ssize_t result = write(segments[i].data, segments[i].length);
+            if (result < 0) {
+                total = -1;
+                break;
+            }
+            total += result;
+        }
+        if (acquired) {
+            setCSHold(false);
+        }
+        return total;
+    }
 };
 
 /**
@@ -122,10 +199,29 @@ public:
      */
     virtual std::shared_ptr<ISPITransport> getTransport(const SPIDeviceConfig& device_config,
                                                         std::shared_ptr<SPIBusImplementation> implementation) = 0;
+
+    /**
+     * @brief 共有しない専用のトランスポートを作成（自動実装選択）
+     *
+     * 取得後に設定を変更しても他の利用者に影響しない。既定の実装は作成できない
+     *
+     * @param device_config デバイス設定
+     * @return std::shared_ptr<ISPITransport> トランスポート（作成できない場合はnullptr）
+     */
+    virtual std::shared_ptr<ISPITransport> createTransport(const SPIDeviceConfig& device_config)
+    {
+        (void)device_config;
+        return nullptr;
+    }
 };
 
 /**
  * @brief SPIバス実装
+ *
+ * 取得したトランスポートはデバイス設定（CS・DCピン、クロック、モード、ビットオーダー）と実装をキーにキャッシュされ、
+ * 同じ設定での取得には同じインスタンスが共有される。共有されたトランスポートの設定を
+ * 変更したり end() を呼び出したりすると、他の利用者にも影響する点に注意すること。
+ * 設定を変更しながら使う場合は createTransport() で専用のトランスポートを作成すること
  */
 class SPIBus : public ISPIBus {
 public:
@@ -143,6 +239,7 @@ public:
     std::shared_ptr<ISPITransport> getTransport(const SPIDeviceConfig& device_config) override;
     std::shared_ptr<ISPITransport> getTransport(const SPIDeviceConfig& device_config,
                                                 std::shared_ptr<SPIBusImplementation> implementation) override;
+    std::shared_ptr<ISPITransport> createTransport(const SPIDeviceConfig& device_config) override;
 
     /**
      * @brief 実装を追加
@@ -151,9 +248,57 @@ public:
      */
     void addImplementation(std::shared_ptr<SPIBusImplementation> implementation);
 
+    /**
+     * @brief トランスポートキャッシュの統計情報を取得
+     *
+     * @return TransportCacheStatistics 統計情報
+     */
+    TransportCacheStatistics getTransportCacheStatistics() const
+    {
+        return transport_cache_.getStatistics();
+    }
+
+    /**
+     * @brief トランスポートキャッシュの統計情報をリセット
+     */
+    void resetTransportCacheStatistics()
+    {
+        transport_cache_.resetStatistics();
+    }
+
+    /**
+     * @brief トランスポートキャッシュの容量を設定
+     *
+     * @param capacity 容量
+     */
+    void setTransportCacheCapacity(size_t capacity)
+    {
+        transport_cache_.setCapacity(capacity);
+    }
+
+    /**
+     * @brief トランスポートキャッシュを空にする
+     */
+    void clearTransportCache()
+    {
+        transport_cache_.clear();
+    }
+
 private:
+    /**
+     * @brief トランスポートキャッシュのキー
+     */
+    struct TransportKey {
+        SPIDeviceConfig config;
+        const SPIBusImplementation* implementation;  ///< 指定された実装（自動選択の場合はnullptr）
+
+        bool operator==(const TransportKey& other) const;
+    };
+
+
     SPIBusConfig config_;
     std::vector<std::shared_ptr<SPIBusImplementation>> implementations_;
+    TransportCache<TransportKey, ISPITransport> transport_cache_;
     bool initialized_ = false;
 };
 
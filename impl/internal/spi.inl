@@ -0,0 +1,108 @@
+/**
+ * @file spi.inl
+ * @brief FlexHAL - SPIバスの共通実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "spi.h"
+#include "software_spi.h"
+#include "../../src/flexhal/spi.hpp"
+
+namespace flexhal {
+
+// SPIBus実装
+
+SPIBus::SPIBus(const SPIBusConfig& config) : config_(config)
+{
+}
+
+bool SPIBus::begin()
+{
+    initialized_ = true;
+    return true;
+}
+
+void SPIBus::end()
+{
+    transport_cache_.clear();
+    initialized_ = false;
+}
+
+bool SPIBus::isReady() const
+{
+    return initialized_;
+}
+
+std::shared_ptr<ISPITransport> SPIBus::getTransport(const SPIDeviceConfig& device_config)
+{
+    TransportKey key{device_config, nullptr};
+    if (auto transport = transport_cache_.find(key)) {
+        return transport;
+    }
+    return transport_cache_.insert(key, createTransport(device_config));
+}
+
+std::shared_ptr<ISPITransport> SPIBus::getTransport(const SPIDeviceConfig& device_config,
+                                                    std::shared_ptr<SPIBusImplementation> implementation)
+{
+    if (!implementation || !implementation->isAvailable()) {
+        return nullptr;
+    }
+
+    TransportKey key{device_config, implementation.get()};
+    if (auto transport = transport_cache_.find(key)) {
+        return transport;
+    }
+    return transport_cache_.insert(key, implementation->createTransport(config_, device_config));
+}
+
+std::shared_ptr<ISPITransport> SPIBus::createTransport(const SPIDeviceConfig& device_config)
+{
+    // 追加された順に、トランスポートを作成できた最初の実装を使用する
+    for (const auto& implementation : implementations_) {
+        if (implementation && implementation->isAvailable()) {
+            auto transport = implementation->createTransport(config_, device_config);
+            if (transport) {
+                return transport;
+            }
+        }
+    }
+
+    // 利用可能な実装がなければソフトウェアSPIを使用する
+    return createSoftwareSPIImplementation()->createTransport(config_, device_config);
+}
+
+void SPIBus::addImplementation(std::shared_ptr<SPIBusImplementation> implementation)
+{
+    if (implementation) {
+        implementations_.push_back(implementation);
+
+        // 自動選択の結果が変わる可能性があるため、キャッシュを破棄する
+        transport_cache_.clear();
+    }
+}
+
+bool SPIBus::TransportKey::operator==(const TransportKey& other) const
+{
+    return config.cs_pin == other.config.cs_pin && config.dc_pin == other.config.dc_pin &&
+           config.clock_hz == other.config.clock_hz && config.mode == other.config.mode &&
+           config.bit_order == other.config.bit_order && implementation == other.implementation;
+}
+
+// SPIバスを作成
+std::shared_ptr<ISPIBus> createSPIBus(const SPIBusConfig& config)
+{
+    return std::make_shared<SPIBus>(config);
+}
+
+// ソフトウェアSPI実装を作成
+std::shared_ptr<SPIBusImplementation> createSoftwareSPIImplementation()
+{
+    return std::make_shared<SoftwareSPIImplementation>();
+}
+
+}  // namespace flexhal
@@ -0,0 +1,236 @@
+/**
+ * @file spi_arbiter.h
+ * @brief 共有SPIバスの調停の定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "spi.h"
+
+namespace flexhal {
+
+class SPIBusArbiter;
+
+/**
+ * @brief SPIバス調停の統計情報
+ */
+struct SPIArbiterStatistics {
+    uint64_t transactions     = 0;  ///< 取得したトランザクション数
+    uint64_t owner_changes    = 0;  ///< 直前と異なるデバイスへの切り替え回数
+    uint64_t reconfigurations = 0;  ///< クロック・モード・ビットオーダーを再設定した回数
+    uint64_t cs_reuses        = 0;  ///< CSをアクティブのまま引き継いだ回数
+};
+
+/**
+ * @brief SPIバスの占有期間（トランザクション）
+ *
+ * 有効な間はバスを占有し、CSをアクティブのまま保持する。破棄または end() で占有を解除する。
+ * ムーブのみ可能
+ */
+class SPITransaction {
+public:
+    /**
+     * @brief 無効なトランザクションを作成
+     */
+    SPITransaction() = default;
+
+    /**
+     * @brief デストラクタ（占有を解除）
+     */
+    ~SPITransaction();
+
+    SPITransaction(SPITransaction&& other) noexcept;
+    SPITransaction& operator=(SPITransaction&& other) noexcept;
+    SPITransaction(const SPITransaction&)            = delete;
+    SPITransaction& operator=(const SPITransaction&) = delete;
+
+    /**
+     * @brief バスを占有しているか確認
+     *
+     * @return true 占有している
+     * @return false 無効
+     */
+    bool isValid() const
+    {
+        return transport_ != nullptr;
+    }
+
+    /**
+     * @brief トランスポートを取得
+     *
+     * @return ISPITransport* トランスポート（無効な場合はnullptr）
+     */
+    ISPITransport* getTransport() const
+    {
+        return transport_;
+    }
+
+    ISPITransport* operator->() const
+    {
+        return transport_;
+    }
+
+    /**
+     * @brief 終了後もCSをアクティブのまま保持するか設定
+     *
+     * trueの場合、別のデバイスがバスを取得するか SPIBusArbiter::deselect() が呼ばれるまで
+     * CSを保持し、同じデバイスの次のトランザクションはCSを切り替えずに継続する
+     *
+     * @param keep_selected trueで保持
+     */
+    void setKeepSelected(bool keep_selected)
+    {
+        keep_selected_ = keep_selected;
+    }
+
+    /**
+     * @brief 占有を解除
+     */
+    void end();
+
+private:
+    friend class SPIBusArbiter;
+
+    SPITransaction(SPIBusArbiter* arbiter, std::unique_lock<std::mutex>&& lock, ISPITransport* transport,
+                   bool keep_selected);
+
+    SPIBusArbiter* arbiter_   = nullptr;
+    ISPITransport* transport_ = nullptr;
+    bool keep_selected_       = false;
+    std::unique_lock<std::mutex> lock_;
+};
+
+/**
+ * @brief 共有SPIバスの調停
+ *
+ * 複数のタスクからのトランザクションを直列化する。デバイス（CS・DCピン）ごとに ISPIBus::createTransport() で
+ * 専用のトランスポートを作成して現在の設定を記憶し、取得時には変化したクロック・モード・ビットオーダーだけを
+ * 再設定する。同じデバイスのトランザクションが続く場合は、CSの切り替えも省略できる。
+ *
+ * 調停下のトランスポートはバスのキャッシュと共有しないため、設定の変更が他の利用者に影響することはない。
+ * ただし同じバスから直接取得したトランスポートの転送は調停されないため、混在させないこと。
+ *
+ * トランザクションはバスのロックを保持するため、有効なトランザクションを持つスレッドから
+ * acquire() や deselect() を呼び出すと失敗する。トランザクション中にCSの保持をやめる場合は
+ * SPITransaction::setKeepSelected(false) を使う
+ */
+class SPIBusArbiter {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param bus 調停するSPIバス
+     */
+    explicit SPIBusArbiter(std::shared_ptr<ISPIBus> bus);
+
+    /**
+     * @brief デストラクタ（保持中のCSを解除）
+     */
+    ~SPIBusArbiter();
+
+    SPIBusArbiter(const SPIBusArbiter&)            = delete;
+    SPIBusArbiter& operator=(const SPIBusArbiter&) = delete;
+
+    /**
+     * @brief バスを占有してトランザクションを開始
+     *
+     * 他のトランザクションが終了するまで待機する
+     *
+     * @param device_config デバイス設定
+     * @param keep_selected 終了後もCSを保持するか
+     * @return SPITransaction トランザクション（トランスポートを取得できない場合、または呼び出し元のスレッドが
+     *         すでにトランザクションを保持している場合は無効）
+     */
+    SPITransaction acquire(const SPIDeviceConfig& device_config, bool keep_selected = false);
+
+    /**
+     * @brief 保持中のCSを解除
+     *
+     * @return true 解除した（保持中のCSがない場合を含む）
+     * @return false 呼び出し元のスレッドがトランザクションを保持している（デッドロックを避けて何もしない）
+     */
+    bool deselect();
+
+    /**
+     * @brief 統計情報を取得
+     *
+     * @return SPIArbiterStatistics 統計情報
+     */
+    SPIArbiterStatistics getStatistics() const;
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics();
+
+private:
+    friend class SPITransaction;
+
+    /**
+     * @brief デバイスごとの状態
+     */
+    struct Device {
+        std::shared_ptr<ISPITransport> transport;  ///< このデバイス専用のトランスポート
+        SPIDeviceConfig applied;                   ///< トランスポートに適用済みの設定
+    };
+
+    /**
+     * @brief CS・DCピンが一致するデバイスを検索（未登録の場合は専用のトランスポートを作成して登録）
+     *
+     * @param device_config デバイス設定
+     * @return Device* デバイス（トランスポートを作成できない場合はnullptr）
+     */
+    Device* findDevice(const SPIDeviceConfig& device_config);
+
+    /**
+     * @brief 設定の差分だけをトランスポートに適用
+     *
+     * @param device デバイス
+     * @param device_config デバイス設定
+     */
+    void applyConfig(Device& device, const SPIDeviceConfig& device_config);
+
+    /**
+     * @brief 保持中のCSを解除（ロック取得済みで呼び出す）
+     */
+    void releaseSelected();
+
+    /**
+     * @brief 呼び出し元のスレッドがトランザクションを保持しているか確認
+     *
+     * @return true 保持している
+     * @return false 保持していない
+     */
+    bool isOwnedByCurrentThread() const
+    {
+        return owner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    /**
+     * @brief トランザクション終了時の処理（ロック取得済みで呼び出される）
+     *
+     * @param keep_selected CSを保持するか
+     */
+    void finish(bool keep_selected);
+
+    std::shared_ptr<ISPIBus> bus_;
+    std::vector<std::unique_ptr<Device>> devices_;
+    Device* selected_   = nullptr;  ///< CSを保持しているデバイス
+    Device* last_owner_ = nullptr;  ///< 直前にバスを占有したデバイス
+    std::atomic<std::thread::id> owner_{std::thread::id()};  ///< トランザクションを保持しているスレッド
+    SPIArbiterStatistics statistics_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace flexhal
@@ -0,0 +1,195 @@
+/**
+ * @file spi_arbiter.inl
+ * @brief 共有SPIバスの調停の実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "spi_arbiter.h"
+
+namespace flexhal {
+
+// SPITransaction実装
+
+SPITransaction::SPITransaction(SPIBusArbiter* arbiter, std::unique_lock<std::mutex>&& lock, ISPITransport* transport,
+                               bool keep_selected)
+    : arbiter_(arbiter), transport_(transport), keep_selected_(keep_selected), lock_(std::move(lock))
+{
+}
+
+SPITransaction::~SPITransaction()
+{
+    end();
+}
+
+SPITransaction::SPITransaction(SPITransaction&& other) noexcept
+    : arbiter_(other.arbiter_),
+      transport_(other.transport_),
+      keep_selected_(other.keep_selected_),
+      lock_(std::move(other.lock_))
+{
+    other.arbiter_   = nullptr;
+    other.transport_ = nullptr;
+}
+
+SPITransaction& SPITransaction::operator=(SPITransaction&& other) noexcept
+{
+    if (this != &other) {
+        end();
+        arbiter_         = other.arbiter_;
+        transport_       = other.transport_;
+        keep_selected_   = other.keep_selected_;
+        lock_            = std::move(other.lock_);
+        other.arbiter_   = nullptr;
+        other.transport_ = nullptr;
+    }
+    return *this;
+}
+
+void SPITransaction::end()
+{
+    if (!arbiter_) {
+        return;
+    }
+
+    arbiter_->finish(keep_selected_);
+    arbiter_   = nullptr;
+    transport_ = nullptr;
+    if (lock_.owns_lock()) {
+        lock_.unlock();
+    }
+}
+
+// SPIBusArbiter実装
+
+SPIBusArbiter::SPIBusArbiter(std::shared_ptr<ISPIBus> bus) : bus_(std::move(bus))
+{
+}
+
+SPIBusArbiter::~SPIBusArbiter()
+{
+    deselect();
+}
+
+SPITransaction SPIBusArbiter::acquire(const SPIDeviceConfig& device_config, bool keep_selected)
+{
+    // 同じスレッドでロックを二重に取得しないよう、入れ子のトランザクションは失敗させる
+    if (isOwnedByCurrentThread()) {
+        return SPITransaction();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    Device* device = findDevice(device_config);
+    if (!device) {
+        return SPITransaction();
+    }
+
+    // 別のデバイスがCSを保持していれば先に解除する
+    if (selected_ && selected_ != device) {
+        releaseSelected();
+    }
+    if (last_owner_ != device) {
+        ++statistics_.owner_changes;
+        last_owner_ = device;
+    }
+
+    applyConfig(*device, device_config);
+
+    if (selected_ == device) {
+        ++statistics_.cs_reuses;
+    } else if (device->transport->setCSHold(true)) {
+        selected_ = device;
+    }
+
+    ++statistics_.transactions;
+    owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    return SPITransaction(this, std::move(lock), device->transport.get(), keep_selected);
+}
+
+bool SPIBusArbiter::deselect()
+{
+    // トランザクションを保持したスレッドからはロックを取得できない
+    if (isOwnedByCurrentThread()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseSelected();
+    return true;
+}
+
+SPIArbiterStatistics SPIBusArbiter::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void SPIBusArbiter::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_ = SPIArbiterStatistics();
+}
+
+SPIBusArbiter::Device* SPIBusArbiter::findDevice(const SPIDeviceConfig& device_config)
+{
+    for (auto& device : devices_) {
+        if (device->applied.cs_pin == device_config.cs_pin && device->applied.dc_pin == device_config.dc_pin) {
+            return device.get();
+        }
+    }
+
+    if (!bus_) {
+        return nullptr;
+    }
+    // キャッシュで共有されたトランスポートは他の利用者が設定を変更するため、適用済みの設定と一致しなくなる
+    auto transport = bus_->createTransport(device_config);
+    if (!transport || !transport->begin()) {
+        return nullptr;
+    }
+
+    devices_.push_back(std::unique_ptr<Device>(new Device{transport, device_config}));
+    return devices_.back().get();
+}
+
+void SPIBusArbiter::applyConfig(Device& device, const SPIDeviceConfig& device_config)
+{
+    bool changed = false;
+    if (device.applied.clock_hz != device_config.clock_hz) {
+        device.transport->setClockFrequency(device_config.clock_hz);
+        changed = true;
+    }
+    if (device.applied.mode != device_config.mode) {
+        device.transport->setMode(device_config.mode);
+        changed = true;
+    }
+    if (device.applied.bit_order != device_config.bit_order) {
+        device.transport->setLSBFirst(device_config.bit_order == SPIBitOrder::LSBFirst);
+        changed = true;
+    }
+
+    if (changed) {
+        device.applied = device_config;
+        ++statistics_.reconfigurations;
+    }
+}
+
+void SPIBusArbiter::releaseSelected()
+{
+    if (selected_) {
+        selected_->transport->setCSHold(false);
+        selected_ = nullptr;
+    }
+}
+
+void SPIBusArbiter::finish(bool keep_selected)
+{
+    owner_.store(std::thread::id(), std::memory_order_relaxed);
+    if (!keep_selected) {
+        releaseSelected();
+    }
+}
+
+}  // namespace flexhal
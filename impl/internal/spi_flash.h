@@ -0,0 +1,356 @@
+/**
+ * @file spi_flash.h
+ * @brief SPI NORフラッシュドライバとページキャッシュの定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "spi.h"
+
+namespace flexhal {
+
+/**
+ * @brief SPI NORフラッシュドライバ
+ *
+ * 一般的なシリアルフラッシュ（W25Qシリーズ相当）を ISPITransport 経由で操作する。
+ * コマンド・アドレスとデータはスキャッター・ギャザー転送で1回のCSアクティブ期間に送受信する。
+ * アドレスは3バイトで送るため、16MBを超えるデバイスは先頭の16MBだけを扱う
+ */
+class SPIFlash {
+public:
+    static constexpr uint8_t CMD_READ_JEDEC_ID = 0x9F;
+    static constexpr uint8_t CMD_READ_STATUS   = 0x05;
+    static constexpr uint8_t CMD_WRITE_ENABLE  = 0x06;
+    static constexpr uint8_t CMD_FAST_READ     = 0x0B;
+    static constexpr uint8_t CMD_PAGE_PROGRAM  = 0x02;
+    static constexpr uint8_t CMD_SECTOR_ERASE  = 0x20;
+
+    static constexpr uint8_t STATUS_BUSY = 0x01;  ///< 書き込み・消去中
+
+    static constexpr size_t PAGE_SIZE   = 256;
+    static constexpr size_t SECTOR_SIZE = 4096;
+
+    /**
+     * @brief read() に渡せる区間数の上限
+     */
+    static constexpr size_t MAX_READ_SEGMENTS = 16;
+
+    /**
+     * @brief 3バイトアドレスで扱える容量の上限
+     */
+    static constexpr size_t MAX_ADDRESSABLE_SIZE = static_cast<size_t>(1) << 24;
+
+    static constexpr uint32_t PROGRAM_TIMEOUT_MS = 10;
+    static constexpr uint32_t ERASE_TIMEOUT_MS   = 500;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param transport フラッシュに接続されたSPIトランスポート
+     */
+    explicit SPIFlash(std::shared_ptr<ISPITransport> transport);
+
+    /**
+     * @brief 初期化（JEDEC IDを読み取って容量を判定）
+     *
+     * @return true 初期化成功
+     * @return false デバイスが応答しない
+     */
+    bool begin();
+
+    /**
+     * @brief JEDEC IDを取得
+     *
+     * @return uint32_t JEDEC ID（製造者ID・メモリタイプ・容量の3バイト）
+     */
+    uint32_t getJEDECID() const
+    {
+        return jedec_id_;
+    }
+
+    /**
+     * @brief 容量を取得
+     *
+     * @return size_t 容量（バイト、MAX_ADDRESSABLE_SIZE まで）
+     */
+    size_t getSize() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief データを読み込み（FAST_READ）
+     *
+     * @param address 読み込み開始アドレス
+     * @param data 読み込み先バッファ
+     * @param length 読み込むバイト数
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool read(uint32_t address, void* data, size_t length);
+
+    /**
+     * @brief 連続した領域を1回の転送で複数のバッファに読み込み
+     *
+     * 各区間の rx_data に、アドレス順に連続したデータを格納する
+     *
+     * @param address 読み込み開始アドレス
+     * @param segments 区間の配列（MAX_READ_SEGMENTS以下）
+     * @param count 区間数
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool read(uint32_t address, const TransferSegment* segments, size_t count);
+
+    /**
+     * @brief ページ内にデータを書き込み（消去は行わない）
+     *
+     * @param address 書き込み開始アドレス
+     * @param data 書き込むデータ
+     * @param length データ長（ページ境界を越えないこと）
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool programPage(uint32_t address, const void* data, size_t length);
+
+    /**
+     * @brief データを書き込み（ページ境界で分割する。消去は行わない）
+     *
+     * @param address 書き込み開始アドレス
+     * @param data 書き込むデータ
+     * @param length データ長
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool write(uint32_t address, const void* data, size_t length);
+
+    /**
+     * @brief セクタを消去
+     *
+     * @param address セクタ内のアドレス
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool eraseSector(uint32_t address);
+
+    /**
+     * @brief ステータスレジスタを読み込み
+     *
+     * @return uint8_t ステータス
+     */
+    uint8_t readStatus();
+
+    /**
+     * @brief 書き込み・消去の完了を待機
+     *
+     * @param timeout_ms タイムアウト（ミリ秒）
+     * @return true 完了
+     * @return false タイムアウト
+     */
+    bool waitReady(uint32_t timeout_ms);
+
+private:
+    /**
+     * @brief 書き込みを許可
+     *
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool writeEnable();
+
+    /**
+     * @brief コマンドとアドレスのヘッダを作成
+     *
+     * @param header 格納先（4バイト以上）
+     * @param command コマンド
+     * @param address アドレス
+     */
+    static void setHeader(uint8_t* header, uint8_t command, uint32_t address);
+
+    /**
+     * @brief 範囲が容量内か確認
+     *
+     * @param address 先頭アドレス
+     * @param length バイト数
+     * @return true 容量内
+     * @return false 容量外（初期化前を含む）
+     */
+    bool isInRange(uint32_t address, size_t length) const
+    {
+        return address < size_ && length <= size_ - address;
+    }
+
+    std::shared_ptr<ISPITransport> transport_;
+    uint32_t jedec_id_ = 0;
+    size_t size_       = 0;
+};
+
+/**
+ * @brief SPIフラッシュのページキャッシュの統計情報
+ */
+struct SPIFlashCacheStatistics {
+    uint64_t hits             = 0;  ///< キャッシュから読み込んだページ数
+    uint64_t misses           = 0;  ///< フラッシュから読み込んだページ数（先読みを除く）
+    uint64_t read_ahead_pages = 0;  ///< 先読みしたページ数
+    uint64_t read_commands    = 0;  ///< 発行した読み込みコマンド数
+    uint64_t program_commands = 0;  ///< 発行したページプログラムコマンド数
+    uint64_t coalesced_writes = 0;  ///< 書き戻し前のページにまとめられた書き込み数
+};
+
+/**
+ * @brief SPIフラッシュのページキャッシュ
+ *
+ * ページ単位のLRUキャッシュ。連続したページへのミスを検出すると後続のページをまとめて
+ * 先読みし、キャッシュの各スロットへ1回のコマンドで直接読み込む。
+ * 書き込みはキャッシュ上のページに反映して書き戻しを遅延し、同じページへの部分的な書き込みを
+ * 1回のページプログラムにまとめる。書き込みはフラッシュと同じく消去済みのビットを0にするだけで、
+ * 書き戻し時はページ内で変更された範囲をプログラムする
+ */
+class SPIFlashCache {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param flash 初期化済みのフラッシュドライバ
+     * @param page_count キャッシュするページ数
+     * @param read_ahead_pages 連続アクセス時に先読みするページ数（0で先読みしない）
+     */
+    explicit SPIFlashCache(std::shared_ptr<SPIFlash> flash, size_t page_count = 16, size_t read_ahead_pages = 4);
+
+    /**
+     * @brief デストラクタ（未書き戻しのページを書き戻す）
+     */
+    ~SPIFlashCache();
+
+    SPIFlashCache(const SPIFlashCache&)            = delete;
+    SPIFlashCache& operator=(const SPIFlashCache&) = delete;
+
+    /**
+     * @brief データを読み込み
+     *
+     * @param address 読み込み開始アドレス
+     * @param data 読み込み先バッファ
+     * @param length 読み込むバイト数
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool read(uint32_t address, void* data, size_t length);
+
+    /**
+     * @brief データを書き込み（書き戻しは flush() またはページの追い出し時）
+     *
+     * @param address 書き込み開始アドレス
+     * @param data 書き込むデータ
+     * @param length データ長
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool write(uint32_t address, const void* data, size_t length);
+
+    /**
+     * @brief セクタを消去（キャッシュ上の同じセクタのページも消去済みにする）
+     *
+     * 消去に失敗した場合、キャッシュ上のページと未書き戻しの内容はそのまま残る
+     *
+     * @param address セクタ内のアドレス
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool eraseSector(uint32_t address);
+
+    /**
+     * @brief 未書き戻しのページをすべて書き戻す
+     *
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool flush();
+
+    /**
+     * @brief キャッシュを破棄（未書き戻しのページは書き戻す）
+     *
+     * @return true 成功
+     * @return false 書き戻しに失敗
+     */
+    bool invalidate();
+
+    /**
+     * @brief 統計情報を取得
+     *
+     * @return SPIFlashCacheStatistics 統計情報
+     */
+    SPIFlashCacheStatistics getStatistics() const;
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics();
+
+private:
+    static constexpr uint32_t NO_PAGE = 0xFFFFFFFF;
+
+    /**
+     * @brief キャッシュスロット
+     */
+    struct Slot {
+        uint32_t page      = NO_PAGE;  ///< ページ番号
+        uint64_t last_used = 0;
+        size_t dirty_begin = 0;  ///< 未書き戻し範囲の先頭（ページ内オフセット）
+        size_t dirty_end   = 0;  ///< 未書き戻し範囲の末尾（dirty_begin と同じなら書き戻し不要）
+        uint8_t* data      = nullptr;
+    };
+
+    /**
+     * @brief ページを取得（キャッシュにない場合は読み込み、連続アクセスなら先読みする）
+     *
+     * @param page ページ番号
+     * @return Slot* スロット（容量外のページ、または読み込みに失敗した場合はnullptr）
+     */
+    Slot* getPage(uint32_t page);
+
+    /**
+     * @brief キャッシュ上のページを検索
+     *
+     * @param page ページ番号
+     * @return Slot* スロット（キャッシュにない場合はnullptr）
+     */
+    Slot* findPage(uint32_t page);
+
+    /**
+     * @brief 空きスロットを確保（必要なら最も古いページを書き戻して追い出す）
+     *
+     * @return Slot* スロット（書き戻しに失敗した場合はnullptr）
+     */
+    Slot* allocateSlot();
+
+    /**
+     * @brief スロットを書き戻す
+     *
+     * @param slot スロット
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool writeBack(Slot& slot);
+
+    std::shared_ptr<SPIFlash> flash_;
+    std::vector<uint8_t> storage_;
+    std::vector<Slot> slots_;
+    std::unordered_map<uint32_t, size_t> index_;  ///< ページ番号からスロットへの索引
+    size_t read_ahead_pages_;
+    uint32_t last_miss_page_ = NO_PAGE;
+    uint64_t tick_           = 0;
+    SPIFlashCacheStatistics statistics_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace flexhal
@@ -0,0 +1,430 @@
+/**
+ * @file spi_flash.inl
+ * @brief SPI NORフラッシュドライバとページキャッシュの実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "spi_flash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace flexhal {
+
+// SPIFlash実装
+
+SPIFlash::SPIFlash(std::shared_ptr<ISPITransport> transport) : transport_(std::move(transport))
+{
+}
+
+bool SPIFlash::begin()
+{
+    if (!transport_ || !transport_->begin()) {
+        return false;
+    }
+
+    uint8_t tx[4] = {CMD_READ_JEDEC_ID, 0xFF, 0xFF, 0xFF};
+    uint8_t rx[4] = {0, 0, 0, 0};
+    if (transport_->transfer(tx, rx, sizeof(tx)) != static_cast<ssize_t>(sizeof(tx))) {
+        return false;
+    }
+
+    jedec_id_ = (static_cast<uint32_t>(rx[1]) << 16) | (static_cast<uint32_t>(rx[2]) << 8) | rx[3];
+    if (jedec_id_ == 0 || jedec_id_ == 0xFFFFFF) {
+        return false;
+    }
+
+    // 容量バイトは2のべき乗の指数（0x16 = 4MB）。3バイトアドレスで届かない領域は扱わない
+    uint8_t capacity = rx[3];
+    size_            = (capacity >= 10 && capacity < 32) ? static_cast<size_t>(1) << capacity : 0;
+    size_            = std::min(size_, MAX_ADDRESSABLE_SIZE);
+    return size_ > 0;
+}
+
+bool SPIFlash::read(uint32_t address, void* data, size_t length)
+{
+    TransferSegment segment;
+    segment.rx_data = data;
+    segment.length  = length;
+    return read(address, &segment, 1);
+}
+
+bool SPIFlash::read(uint32_t address, const TransferSegment* segments, size_t count)
+{
+    if (!transport_ || count > MAX_READ_SEGMENTS) {
+        return false;
+    }
+
+    // コマンド・アドレス・ダミーバイトに続けて、各区間へ直接受信する
+    uint8_t header[5];
+    setHeader(header, CMD_FAST_READ, address);
+    header[4] = 0xFF;
+
+    TransferSegment local[MAX_READ_SEGMENTS + 1];
+    local[0].tx_data = header;
+    local[0].length  = sizeof(header);
+    size_t total     = sizeof(header);
+    for (size_t i = 0; i < count; ++i) {
+        local[i + 1].rx_data = segments[i].rx_data;
+        local[i + 1].length  = segments[i].length;
+        total += segments[i].length;
+    }
+    if (!isInRange(address, total - sizeof(header))) {
+        return false;
+    }
+
+    return transport_->transferv(local, count + 1) == static_cast<ssize_t>(total);
+}
+
+bool SPIFlash::programPage(uint32_t address, const void* data, size_t length)
+{
+    if (!transport_ || !data || length == 0 || (address % PAGE_SIZE) + length > PAGE_SIZE ||
+        !isInRange(address, length)) {
+        return false;
+    }
+    if (!writeEnable()) {
+        return false;
+    }
+
+    uint8_t header[4];
+    setHeader(header, CMD_PAGE_PROGRAM, address);
+
+    TransferSegment segments[2];
+    segments[0].tx_data = header;
+    segments[0].length  = sizeof(header);
+    segments[1].tx_data = data;
+    segments[1].length  = length;
+    if (transport_->writev(segments, 2) != static_cast<ssize_t>(sizeof(header) + length)) {
+        return false;
+    }
+
+    return waitReady(PROGRAM_TIMEOUT_MS);
+}
+
+bool SPIFlash::write(uint32_t address, const void* data, size_t length)
+{
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        size_t chunk = std::min(length, PAGE_SIZE - address % PAGE_SIZE);
+        if (!programPage(address, src, chunk)) {
+            return false;
+        }
+        address += static_cast<uint32_t>(chunk);
+        src += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+bool SPIFlash::eraseSector(uint32_t address)
+{
+    if (!transport_ || !isInRange(address, 1) || !writeEnable()) {
+        return false;
+    }
+
+    uint8_t header[4];
+    setHeader(header, CMD_SECTOR_ERASE, address);
+    if (transport_->write(header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+        return false;
+    }
+
+    return waitReady(ERASE_TIMEOUT_MS);
+}
+
+uint8_t SPIFlash::readStatus()
+{
+    uint8_t tx[2] = {CMD_READ_STATUS, 0xFF};
+    uint8_t rx[2] = {0xFF, 0xFF};
+    if (!transport_ || transport_->transfer(tx, rx, sizeof(tx)) != static_cast<ssize_t>(sizeof(tx))) {
+        return 0xFF;
+    }
+    return rx[1];
+}
+
+bool SPIFlash::waitReady(uint32_t timeout_ms)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (;;) {
+        if (!(readStatus() & STATUS_BUSY)) {
+            return true;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool SPIFlash::writeEnable()
+{
+    uint8_t command = CMD_WRITE_ENABLE;
+    return transport_->write(&command, 1) == 1;
+}
+
+void SPIFlash::setHeader(uint8_t* header, uint8_t command, uint32_t address)
+{
+    header[0] = command;
+    header[1] = static_cast<uint8_t>(address >> 16);
+    header[2] = static_cast<uint8_t>(address >> 8);
+    header[3] = static_cast<uint8_t>(address);
+}
+
+// SPIFlashCache実装
+
+SPIFlashCache::SPIFlashCache(std::shared_ptr<SPIFlash> flash, size_t page_count, size_t read_ahead_pages)
+    : flash_(std::move(flash)), read_ahead_pages_(read_ahead_pages)
+{
+    if (page_count < 1) {
+        page_count = 1;
+    }
+
+    // 全スロットの領域をまとめて確保する
+    storage_.resize(page_count * SPIFlash::PAGE_SIZE);
+    slots_.resize(page_count);
+    for (size_t i = 0; i < page_count; ++i) {
+        slots_[i].data = storage_.data() + i * SPIFlash::PAGE_SIZE;
+    }
+    index_.reserve(page_count);
+}
+
+SPIFlashCache::~SPIFlashCache()
+{
+    flush();
+}
+
+bool SPIFlashCache::read(uint32_t address, void* data, size_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint8_t* dst = static_cast<uint8_t*>(data);
+    while (length > 0) {
+        uint32_t page = address / SPIFlash::PAGE_SIZE;
+        size_t offset = address % SPIFlash::PAGE_SIZE;
+        size_t chunk  = std::min(length, SPIFlash::PAGE_SIZE - offset);
+
+        Slot* slot = getPage(page);
+        if (!slot) {
+            return false;
+        }
+        std::memcpy(dst, slot->data + offset, chunk);
+
+        address += static_cast<uint32_t>(chunk);
+        dst += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+bool SPIFlashCache::write(uint32_t address, const void* data, size_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        uint32_t page = address / SPIFlash::PAGE_SIZE;
+        size_t offset = address % SPIFlash::PAGE_SIZE;
+        size_t chunk  = std::min(length, SPIFlash::PAGE_SIZE - offset);
+
+        Slot* slot = getPage(page);
+        if (!slot) {
+            return false;
+        }
+
+        // フラッシュと同じく1のビットを0にするだけ
+        for (size_t i = 0; i < chunk; ++i) {
+            slot->data[offset + i] &= src[i];
+        }
+
+        // 未書き戻しの範囲を広げてまとめる
+        if (slot->dirty_begin < slot->dirty_end) {
+            slot->dirty_begin = std::min(slot->dirty_begin, offset);
+            slot->dirty_end   = std::max(slot->dirty_end, offset + chunk);
+            ++statistics_.coalesced_writes;
+        } else {
+            slot->dirty_begin = offset;
+            slot->dirty_end   = offset + chunk;
+        }
+
+        address += static_cast<uint32_t>(chunk);
+        src += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+bool SPIFlashCache::eraseSector(uint32_t address)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!flash_->eraseSector(address)) {
+        // 消去できなかった場合は、未書き戻しの内容を失わないようキャッシュをそのまま残す
+        return false;
+    }
+
+    // 消去されたページの未書き戻しの内容は不要になる
+    uint32_t first = (address / SPIFlash::SECTOR_SIZE) * (SPIFlash::SECTOR_SIZE / SPIFlash::PAGE_SIZE);
+    uint32_t last  = first + SPIFlash::SECTOR_SIZE / SPIFlash::PAGE_SIZE;
+    for (auto& slot : slots_) {
+        if (slot.page != NO_PAGE && slot.page >= first && slot.page < last) {
+            std::memset(slot.data, 0xFF, SPIFlash::PAGE_SIZE);
+            slot.dirty_begin = slot.dirty_end = 0;
+        }
+    }
+    return true;
+}
+
+bool SPIFlashCache::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // アドレス順に書き戻す
+    std::vector<Slot*> dirty;
+    for (auto& slot : slots_) {
+        if (slot.dirty_begin < slot.dirty_end) {
+            dirty.push_back(&slot);
+        }
+    }
+    std::sort(dirty.begin(), dirty.end(), [](const Slot* a, const Slot* b) { return a->page < b->page; });
+
+    bool result = true;
+    for (Slot* slot : dirty) {
+        result = writeBack(*slot) && result;
+    }
+    return result;
+}
+
+bool SPIFlashCache::invalidate()
+{
+    bool result = flush();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_) {
+        slot.page        = NO_PAGE;
+        slot.dirty_begin = slot.dirty_end = 0;
+    }
+    index_.clear();
+    last_miss_page_ = NO_PAGE;
+    return result;
+}
+
+SPIFlashCacheStatistics SPIFlashCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void SPIFlashCache::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_ = SPIFlashCacheStatistics();
+}
+
+SPIFlashCache::Slot* SPIFlashCache::getPage(uint32_t page)
+{
+    if (Slot* slot = findPage(page)) {
+        slot->last_used = ++tick_;
+        ++statistics_.hits;
+        return slot;
+    }
+
+    uint32_t page_count = static_cast<uint32_t>(flash_->getSize() / SPIFlash::PAGE_SIZE);
+    if (page >= page_count) {
+        return nullptr;
+    }
+    ++statistics_.misses;
+
+    // 直前のミスの次のページなら連続アクセスとみなして先読みする（容量の末尾を越えない）
+    size_t window = 1;
+    if (read_ahead_pages_ > 0 && last_miss_page_ != NO_PAGE && page == last_miss_page_ + 1) {
+        window = std::min(1 + read_ahead_pages_, std::min(SPIFlash::MAX_READ_SEGMENTS, slots_.size()));
+        window = std::min<size_t>(window, page_count - page);
+        for (size_t i = 1; i < window; ++i) {
+            if (findPage(page + static_cast<uint32_t>(i))) {
+                window = i;
+                break;
+            }
+        }
+    }
+
+    // スロットを確保してから、各スロットへ1回のコマンドで読み込む
+    Slot* targets[SPIFlash::MAX_READ_SEGMENTS];
+    TransferSegment segments[SPIFlash::MAX_READ_SEGMENTS];
+    for (size_t i = 0; i < window; ++i) {
+        Slot* slot = allocateSlot();
+        if (!slot) {
+            window = i;
+            break;
+        }
+        slot->page         = page + static_cast<uint32_t>(i);
+        slot->last_used    = ++tick_;
+        index_[slot->page] = static_cast<size_t>(slot - slots_.data());
+
+        targets[i]          = slot;
+        segments[i].rx_data = slot->data;
+        segments[i].length  = SPIFlash::PAGE_SIZE;
+    }
+    if (window == 0) {
+        return nullptr;
+    }
+
+    ++statistics_.read_commands;
+    if (!flash_->read(page * static_cast<uint32_t>(SPIFlash::PAGE_SIZE), segments, window)) {
+        for (size_t i = 0; i < window; ++i) {
+            index_.erase(targets[i]->page);
+            targets[i]->page = NO_PAGE;
+        }
+        return nullptr;
+    }
+
+    statistics_.read_ahead_pages += window - 1;
+    last_miss_page_ = page + static_cast<uint32_t>(window) - 1;
+    return targets[0];
+}
+
+SPIFlashCache::Slot* SPIFlashCache::findPage(uint32_t page)
+{
+    auto it = index_.find(page);
+    return it != index_.end() ? &slots_[it->second] : nullptr;
+}
+
+SPIFlashCache::Slot* SPIFlashCache::allocateSlot()
+{
+    Slot* victim = nullptr;
+    for (auto& slot : slots_) {
+        if (slot.page == NO_PAGE) {
+            return &slot;
+        }
+        if (!victim || slot.last_used < victim->last_used) {
+            victim = &slot;
+        }
+    }
+
+    if (!writeBack(*victim)) {
+        return nullptr;
+    }
+    index_.erase(victim->page);
+    victim->page = NO_PAGE;
+    return victim;
+}
+
+bool SPIFlashCache::writeBack(Slot& slot)
+{
+    if (slot.dirty_begin >= slot.dirty_end) {
+        return true;
+    }
+
+    // 範囲内の書き込まれていないバイトは現在の値のままなので、まとめてプログラムしても内容は変わらない
+    uint32_t address = slot.page * static_cast<uint32_t>(SPIFlash::PAGE_SIZE) + static_cast<uint32_t>(slot.dirty_begin);
+    ++statistics_.program_commands;
+    if (!flash_->programPage(address, slot.data + slot.dirty_begin, slot.dirty_end - slot.dirty_begin)) {
+        return false;
+    }
+    slot.dirty_begin = slot.dirty_end = 0;
+    return true;
+}
+
+}  // namespace flexhal
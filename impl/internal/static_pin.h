@@ -0,0 +1,146 @@
+/**
+ * @file static_pin.h
+ * @brief コンパイル時ピン番号指定のピン定義
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include "core.h"
+#include "pin.h"
+
+namespace flexhal {
+
+/**
+ * @brief コンパイル時にピン番号とバックエンドを決定するピン
+ *
+ * すべての操作はバックエンドの静的関数へ直接展開されるため、仮想関数呼び出しや
+ * shared_ptrの参照カウント操作が発生しない。ビットバンギングなど、ピン操作の回数が
+ * 非常に多い処理で使用する。
+ *
+ * バックエンドは以下の静的関数を提供する必要がある：
+ * - static void setMode(int pin_number, PinMode mode)
+ * - static void setLevel(int pin_number, PinLevel level)
+ * - static PinLevel getLevel(int pin_number)
+ *
+ * @tparam PinNumber ピン番号
+ * @tparam Backend ピン操作バックエンド
+ */
+template <int PinNumber, class Backend>
+class StaticPin {
+public:
+    static_assert(PinNumber >= 0, "PinNumber must not be negative");
+
+    /**
+     * @brief ピン番号
+     */
+    static constexpr int PIN_NUMBER = PinNumber;
+
+    /**
+     * @brief ピンモードを設定
+     *
+     * @param mode 設定するモード
+     */
+    static void setMode(PinMode mode)
+    {
+        Backend::setMode(PinNumber, mode);
+    }
+
+    /**
+     * @brief ピンレベルを設定
+     *
+     * @param level 設定するレベル
+     */
+    static void setLevel(PinLevel level)
+    {
+        Backend::setLevel(PinNumber, level);
+    }
+
+    /**
+     * @brief ピンをHighに設定
+     */
+    static void setHigh()
+    {
+        Backend::setLevel(PinNumber, PinLevel::High);
+    }
+
+    /**
+     * @brief ピンをLowに設定
+     */
+    static void setLow()
+    {
+        Backend::setLevel(PinNumber, PinLevel::Low);
+    }
+
+    /**
+     * @brief ピンレベルを取得
+     *
+     * @return PinLevel 現在のレベル
+     */
+    static PinLevel getLevel()
+    {
+        return Backend::getLevel(PinNumber);
+    }
+
+    /**
+     * @brief ピン番号を取得
+     *
+     * @return int ピン番号
+     */
+    static constexpr int getPinNumber()
+    {
+        return PinNumber;
+    }
+
+    /**
+     * @brief IPinとして扱うためのアダプタを作成
+     *
+     * 型消去が必要な箇所（SPIPinPortなど）に渡す場合に使用する
+     *
+     * @return std::shared_ptr<IPin> ピンインスタンス
+     */
+    static std::shared_ptr<IPin> toPin();
+};
+
+/**
+ * @brief StaticPinをIPinとして扱うアダプタ
+ *
+ * @tparam PinNumber ピン番号
+ * @tparam Backend ピン操作バックエンド
+ */
+template <int PinNumber, class Backend>
+class StaticPinAdapter final : public IPin {
+public:
+    void setMode(PinMode mode) override
+    {
+        StaticPin<PinNumber, Backend>::setMode(mode);
+    }
+
+    void setLevel(PinLevel level) override
+    {
+        StaticPin<PinNumber, Backend>::setLevel(level);
+    }
+
+    PinLevel getLevel() const override
+    {
+        return StaticPin<PinNumber, Backend>::getLevel();
+    }
+
+    int getPinNumber() const override
+    {
+        return PinNumber;
+    }
+};
+
+template <int PinNumber, class Backend>
+std::shared_ptr<IPin> StaticPin<PinNumber, Backend>::toPin()
+{
+    return std::make_shared<StaticPinAdapter<PinNumber, Backend>>();
+}
+
+}  // namespace flexhal
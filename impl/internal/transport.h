@@ -12,10 +12,23 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
+#include <vector>
+#include <sys/types.h>
+#include "async_transfer.h"
 #include "device.h"
 
 namespace flexhal {
 
+/**
+ * @brief スキャッター・ギャザー転送のバッファ区間
+ */
+struct TransferSegment {
+    const void* tx_data = nullptr;  ///< 送信データ（nullptrの場合は0xFFを送信）
+    void* rx_data       = nullptr;  ///< 受信データ（nullptrの場合は受信データを捨てる）
+    size_t length       = 0;        ///< データ長
+};
+
 /**
  * @brief トランスポートインターフェース
  *
@@ -56,10 +69,158 @@ public:
     /**
      * @brief 非同期操作をサポートしているか確認
      *
+     * サポートしていない場合も writeAsync() などは使用でき、同期実行して完了済みのトークンを返す
+     *
      * @return true サポートしている
      * @return false サポートしていない
      */
     virtual bool supportsAsync() const = 0;
+
+    /**
+     * @brief 非同期データ書き込み
+     *
+     * @param data 書き込むデータ（完了まで保持すること）
+     * @param length データ長
+     * @return TransferToken 完了トークン（結果は書き込んだバイト数）
+     */
+    virtual TransferToken writeAsync(const void* data, size_t length)
+    {
+        return TransferToken::completed(write(data, length));
+    }
+
+    /**
+     * @brief 非同期データ読み込み
+     *
+     * @param data 読み込み先バッファ（完了まで保持すること）
+     * @param length 読み込むバイト数
+     * @return TransferToken 完了トークン（結果は読み込んだバイト数）
+     */
+    virtual TransferToken readAsync(void* data, size_t length)
+    {
+        return TransferToken::completed(read(data, length));
+    }
+
+    /**
+     * @brief 非同期データ送受信
+     *
+     * @param tx_data 送信データ（完了まで保持すること）
+     * @param rx_data 受信データ（完了まで保持すること）
+     * @param length データ長
+     * @return TransferToken 完了トークン（結果は転送したバイト数）
+     */
+    virtual TransferToken transferAsync(const void* tx_data, void* rx_data, size_t length)
+    {
+        return TransferToken::completed(transfer(tx_data, rx_data, length));
+    }
+
+    /**
+     * @brief 複数区間のデータを1回の転送で書き込み
+     *
+     * 各区間の tx_data を順に連結したデータを書き込む。
+     * 既定の実装は一時バッファに連結して write() を1回呼び出す
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return ssize_t 書き込んだバイト数（負の値はエラー）
+     */
+    virtual ssize_t writev(const TransferSegment* segments, size_t count)
+    {
+        if (count == 1) {
+            return write(segments[0].tx_data, segments[0].length);
+        }
+        std::vector<uint8_t> buffer;
+        gatherSegments(segments, count, buffer);
+        return write(buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief 1回の転送で読み込んだデータを複数区間に格納
+     *
+     * 既定の実装は一時バッファに read() を1回呼び出して各区間の rx_data に分配する
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return ssize_t 読み込んだバイト数（負の値はエラー）
+     */
+    virtual ssize_t readv(const TransferSegment* segments, size_t count)
+    {
+        if (count == 1) {
+            return read(segments[0].rx_data, segments[0].length);
+        }
+        std::vector<uint8_t> buffer(getSegmentsLength(segments, count));
+        ssize_t result = read(buffer.data(), buffer.size());
+        scatterSegments(segments, count, buffer, result);
+        return result;
+    }
+
+    /**
+     * @brief 複数区間のデータを1回の転送で送受信
+     *
+     * 既定の実装は一時バッファに連結して transfer() を1回呼び出し、受信データを各区間に分配する
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return ssize_t 転送したバイト数（負の値はエラー）
+     */
+    virtual ssize_t transferv(const TransferSegment* segments, size_t count)
+    {
+        if (count == 1) {
+            return transfer(segments[0].tx_data, segments[0].rx_data, segments[0].length);
+        }
+        std::vector<uint8_t> tx_buffer;
+        gatherSegments(segments, count, tx_buffer);
+        std::vector<uint8_t> rx_buffer(tx_buffer.size());
+        ssize_t result = transfer(tx_buffer.data(), rx_buffer.data(), tx_buffer.size());
+        scatterSegments(segments, count, rx_buffer, result);
+        return result;
+    }
+
+protected:
+    /**
+     * @brief 全区間の合計データ長を取得
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return size_t 合計データ長
+     */
+    static size_t getSegmentsLength(const TransferSegment* segments, size_t count)
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += segments[i].length;
+        }
+        return total;
+    }
+
+private:
+    static void gatherSegments(const TransferSegment* segments, size_t count, std::vector<uint8_t>& buffer)
+    {
+        buffer.resize(getSegmentsLength(segments, count));
+        size_t offset = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (segments[i].tx_data) {
+                std::memcpy(buffer.data() + offset, segments[i].tx_data, segments[i].length);
+            } else {
+                std::memset(buffer.data() + offset, 0xFF, segments[i].length);
+            }
+            offset += segments[i].length;
+        }
+    }
+
+    static void scatterSegments(const TransferSegment* segments, size_t count, const std::vector<uint8_t>& buffer,
+                                ssize_t received)
+    {
+        size_t remaining = received > 0 ? static_cast<size_t>(received) : 0;
+        size_t offset    = 0;
+        for (size_t i = 0; i < count && remaining > 0; ++i) {
+            size_t length = segments[i].length < remaining ? segments[i].length : remaining;
+            if (segments[i].rx_data) {
+                std::memcpy(segments[i].rx_data, buffer.data() + offset, length);
+            }
+            offset += length;
+            remaining -= length;
+        }
+    }
 };
 
 }  // namespace flexhal
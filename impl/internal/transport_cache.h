@@ -0,0 +1,206 @@
+/**
+ * @file transport_cache.h
+ * @brief バスごとのトランスポートキャッシュ
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace flexhal {
+
+/**
+ * @brief トランスポートキャッシュの統計情報
+ */
+struct TransportCacheStatistics {
+    uint64_t hits      = 0;  ///< キャッシュから返した回数
+    uint64_t misses    = 0;  ///< 新しく作成した回数
+    uint64_t evictions = 0;  ///< キャッシュから追い出した回数
+};
+
+/**
+ * @brief トランスポートキャッシュ
+ *
+ * デバイス設定をキーにトランスポートを保持し、同じ設定での取得には同じインスタンスを返す。
+ * 容量を超えた場合は、キャッシュ以外から参照されていないエントリを最も古く使われたものから
+ * 追い出す。すべてのエントリが使用中の場合は容量を超えて保持する。
+ * ヒット時はヒープ確保を行わない。
+ *
+ * @tparam Key キーの型（==で比較可能であること）
+ * @tparam Transport トランスポートの型
+ */
+template <typename Key, typename Transport>
+class TransportCache {
+public:
+    /**
+     * @brief デフォルトの容量
+     */
+    static constexpr size_t DEFAULT_CAPACITY = 8;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param capacity 容量
+     */
+    explicit TransportCache(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity)
+    {
+        entries_.reserve(capacity_);
+    }
+
+    TransportCache(const TransportCache&)            = delete;
+    TransportCache& operator=(const TransportCache&) = delete;
+
+    /**
+     * @brief キャッシュからトランスポートを検索
+     *
+     * 見つからなかった場合はミスとして数える
+     *
+     * @param key キー
+     * @return std::shared_ptr<Transport> トランスポート（見つからない場合はnullptr）
+     */
+    std::shared_ptr<Transport> find(const Key& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : entries_) {
+            if (entry.key == key) {
+                entry.last_used = ++tick_;
+                ++statistics_.hits;
+                return entry.transport;
+            }
+        }
+        ++statistics_.misses;
+        return nullptr;
+    }
+
+    /**
+     * @brief トランスポートをキャッシュに追加
+     *
+     * 同じキーが他のスレッドから先に追加されていた場合は、そちらを返す
+     *
+     * @param key キー
+     * @param transport トランスポート
+     * @return std::shared_ptr<Transport> キャッシュされたトランスポート
+     */
+    std::shared_ptr<Transport> insert(const Key& key, std::shared_ptr<Transport> transport)
+    {
+        if (!transport) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : entries_) {
+            if (entry.key == key) {
+                entry.last_used = ++tick_;
+                return entry.transport;
+            }
+        }
+
+        if (entries_.size() >= capacity_) {
+            evictUnused();
+        }
+        entries_.push_back(Entry{key, transport, ++tick_});
+        return transport;
+    }
+
+    /**
+     * @brief キャッシュを空にする
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    /**
+     * @brief 容量を設定
+     *
+     * @param capacity 容量
+     */
+    void setCapacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        while (entries_.size() > capacity_ && evictUnused()) {
+        }
+        entries_.reserve(capacity_);
+    }
+
+    /**
+     * @brief キャッシュされているトランスポート数を取得
+     *
+     * @return size_t トランスポート数
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    /**
+     * @brief 統計情報を取得
+     *
+     * @return TransportCacheStatistics 統計情報
+     */
+    TransportCacheStatistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        statistics_ = TransportCacheStatistics();
+    }
+
+private:
+    struct Entry {
+        Key key;
+        std::shared_ptr<Transport> transport;
+        uint64_t last_used;
+    };
+
+    /**
+     * @brief 使用されていない最も古いエントリを追い出す
+     *
+     * @return true 追い出した
+     * @return false 追い出せるエントリがない
+     */
+    bool evictUnused()
+    {
+        size_t victim = entries_.size();
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (entries_[i].transport.use_count() == 1 &&
+                (victim == entries_.size() || entries_[i].last_used < entries_[victim].last_used)) {
+                victim = i;
+            }
+        }
+        if (victim == entries_.size()) {
+            return false;
+        }
+
+        entries_.erase(entries_.begin() + victim);
+        ++statistics_.evictions;
+        return true;
+    }
+
+    std::vector<Entry> entries_;
+    size_t capacity_;
+    uint64_t tick_ = 0;
+    TransportCacheStatistics statistics_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace flexhal
@@ -0,0 +1,205 @@
+/**
+ * @file capture.hpp
+ * @brief FlexHAL - デスクトップシミュレーション向けロジックアナライザ（ヘッダー）
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include "gpio.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace flexhal {
+namespace platform {
+namespace desktop {
+
+/**
+ * @brief シミュレーションピンの変化を記録するロジックアナライザ
+ *
+ * 記録領域はコンストラクタで確保したリングバッファのみを使用し、
+ * 記録中にメモリ確保やロックを行わない。容量を超えた場合は古いサンプルから上書きする。
+ * 記録対象のピンはピン単位のフィルタで選択し、対象外のピンの操作にはほぼ負荷を与えない。
+ */
+class SimulatedLogicAnalyzer {
+public:
+    /**
+     * @brief 記録するイベントの種類
+     */
+    enum class EventType : uint8_t {
+        Mode,  ///< モード変化
+        Level  ///< レベル変化
+    };
+
+    /**
+     * @brief 1件のサンプル
+     */
+    struct Sample {
+        uint64_t timestamp_ns;  ///< キャプチャ開始からの経過時間（ナノ秒）
+        uint16_t pin_number;    ///< ピン番号
+        EventType type;         ///< イベントの種類
+        uint8_t value;          ///< 変化後の値（PinModeまたはPinLevel）
+    };
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param table 記録対象のピン状態テーブル
+     * @param capacity 保持するサンプル数（2のべき乗に切り上げ）
+     */
+    SimulatedLogicAnalyzer(std::shared_ptr<SimulatedPinTable> table, size_t capacity = 1u << 16);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~SimulatedLogicAnalyzer();
+
+    SimulatedLogicAnalyzer(const SimulatedLogicAnalyzer&)            = delete;
+    SimulatedLogicAnalyzer& operator=(const SimulatedLogicAnalyzer&) = delete;
+
+    /**
+     * @brief ピンを記録対象に設定
+     *
+     * @param pin_number ピン番号
+     * @param enable trueで記録対象にする
+     */
+    void setFilter(int pin_number, bool enable);
+
+    /**
+     * @brief すべてのピンを記録対象に設定
+     *
+     * @param enable trueで記録対象にする
+     */
+    void setFilterAll(bool enable);
+
+    /**
+     * @brief キャプチャを開始
+     *
+     * 以前のサンプルを破棄し、記録対象ピンの現在のモードとレベルを時刻0のサンプルとして記録する。
+     * 開始に失敗した場合、以前のサンプルは残る
+     *
+     * @return true 開始成功
+     * @return false 他のロジックアナライザが記録中
+     */
+    bool start();
+
+    /**
+     * @brief キャプチャを停止
+     */
+    void stop();
+
+    /**
+     * @brief キャプチャ中か
+     *
+     * @return true キャプチャ中
+     * @return false 停止中
+     */
+    bool isRunning() const
+    {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief サンプルを記録
+     *
+     * ピン状態テーブルから呼び出される。複数スレッドから同時に呼び出してよい
+     *
+     * @param pin_number ピン番号
+     * @param type イベントの種類
+     * @param value 変化後の値
+     */
+    void record(int pin_number, EventType type, uint8_t value);
+
+    /**
+     * @brief 保持しているサンプル数を取得
+     *
+     * @return size_t サンプル数
+     */
+    size_t getSampleCount() const;
+
+    /**
+     * @brief 上書きにより失われたサンプル数を取得
+     *
+     * @return uint64_t 失われたサンプル数
+     */
+    uint64_t getOverwrittenCount() const;
+
+    /**
+     * @brief 保持しているサンプルを時刻順に取得
+     *
+     * 記録中のスレッドと競合しないよう、stop()の後に呼び出すこと
+     *
+     * @param samples 取得先
+     * @return size_t 取得したサンプル数
+     */
+    size_t getSamples(std::vector<Sample>& samples) const;
+
+    /**
+     * @brief 記録されたレベル変化からデューティ比を算出
+     *
+     * 最初と最後の立ち上がりエッジの間でHighだった時間の割合を返す。
+     * ソフトウェアPWMなどの出力を検証する用途を想定している。stop()の後に呼び出すこと
+     *
+     * @param pin_number ピン番号
+     * @return double デューティ比（0.0〜1.0、立ち上がりエッジが2つ未満の場合は負の値）
+     */
+    double getDutyCycle(int pin_number) const;
+
+    /**
+     * @brief サンプルをVCD（Value Change Dump）形式で出力
+     *
+     * ピンごとにレベル（1ビット）とモード（8ビット）の信号を出力する。stop()の後に呼び出すこと
+     *
+     * @param out 出力先
+     * @return true 出力成功
+     * @return false 出力失敗
+     */
+    bool exportVCD(std::ostream& out) const;
+
+    /**
+     * @brief サンプルをVCD形式のファイルに出力
+     *
+     * @param path 出力先ファイルパス
+     * @return true 出力成功
+     * @return false 出力失敗
+     */
+    bool exportVCD(const std::string& path) const;
+
+private:
+    /**
+     * @brief 現在時刻を取得（ナノ秒）
+     *
+     * @return uint64_t 単調増加する時刻
+     */
+    static uint64_t now();
+
+    /**
+     * @brief リングバッファにサンプルを書き込む
+     *
+     * @param timestamp キャプチャ開始からの経過時間（ナノ秒）
+     * @param pin_number ピン番号
+     * @param type イベントの種類
+     * @param value 変化後の値
+     */
+    void store(uint64_t timestamp, int pin_number, EventType type, uint8_t value);
+
+    std::shared_ptr<SimulatedPinTable> table_;
+    std::vector<Sample> buffer_;
+    size_t index_mask_;
+    uint64_t start_ns_ = 0;
+    std::atomic<bool> running_{false};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_index_{0};
+};
+
+}  // namespace desktop
+}  // namespace platform
+}  // namespace flexhal
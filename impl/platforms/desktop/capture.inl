@@ -0,0 +1,322 @@
+/**
+ * @file capture.inl
+ * @brief FlexHAL - デスクトップシミュレーション向けロジックアナライザ（実装）
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "capture.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace flexhal {
+namespace platform {
+namespace desktop {
+
+// SimulatedPinTableのキャプチャ関連実装
+
+bool SimulatedPinTable::attachLogicAnalyzer(SimulatedLogicAnalyzer* analyzer)
+{
+    SimulatedLogicAnalyzer* expected = nullptr;
+    return analyzer && analyzer_.compare_exchange_strong(expected, analyzer);
+}
+
+void SimulatedPinTable::detachLogicAnalyzer(SimulatedLogicAnalyzer* analyzer)
+{
+    SimulatedLogicAnalyzer* expected = analyzer;
+    if (!analyzer_.compare_exchange_strong(expected, nullptr)) {
+        return;
+    }
+
+    // 切断前に記録を始めたスレッドが全バンクで抜けるまで待機。
+    // 記録側の「カウンタを加算してから接続先を読む」と対になるため、カウンタの読み込みも seq_cst とする
+    // （acquire では解除より前にカウンタを読んだ順序になりえ、記録中のスレッドを見逃す）
+    for (int i = 0; i < bank_count_; ++i) {
+        while (banks_[i].capture_writers.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SimulatedPinTable::captureLevel(int pin_number, PinLevel level)
+{
+    // 未接続の間はカウンタを操作しない
+    if (!analyzer_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // カウンタはバンクごとに持ち、異なるバンクのピンを操作するスレッド同士で競合させない。
+    // 加算後の再読み込みは切断側の「解除してからカウンタを読む」と順序付ける必要があるため seq_cst とする
+    Bank& bank = banks_[pin_number / PINS_PER_BANK];
+    bank.capture_writers.fetch_add(1);
+    SimulatedLogicAnalyzer* analyzer = analyzer_.load();
+    if (analyzer) {
+        analyzer->record(pin_number, SimulatedLogicAnalyzer::EventType::Level, static_cast<uint8_t>(level));
+    }
+    bank.capture_writers.fetch_sub(1, std::memory_order_release);
+}
+
+void SimulatedPinTable::captureMode(int pin_number, PinMode mode)
+{
+    if (!analyzer_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    Bank& bank = banks_[pin_number / PINS_PER_BANK];
+    bank.capture_writers.fetch_add(1);
+    SimulatedLogicAnalyzer* analyzer = analyzer_.load();
+    if (analyzer) {
+        analyzer->record(pin_number, SimulatedLogicAnalyzer::EventType::Mode, static_cast<uint8_t>(mode));
+    }
+    bank.capture_writers.fetch_sub(1, std::memory_order_release);
+}
+
+// SimulatedLogicAnalyzer実装
+
+/**
+ * @brief VCDの信号識別子を生成
+ *
+ * @param index 信号番号
+ * @return std::string 印字可能なASCII文字による識別子
+ */
+static std::string makeVCDIdentifier(size_t index)
+{
+    std::string id;
+    do {
+        id += static_cast<char>('!' + index % 94);
+        index /= 94;
+    } while (index);
+    return id;
+}
+
+SimulatedLogicAnalyzer::SimulatedLogicAnalyzer(std::shared_ptr<SimulatedPinTable> table, size_t capacity)
+    : table_(std::move(table))
+{
+    // インデックス計算をマスクで行うため2のべき乗に切り上げる
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    buffer_.resize(size);
+    index_mask_ = size - 1;
+}
+
+SimulatedLogicAnalyzer::~SimulatedLogicAnalyzer()
+{
+    stop();
+}
+
+void SimulatedLogicAnalyzer::setFilter(int pin_number, bool enable)
+{
+    if (table_) {
+        table_->setCaptureEnabled(pin_number, enable);
+    }
+}
+
+void SimulatedLogicAnalyzer::setFilterAll(bool enable)
+{
+    if (!table_) {
+        return;
+    }
+    for (int i = 0; i < table_->getPinCount(); ++i) {
+        table_->setCaptureEnabled(i, enable);
+    }
+}
+
+bool SimulatedLogicAnalyzer::start()
+{
+    if (!table_ || running_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // 接続に失敗した場合（別のアナライザが接続中）は、前回の記録を残すためバッファを消去しない
+    start_ns_ = now();
+    if (!table_->attachLogicAnalyzer(this)) {
+        return false;
+    }
+    write_index_.store(0, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+
+    // 記録対象ピンの初期状態を記録
+    for (int i = 0; i < table_->getPinCount(); ++i) {
+        if (table_->isCaptureEnabled(i)) {
+            store(0, i, EventType::Mode, static_cast<uint8_t>(table_->getMode(i)));
+            store(0, i, EventType::Level, static_cast<uint8_t>(table_->getLevel(i)));
+        }
+    }
+    return true;
+}
+
+void SimulatedLogicAnalyzer::stop()
+{
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    table_->detachLogicAnalyzer(this);
+}
+
+void SimulatedLogicAnalyzer::record(int pin_number, EventType type, uint8_t value)
+{
+    store(now() - start_ns_, pin_number, type, value);
+}
+
+void SimulatedLogicAnalyzer::store(uint64_t timestamp, int pin_number, EventType type, uint8_t value)
+{
+    uint64_t index = write_index_.fetch_add(1, std::memory_order_relaxed);
+
+    Sample& sample      = buffer_[index & index_mask_];
+    sample.timestamp_ns = timestamp;
+    sample.pin_number   = static_cast<uint16_t>(pin_number);
+    sample.type         = type;
+    sample.value        = value;
+}
+
+size_t SimulatedLogicAnalyzer::getSampleCount() const
+{
+    uint64_t written = write_index_.load(std::memory_order_acquire);
+    return static_cast<size_t>(std::min<uint64_t>(written, buffer_.size()));
+}
+
+uint64_t SimulatedLogicAnalyzer::getOverwrittenCount() const
+{
+    uint64_t written = write_index_.load(std::memory_order_acquire);
+    return written > buffer_.size() ? written - buffer_.size() : 0;
+}
+
+size_t SimulatedLogicAnalyzer::getSamples(std::vector<Sample>& samples) const
+{
+    uint64_t written = write_index_.load(std::memory_order_acquire);
+    size_t count     = getSampleCount();
+
+    samples.clear();
+    samples.reserve(count);
+    for (uint64_t i = written - count; i < written; ++i) {
+        samples.push_back(buffer_[i & index_mask_]);
+    }
+
+    // 書き込み順と時刻順はスレッド間で前後しうるため時刻で並べ直す
+    std::stable_sort(samples.begin(), samples.end(),
+                     [](const Sample& a, const Sample& b) { return a.timestamp_ns < b.timestamp_ns; });
+    return samples.size();
+}
+
+double SimulatedLogicAnalyzer::getDutyCycle(int pin_number) const
+{
+    std::vector<Sample> samples;
+    getSamples(samples);
+
+    // 最初の立ち上がりから最後の立ち上がりまでの区間でHighの時間を積算
+    bool started          = false;
+    bool high             = false;
+    uint64_t first_rise   = 0;
+    uint64_t last_rise    = 0;
+    uint64_t last_change  = 0;
+    uint64_t high_total   = 0;
+    uint64_t high_at_last = 0;
+    for (const Sample& sample : samples) {
+        if (sample.pin_number != pin_number || sample.type != EventType::Level) {
+            continue;
+        }
+
+        bool level = sample.value != 0;
+        if (started && high) {
+            high_total += sample.timestamp_ns - last_change;
+        }
+        if (level && !high) {
+            if (!started) {
+                started    = true;
+                first_rise = sample.timestamp_ns;
+            }
+            last_rise    = sample.timestamp_ns;
+            high_at_last = high_total;
+        }
+        high        = level;
+        last_change = sample.timestamp_ns;
+    }
+
+    if (!started || last_rise == first_rise) {
+        return -1.0;
+    }
+    return static_cast<double>(high_at_last) / static_cast<double>(last_rise - first_rise);
+}
+
+bool SimulatedLogicAnalyzer::exportVCD(std::ostream& out) const
+{
+    std::vector<Sample> samples;
+    getSamples(samples);
+
+    // サンプルに現れるピンに信号識別子を割り当てる
+    std::vector<int> signal_index(table_ ? table_->getPinCount() : 0, -1);
+    std::vector<int> pins;
+    for (const Sample& sample : samples) {
+        if (sample.pin_number < signal_index.size() && signal_index[sample.pin_number] < 0) {
+            signal_index[sample.pin_number] = static_cast<int>(pins.size());
+            pins.push_back(sample.pin_number);
+        }
+    }
+
+    // ヘッダー
+    out << "$version FlexHAL SimulatedLogicAnalyzer $end\n";
+    out << "$timescale 1ns $end\n";
+    out << "$scope module gpio $end\n";
+    for (size_t i = 0; i < pins.size(); ++i) {
+        out << "$var wire 1 " << makeVCDIdentifier(i * 2) << " gpio" << pins[i] << " $end\n";
+        out << "$var reg 8 " << makeVCDIdentifier(i * 2 + 1) << " gpio" << pins[i] << "_mode $end\n";
+    }
+    out << "$upscope $end\n";
+    out << "$enddefinitions $end\n";
+
+    // 値の変化
+    bool first = true;
+    uint64_t current_time = 0;
+    for (const Sample& sample : samples) {
+        if (sample.pin_number >= signal_index.size()) {
+            continue;
+        }
+        if (first || sample.timestamp_ns != current_time) {
+            current_time = sample.timestamp_ns;
+            first        = false;
+            out << '#' << current_time << '\n';
+        }
+
+        size_t index = static_cast<size_t>(signal_index[sample.pin_number]);
+        if (sample.type == EventType::Level) {
+            out << (sample.value ? '1' : '0') << makeVCDIdentifier(index * 2) << '\n';
+        } else if (sample.value == static_cast<uint8_t>(PinMode::Undefined)) {
+            out << "bx " << makeVCDIdentifier(index * 2 + 1) << '\n';
+        } else {
+            out << 'b';
+            for (int bit = 7; bit >= 0; --bit) {
+                out << (((sample.value >> bit) & 0x01) ? '1' : '0');
+            }
+            out << ' ' << makeVCDIdentifier(index * 2 + 1) << '\n';
+        }
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool SimulatedLogicAnalyzer::exportVCD(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    return exportVCD(static_cast<std::ostream&>(file));
+}
+
+uint64_t SimulatedLogicAnalyzer::now()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+}  // namespace desktop
+}  // namespace platform
+}  // namespace flexhal
@@ -13,6 +13,8 @@
 
 #include "../../../src/flexhal/core.hpp"
 #include "gpio.hpp"
+#include "i2c.hpp"
+#include "spi.hpp"
 #include <memory>
 #include <thread>
 #include <atomic>
@@ -53,6 +55,24 @@ public:
      */
     std::shared_ptr<SimulatedGPIOPort> getGPIOPort();
 
+    /**
+     * @brief SPIシミュレーション実装を取得
+     *
+     * デバイスモデルはCSピン番号を指定して attachDevice() で接続する
+     *
+     * @return std::shared_ptr<SimulatedSPIImplementation> SPIシミュレーション実装
+     */
+    std::shared_ptr<SimulatedSPIImplementation> getSPIImplementation();
+
+    /**
+     * @brief I2Cシミュレーション実装を取得
+     *
+     * デバイスモデルは7ビットアドレスを指定して attachDevice() で接続する
+     *
+     * @return std::shared_ptr<SimulatedI2CImplementation> I2Cシミュレーション実装
+     */
+    std::shared_ptr<SimulatedI2CImplementation> getI2CImplementation();
+
     /**
      * @brief シミュレーションの更新処理
      *
@@ -88,6 +108,8 @@ private:
     void updateThread();
 
     std::shared_ptr<SimulatedGPIOPort> gpio_port_;
+    std::shared_ptr<SimulatedSPIImplementation> spi_implementation_;
+    std::shared_ptr<SimulatedI2CImplementation> i2c_implementation_;
     std::atomic<bool> running_;
     std::unique_ptr<std::thread> update_thread_;
 };
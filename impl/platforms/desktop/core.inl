@@ -27,6 +27,12 @@ DesktopSimulation::DesktopSimulation() : running_(false)
 {
     // GPIOポート作成
     gpio_port_ = std::make_shared<SimulatedGPIOPort>(40, "FlexHAL GPIO Simulator");
+
+    // SPIシミュレーション実装作成（デバイスモデルは利用者が接続する）
+    spi_implementation_ = std::make_shared<SimulatedSPIImplementation>();
+
+    // I2Cシミュレーション実装作成（デバイスモデルは利用者が接続する）
+    i2c_implementation_ = std::make_shared<SimulatedI2CImplementation>();
 }
 
 DesktopSimulation::~DesktopSimulation()
@@ -74,6 +80,16 @@ std::shared_ptr<SimulatedGPIOPort> DesktopSimulation::getGPIOPort()
     return gpio_port_;
 }
 
+std::shared_ptr<SimulatedSPIImplementation> DesktopSimulation::getSPIImplementation()
+{
+    return spi_implementation_;
+}
+
+std::shared_ptr<SimulatedI2CImplementation> DesktopSimulation::getI2CImplementation()
+{
+    return i2c_implementation_;
+}
+
 bool DesktopSimulation::update()
 {
     bool result = true;
@@ -104,6 +120,14 @@ void DesktopSimulation::hideWindows()
 
 // メインスレッドから呼び出される更新関数に置き換えたため、updateThreadは不要
 
+// StaticPin用バックエンドのピン状態テーブル
+SimulatedPinTable& SimulatedPinBackend::getTable()
+{
+    // シミュレーション環境はプログラム終了まで存在するため、テーブルを一度だけ解決する
+    static SimulatedPinTable* table = DesktopSimulation::getInstance().getGPIOPort()->getPinTable().get();
+    return *table;
+}
+
 }  // namespace desktop
 }  // namespace platform
 }  // namespace flexhal
@@ -10,6 +10,8 @@
 
 #include "../../../src/flexhal/gpio.hpp"
 #include "../../../src/flexhal/core.hpp"
+#include "../../../src/flexhal/i2c.hpp"
+#include "../../../src/flexhal/spi.hpp"
 #include "core.hpp"
 #include <memory>
 
@@ -39,6 +41,53 @@ std::shared_ptr<IPin> getPin(int pin_number)
     return port->getPin(pin_number);
 }
 
+// 指定したピン番号のピンへの非所有ハンドルを取得
+PinRef getPinRef(int pin_number)
+{
+    auto port = getDefaultGPIOPort();
+    if (!port) {
+        return PinRef();
+    }
+
+    return PinRef(*port, pin_number);
+}
+
+// デスクトップシミュレーション環境のSPIバスを取得
+std::shared_ptr<ISPIBus> getDefaultSPIBus()
+{
+    // 関数内staticの初期化はスレッドセーフなため、同時に呼ばれてもバスは1つだけ作成される
+    static std::shared_ptr<SPIBus> bus = []() {
+        // ESP32のVSPIと同じピン配置
+        SPIBusConfig config;
+        config.sck_pin  = 18;
+        config.miso_pin = 19;
+        config.mosi_pin = 23;
+
+        auto spi = std::make_shared<SPIBus>(config);
+        spi->addImplementation(platform::desktop::DesktopSimulation::getInstance().getSPIImplementation());
+        return spi;
+    }();
+
+    return bus;
+}
+
+// デスクトップシミュレーション環境のI2Cバスを取得
+std::shared_ptr<II2CBus> getDefaultI2CBus()
+{
+    static std::shared_ptr<I2CBus> bus = []() {
+        // ESP32のデフォルトI2Cと同じピン配置
+        I2CBusConfig config;
+        config.sda_pin = 21;
+        config.scl_pin = 22;
+
+        auto i2c = std::make_shared<I2CBus>(config);
+        i2c->addImplementation(platform::desktop::DesktopSimulation::getInstance().getI2CImplementation());
+        return i2c;
+    }();
+
+    return bus;
+}
+
 // プラットフォーム固有の初期化
 namespace platform {
     namespace desktop {
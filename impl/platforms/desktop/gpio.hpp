@@ -13,10 +13,16 @@
 
 #include "../../../src/flexhal/gpio.hpp"
 #include "../../frameworks/sdl/window.hpp"
-#include <map>
+#include "../../internal/gpio_program.h"
+#include "../../internal/lockfree_queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <string>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace flexhal {
 namespace platform {
@@ -34,17 +40,472 @@ enum class PinState {
     INPUT_PULLDOWN  // 入力モード（プルダウン）
 };
 
+/**
+ * @brief キャッシュラインサイズ（バイト）
+ */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// 前方宣言
+class SimulatedLogicAnalyzer;
+
+/**
+ * @brief シミュレーション用ピン割り込みディスパッチャ
+ *
+ * ピン状態テーブルで検出したエッジをロックフリーキュー経由で受け取り、
+ * 専用スレッドからコールバックを呼び出す。コールバックはピン操作を行ったスレッドでは
+ * 実行されないため、コールバック内から再びピンを操作しても問題ない。
+ */
+class SimulatedInterruptDispatcher {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param pin_count ピン数
+     */
+    explicit SimulatedInterruptDispatcher(int pin_count);
+
+    /**
+     * @brief デストラクタ（ディスパッチスレッドを停止）
+     */
+    ~SimulatedInterruptDispatcher();
+
+    /**
+     * @brief コールバックを設定（必要ならディスパッチスレッドを開始）
+     *
+     * @param pin_number ピン番号
+     * @param callback コールバック関数
+     */
+    void setCallback(int pin_number, PinInterruptCallback callback);
+
+    /**
+     * @brief コールバックを解除
+     *
+     * @param pin_number ピン番号
+     */
+    void clearCallback(int pin_number);
+
+    /**
+     * @brief エッジイベントを投入（ロックフリー）
+     *
+     * @param pin_number ピン番号
+     * @param level エッジ発生後のレベル
+     * @return true 投入成功
+     * @return false キューが満杯でイベントを破棄した
+     */
+    bool post(int pin_number, PinLevel level);
+
+    /**
+     * @brief キュー溢れで破棄したイベント数を取得
+     *
+     * @return uint32_t 破棄したイベント数
+     */
+    uint32_t getDroppedCount() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief ディスパッチスレッド関数
+     */
+    void run();
+
+    /**
+     * @brief エッジイベント
+     */
+    struct Event {
+        int pin_number;
+        PinLevel level;
+    };
+
+    static constexpr size_t QUEUE_SIZE = 1024;
+
+    LockFreeQueue<Event, QUEUE_SIZE> queue_;
+    std::vector<std::shared_ptr<const PinInterruptCallback>> callbacks_;
+    std::mutex callback_mutex_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    std::atomic<int32_t> pending_{0};
+    std::atomic<bool> waiting_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> dropped_{0};
+    std::thread thread_;
+};
+
+/**
+ * @brief オープンドレイン配線のレベル変化の通知先
+ *
+ * 通知はレベルを変化させたスレッドから同期的に行われるため、ビット単位でバスを復号する
+ * デバイスモデルは、マスタが次にレベルを読み取る前に応答（Lowへの引き込み）を反映できる。
+ * 通知の中から SimulatedPinTable::setExternalLevel() を呼び出すと、同じスレッドで再び通知される
+ */
+class SimulatedWireListener {
+public:
+    virtual ~SimulatedWireListener() = default;
+
+    /**
+     * @brief オープンドレインのピンのレベルが変化した
+     *
+     * @param bank バンク番号
+     * @param levels 変化後のバンクのレベル
+     * @param changed 変化したピン（ビットマップ）
+     */
+    virtual void onWireChanged(int bank, uint32_t levels, uint32_t changed) = 0;
+};
+
+/**
+ * @brief シミュレーション用ピン状態テーブル
+ *
+ * 32ピンを1バンクとし、バンクごとにレベル・方向をアトミックなワードで保持する。
+ * バンクはキャッシュライン境界に配置されるため、別バンクを操作するスレッド同士で
+ * フォルスシェアリングが起きない。単一ピン操作はfetch_or/fetch_andのみで完結し、
+ * マスク付き一括設定はバンクあたり1回のアトミックRMWで行う。
+ *
+ * オープンドレインのピンはプルアップされたワイヤードANDとして扱い、自身の出力と
+ * 外部（setExternalLevel）のどちらかがLowに引いていればLow、両方が開放していればHighになる。
+ */
+class SimulatedPinTable {
+public:
+    /**
+     * @brief 1バンクあたりのピン数
+     */
+    static constexpr int PINS_PER_BANK = 32;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param pin_count ピン数
+     */
+    explicit SimulatedPinTable(int pin_count);
+
+    /**
+     * @brief ピン数を取得
+     *
+     * @return int ピン数
+     */
+    int getPinCount() const
+    {
+        return pin_count_;
+    }
+
+    /**
+     * @brief バンク数を取得
+     *
+     * @return int バンク数
+     */
+    int getBankCount() const
+    {
+        return bank_count_;
+    }
+
+    /**
+     * @brief ピン番号が有効か確認
+     *
+     * @param pin_number ピン番号
+     * @return true 有効
+     * @return false 範囲外
+     */
+    bool isValid(int pin_number) const
+    {
+        return pin_number >= 0 && pin_number < pin_count_;
+    }
+
+    /**
+     * @brief ピンモードを設定
+     *
+     * @param pin_number ピン番号
+     * @param mode ピンモード
+     */
+    void setMode(int pin_number, PinMode mode);
+
+    /**
+     * @brief ピンモードを取得
+     *
+     * @param pin_number ピン番号
+     * @return PinMode ピンモード
+     */
+    PinMode getMode(int pin_number) const;
+
+    /**
+     * @brief 出力レベルを設定（出力モード・オープンドレインのピンのみ反映）
+     *
+     * @param pin_number ピン番号
+     * @param level 出力レベル（オープンドレインのピンではHighで開放）
+     */
+    void setLevel(int pin_number, PinLevel level)
+    {
+        if (!isValid(pin_number)) {
+            return;
+        }
+
+        Bank& bank   = banks_[pin_number / PINS_PER_BANK];
+        uint32_t bit = 1u << (pin_number % PINS_PER_BANK);
+
+        // 出力モードの場合のみレベルを変更
+        if (!(bank.outputs.load(std::memory_order_acquire) & bit)) {
+            if (bank.open_drain.load(std::memory_order_acquire) & bit) {
+                setLevels(pin_number / PINS_PER_BANK, level == PinLevel::High ? bit : 0, bit);
+            }
+            return;
+        }
+        uint32_t previous;
+        if (level == PinLevel::High) {
+            previous = bank.levels.fetch_or(bit, std::memory_order_acq_rel);
+        } else {
+            previous = bank.levels.fetch_and(~bit, std::memory_order_acq_rel);
+        }
+
+        // キャプチャ対象のピンで変化があれば記録
+        if ((bank.capture.load(std::memory_order_relaxed) & bit) &&
+            ((previous & bit) != 0) != (level == PinLevel::High)) {
+            captureLevel(pin_number, level);
+        }
+    }
+
+    /**
+     * @brief 外部からの入力レベルを設定（入力モード・オープンドレインのピンのみ反映）
+     *
+     * オープンドレインのピンでは、LowでLowに引き込み、Highで開放する
+     *
+     * @param pin_number ピン番号
+     * @param level 入力レベル
+     */
+    void setExternalLevel(int pin_number, PinLevel level);
+
+    /**
+     * @brief ピンレベルを取得
+     *
+     * @param pin_number ピン番号
+     * @return PinLevel 現在のレベル
+     */
+    PinLevel getLevel(int pin_number) const
+    {
+        if (!isValid(pin_number)) {
+            return PinLevel::Low;
+        }
+
+        const Bank& bank = banks_[pin_number / PINS_PER_BANK];
+        uint32_t bit     = 1u << (pin_number % PINS_PER_BANK);
+        return (bank.levels.load(std::memory_order_acquire) & bit) ? PinLevel::High : PinLevel::Low;
+    }
+
+    /**
+     * @brief ピン状態を取得
+     *
+     * @param pin_number ピン番号
+     * @return PinState ピン状態
+     */
+    PinState getState(int pin_number) const;
+
+    /**
+     * @brief 割り込みを検出するエッジを設定
+     *
+     * @param pin_number ピン番号
+     * @param rising 立ち上がりエッジを検出するか
+     * @param falling 立ち下がりエッジを検出するか
+     */
+    void setInterruptEdge(int pin_number, bool rising, bool falling);
+
+    /**
+     * @brief エッジの通知先を設定
+     *
+     * 以前の通知先へ通知中のスレッドが全バンクで抜けるまで待機してから戻るため、
+     * 戻った後は以前のディスパッチャを破棄してよい
+     *
+     * @param dispatcher 通知先ディスパッチャ（nullptrで通知しない）
+     */
+    void setInterruptDispatcher(SimulatedInterruptDispatcher* dispatcher);
+
+    /**
+     * @brief キャプチャ対象のピンを設定
+     *
+     * @param pin_number ピン番号
+     * @param enable trueでキャプチャ対象にする
+     */
+    void setCaptureEnabled(int pin_number, bool enable);
+
+    /**
+     * @brief キャプチャ対象のピンか
+     *
+     * @param pin_number ピン番号
+     * @return true キャプチャ対象
+     * @return false キャプチャ対象外
+     */
+    bool isCaptureEnabled(int pin_number) const
+    {
+        if (!isValid(pin_number)) {
+            return false;
+        }
+        const Bank& bank = banks_[pin_number / PINS_PER_BANK];
+        return (bank.capture.load(std::memory_order_relaxed) >> (pin_number % PINS_PER_BANK)) & 0x01;
+    }
+
+    /**
+     * @brief ピン変化の記録先を接続
+     *
+     * @param analyzer 記録先ロジックアナライザ
+     * @return true 接続成功
+     * @return false 既に他のロジックアナライザが接続されている
+     */
+    bool attachLogicAnalyzer(SimulatedLogicAnalyzer* analyzer);
+
+    /**
+     * @brief ピン変化の記録先を切断
+     *
+     * 記録処理中のスレッドが抜けるまで待機してから戻る
+     *
+     * @param analyzer 切断するロジックアナライザ
+     */
+    void detachLogicAnalyzer(SimulatedLogicAnalyzer* analyzer);
+
+    /**
+     * @brief オープンドレイン配線の通知先を設定
+     *
+     * 通知先の変更は、オープンドレインのピンを操作するスレッドが止まっている状態で行うこと
+     *
+     * @param listener 通知先（nullptrで通知しない）
+     */
+    void setWireListener(SimulatedWireListener* listener)
+    {
+        wire_listener_.store(listener, std::memory_order_release);
+    }
+
+    /**
+     * @brief バンク内の出力ピンのレベルを一括設定
+     *
+     * オープンドレインのピンは、値が1のビットを開放し、0のビットをLowに引き込む
+     *
+     * @param bank バンク番号
+     * @param values 設定する値（ビットマップ）
+     * @param mask 設定対象のピン（ビットマップ）
+     */
+    void setLevels(int bank, uint32_t values, uint32_t mask);
+
+    /**
+     * @brief バンク内のピンのレベルを一括取得
+     *
+     * @param bank バンク番号
+     * @return uint32_t 現在のレベル（ビットマップ）
+     */
+    uint32_t getLevels(int bank) const;
+
+private:
+    /**
+     * @brief 32ピン分の状態（キャッシュライン境界に配置）
+     */
+    struct alignas(CACHE_LINE_SIZE) Bank {
+        std::atomic<uint32_t> levels{0};        ///< 現在のレベル
+        std::atomic<uint32_t> outputs{0};       ///< 出力モードのピン
+        std::atomic<uint32_t> inputs{0};        ///< 入力モード（プルアップ/プルダウン含む）のピン
+        std::atomic<uint32_t> rising{0};        ///< 立ち上がりエッジ割り込みが有効なピン
+        std::atomic<uint32_t> falling{0};       ///< 立ち下がりエッジ割り込みが有効なピン
+        std::atomic<uint32_t> capture{0};       ///< キャプチャ対象のピン
+        std::atomic<uint32_t> open_drain{0};    ///< オープンドレインのピン
+        std::atomic<uint32_t> drive_low{0};     ///< 自身の出力でLowに引き込んでいるオープンドレインのピン
+        std::atomic<uint32_t> external_low{0};  ///< 外部からLowに引き込まれているオープンドレインのピン
+        std::atomic<uint32_t> capture_writers{0};  ///< このバンクのピンの変化を記録中のスレッド数
+        std::atomic<uint32_t> edge_posters{0};     ///< このバンクのピンのエッジを通知中のスレッド数
+        std::atomic<uint8_t> modes[PINS_PER_BANK];  ///< ピンごとのモード
+    };
+
+    /**
+     * @brief レベル変化をロジックアナライザに記録
+     *
+     * @param pin_number ピン番号
+     * @param level 変化後のレベル
+     */
+    void captureLevel(int pin_number, PinLevel level);
+
+    /**
+     * @brief モード変化をロジックアナライザに記録
+     *
+     * @param pin_number ピン番号
+     * @param mode 変化後のモード
+     */
+    void captureMode(int pin_number, PinMode mode);
+
+    /**
+     * @brief エッジをディスパッチャに通知
+     *
+     * @param pin_number ピン番号
+     * @param level 変化後のレベル
+     */
+    void postEdge(int pin_number, PinLevel level);
+
+    /**
+     * @brief 入力ピンのレベルを変更し、エッジがあれば通知
+     *
+     * @param pin_number ピン番号
+     * @param level 新しいレベル
+     */
+    void changeInputLevel(int pin_number, PinLevel level);
+
+    /**
+     * @brief オープンドレインのピンのレベルを出力と外部の引き込みから再計算し、変化を通知
+     *
+     * @param bank_index バンク番号
+     */
+    void updateWiredLevels(int bank_index);
+
+    int pin_count_;
+    int bank_count_;
+    std::unique_ptr<Bank[]> banks_;
+    std::atomic<SimulatedInterruptDispatcher*> dispatcher_{nullptr};
+    std::atomic<SimulatedLogicAnalyzer*> analyzer_{nullptr};
+    std::atomic<SimulatedWireListener*> wire_listener_{nullptr};
+};
+
+/**
+ * @brief StaticPin用のシミュレーションバックエンド
+ *
+ * デスクトップシミュレーション環境のピン状態テーブルを直接操作する
+ */
+struct SimulatedPinBackend {
+    /**
+     * @brief シミュレーション環境のピン状態テーブルを取得
+     *
+     * @return SimulatedPinTable& ピン状態テーブル
+     */
+    static SimulatedPinTable& getTable();
+
+    static void setMode(int pin_number, PinMode mode)
+    {
+        getTable().setMode(pin_number, mode);
+    }
+
+    static void setLevel(int pin_number, PinLevel level)
+    {
+        getTable().setLevel(pin_number, level);
+    }
+
+    static PinLevel getLevel(int pin_number)
+    {
+        return getTable().getLevel(pin_number);
+    }
+};
+
+/**
+ * @brief シミュレーション環境のピン（コンパイル時ピン番号指定）
+ *
+ * @tparam PinNumber ピン番号
+ */
+template <int PinNumber>
+using SimulatedStaticPin = StaticPin<PinNumber, SimulatedPinBackend>;
+
 /**
  * @brief GPIOピンシミュレーションクラス
+ *
+ * 状態はSimulatedPinTableが保持し、このクラスはテーブルへのビューとして振る舞う
  */
 class SimulatedPin : public IPin {
 public:
     /**
      * @brief コンストラクタ
      *
+     * @param table ピン状態テーブル
      * @param pin_number ピン番号
      */
-    SimulatedPin(int pin_number);
+    SimulatedPin(std::shared_ptr<SimulatedPinTable> table, int pin_number);
 
     /**
      * @brief デストラクタ
@@ -87,10 +548,8 @@ public:
     void setExternalLevel(PinLevel level);
 
 private:
+    std::shared_ptr<SimulatedPinTable> table_;
     int pin_number_;
-    PinMode mode_;
-    PinLevel level_;
-    mutable std::mutex mutex_;
 
     /**
      * @brief ピン番号を取得
@@ -155,6 +614,30 @@ public:
      */
     PinLevel digitalRead(int pin_number);
 
+    /**
+     * @brief ピンのモードを設定
+     *
+     * @param pin_number ピン番号
+     * @param mode ピンモード
+     */
+    virtual void setPinMode(int pin_number, PinMode mode) override;
+
+    /**
+     * @brief ピンのレベルを設定（ピン状態テーブルを直接操作）
+     *
+     * @param pin_number ピン番号
+     * @param level 設定するレベル
+     */
+    virtual void writePin(int pin_number, PinLevel level) override;
+
+    /**
+     * @brief ピンのレベルを取得（ピン状態テーブルを直接参照）
+     *
+     * @param pin_number ピン番号
+     * @return PinLevel 現在のレベル
+     */
+    virtual PinLevel readPin(int pin_number) const override;
+
     /**
      * @brief シミュレーションウィンドウを表示
      */
@@ -180,6 +663,69 @@ public:
      */
     virtual uint32_t getLevels() const override;
 
+    using IGPIOPort::getLevels;
+    using IGPIOPort::setLevels;
+
+    /**
+     * @brief バンク数を取得
+     *
+     * @return int バンク数
+     */
+    virtual int getBankCount() const override;
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に設定（1回のアトミック操作）
+     *
+     * @param bank バンク番号
+     * @param values 設定する値（ビットマップ）
+     * @param mask 設定対象のピン（ビットマップ）
+     */
+    virtual void setLevels(int bank, uint32_t values, uint32_t mask) override;
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に取得
+     *
+     * @param bank バンク番号
+     * @return uint32_t 現在のレベル（ビットマップ）
+     */
+    virtual uint32_t getLevels(int bank) const override;
+
+    /**
+     * @brief ピン割り込みを登録
+     *
+     * 入力モードのピンのレベル変化（setExternalLevelやウィンドウ操作）を検出し、
+     * ディスパッチスレッドからコールバックを呼び出す
+     *
+     * @param pin_number ピン番号
+     * @param edge 検出するエッジ
+     * @param callback コールバック関数
+     * @return true 登録成功
+     * @return false 登録失敗
+     */
+    virtual bool attachInterrupt(int pin_number, PinEdge edge, PinInterruptCallback callback) override;
+
+    /**
+     * @brief ピン割り込みを解除
+     *
+     * @param pin_number ピン番号
+     */
+    virtual void detachInterrupt(int pin_number) override;
+
+    /**
+     * @brief GPIOプログラムを実行
+     *
+     * ピン状態テーブルを直接操作して実行する。ウィンドウ操作やsetExternalLevelによる
+     * 入力変化は、レベル待ちステップで他スレッドから観測される
+     *
+     * @param program 実行するプログラム
+     * @param samples 読み取りステップの結果の格納先
+     * @param sample_capacity 格納先の要素数
+     * @return true 実行成功
+     * @return false 検証失敗、またはレベル待ちのタイムアウト
+     */
+    virtual bool execute(const GPIOProgram& program, uint32_t* samples = nullptr,
+                         size_t sample_capacity = 0) override;
+
     /**
      * @brief デバイスの初期化
      *
@@ -209,6 +755,16 @@ public:
      */
     bool update();
 
+    /**
+     * @brief ピン状態テーブルを取得
+     *
+     * @return std::shared_ptr<SimulatedPinTable> ピン状態テーブル
+     */
+    std::shared_ptr<SimulatedPinTable> getPinTable() const
+    {
+        return table_;
+    }
+
 private:
     /**
      * @brief SDLイベント処理コールバック
@@ -240,9 +796,10 @@ private:
     void drawPin(SDL_Renderer* renderer, int x, int y, int width, int height, PinState state, int pin_number);
 
     int pin_count_;
-    std::map<int, std::shared_ptr<SimulatedPin>> pins_;
+    std::shared_ptr<SimulatedPinTable> table_;
+    std::vector<std::shared_ptr<SimulatedPin>> pins_;
+    std::unique_ptr<SimulatedInterruptDispatcher> interrupt_dispatcher_;
     std::unique_ptr<framework::sdl::Window> window_;
-    mutable std::mutex mutex_;
     bool window_visible_;
 };
 
@@ -9,77 +9,445 @@
  */
 
 #include "gpio.hpp"
+#include <chrono>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 namespace flexhal {
 namespace platform {
 namespace desktop {
 
-// SimulatedPin実装
+// SimulatedInterruptDispatcher実装
 
-SimulatedPin::SimulatedPin(int pin_number) : pin_number_(pin_number), mode_(PinMode::Input), level_(PinLevel::Low)
+SimulatedInterruptDispatcher::SimulatedInterruptDispatcher(int pin_count)
+    : callbacks_(pin_count < 0 ? 0 : pin_count)
 {
 }
 
-void SimulatedPin::setMode(PinMode mode)
+SimulatedInterruptDispatcher::~SimulatedInterruptDispatcher()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        wait_cv_.notify_one();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SimulatedInterruptDispatcher::setCallback(int pin_number, PinInterruptCallback callback)
+{
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (pin_number < 0 || static_cast<size_t>(pin_number) >= callbacks_.size()) {
+        return;
+    }
+
+    callbacks_[pin_number] = std::make_shared<const PinInterruptCallback>(std::move(callback));
+
+    // 最初の登録時にディスパッチスレッドを開始
+    if (!running_.exchange(true)) {
+        thread_ = std::thread([this] { run(); });
+    }
+}
+
+void SimulatedInterruptDispatcher::clearCallback(int pin_number)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    mode_ = mode;
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (pin_number < 0 || static_cast<size_t>(pin_number) >= callbacks_.size()) {
+        return;
+    }
+
+    callbacks_[pin_number].reset();
+}
+
+bool SimulatedInterruptDispatcher::post(int pin_number, PinLevel level)
+{
+    if (!queue_.push(Event{pin_number, level})) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // ディスパッチスレッドが待機中の場合のみ起床させる
+    pending_.fetch_add(1);
+    if (waiting_.load()) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        wait_cv_.notify_one();
+    }
+    return true;
+}
+
+void SimulatedInterruptDispatcher::run()
+{
+    Event event;
+    while (running_.load()) {
+        while (queue_.pop(event)) {
+            pending_.fetch_sub(1);
+
+            // コールバックはロックを解放してから呼び出す
+            std::shared_ptr<const PinInterruptCallback> callback;
+            {
+                std::lock_guard<std::mutex> lock(callback_mutex_);
+                callback = callbacks_[event.pin_number];
+            }
+            if (callback && *callback) {
+                (*callback)(event.pin_number, event.level);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        waiting_.store(true);
+        wait_cv_.wait(lock, [this] { return !running_.load() || pending_.load() > 0; });
+        waiting_.store(false);
+    }
+}
+
+// SimulatedPinTable実装
+
+// 入力として外部レベルを受け付けるモードか判定
+static inline bool isInputMode(PinMode mode)
+{
+    return mode == PinMode::Input || mode == PinMode::InputPullUp || mode == PinMode::InputPullDown;
+}
+
+SimulatedPinTable::SimulatedPinTable(int pin_count)
+    : pin_count_(pin_count < 0 ? 0 : pin_count),
+      bank_count_((pin_count_ + PINS_PER_BANK - 1) / PINS_PER_BANK),
+      banks_(new Bank[bank_count_ > 0 ? bank_count_ : 1])
+{
+    // 全ピンを入力モード・Lowレベルで初期化
+    for (int pin = 0; pin < pin_count_; ++pin) {
+        Bank& bank = banks_[pin / PINS_PER_BANK];
+        int bit    = pin % PINS_PER_BANK;
+        bank.modes[bit].store(static_cast<uint8_t>(PinMode::Input), std::memory_order_relaxed);
+        bank.inputs.fetch_or(1u << bit, std::memory_order_relaxed);
+    }
+}
+
+void SimulatedPinTable::setMode(int pin_number, PinMode mode)
+{
+    if (!isValid(pin_number)) {
+        return;
+    }
+
+    Bank& bank   = banks_[pin_number / PINS_PER_BANK];
+    uint32_t bit = 1u << (pin_number % PINS_PER_BANK);
+    uint8_t previous_mode =
+        bank.modes[pin_number % PINS_PER_BANK].exchange(static_cast<uint8_t>(mode), std::memory_order_acq_rel);
+    if ((bank.capture.load(std::memory_order_relaxed) & bit) && previous_mode != static_cast<uint8_t>(mode)) {
+        captureMode(pin_number, mode);
+    }
+
+    // 方向マスクを更新
+    if (mode == PinMode::Output) {
+        bank.outputs.fetch_or(bit, std::memory_order_acq_rel);
+    } else {
+        bank.outputs.fetch_and(~bit, std::memory_order_acq_rel);
+    }
+    if (isInputMode(mode)) {
+        bank.inputs.fetch_or(bit, std::memory_order_acq_rel);
+    } else {
+        bank.inputs.fetch_and(~bit, std::memory_order_acq_rel);
+    }
+    if (mode == PinMode::OpenDrain) {
+        // 開放した状態で配線に接続する
+        bank.drive_low.fetch_and(~bit, std::memory_order_acq_rel);
+        bank.open_drain.fetch_or(bit, std::memory_order_acq_rel);
+        updateWiredLevels(pin_number / PINS_PER_BANK);
+    } else {
+        bank.open_drain.fetch_and(~bit, std::memory_order_acq_rel);
+    }
 
     // モード変更時のデフォルト状態設定
     if (mode == PinMode::InputPullUp) {
-        level_ = PinLevel::High;
+        changeInputLevel(pin_number, PinLevel::High);
     } else if (mode == PinMode::InputPullDown) {
-        level_ = PinLevel::Low;
+        changeInputLevel(pin_number, PinLevel::Low);
     }
 }
 
-void SimulatedPin::setLevel(PinLevel level)
+PinMode SimulatedPinTable::getMode(int pin_number) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isValid(pin_number)) {
+        return PinMode::Undefined;
+    }
+
+    const Bank& bank = banks_[pin_number / PINS_PER_BANK];
+    return static_cast<PinMode>(bank.modes[pin_number % PINS_PER_BANK].load(std::memory_order_acquire));
+}
 
-    // 出力モードの場合のみレベルを変更
-    if (mode_ == PinMode::Output) {
-        level_ = level;
+void SimulatedPinTable::setExternalLevel(int pin_number, PinLevel level)
+{
+    if (!isValid(pin_number)) {
+        return;
     }
+
+    Bank& bank   = banks_[pin_number / PINS_PER_BANK];
+    uint32_t bit = 1u << (pin_number % PINS_PER_BANK);
+
+    // オープンドレインのピンは外部からの引き込みとして反映
+    if (bank.open_drain.load(std::memory_order_acquire) & bit) {
+        if (level == PinLevel::Low) {
+            bank.external_low.fetch_or(bit, std::memory_order_acq_rel);
+        } else {
+            bank.external_low.fetch_and(~bit, std::memory_order_acq_rel);
+        }
+        updateWiredLevels(pin_number / PINS_PER_BANK);
+        return;
+    }
+
+    // 入力モードの場合のみレベルを変更
+    if (!(bank.inputs.load(std::memory_order_acquire) & bit)) {
+        return;
+    }
+    changeInputLevel(pin_number, level);
 }
 
-PinLevel SimulatedPin::getLevel() const
+void SimulatedPinTable::changeInputLevel(int pin_number, PinLevel level)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return level_;
+    Bank& bank   = banks_[pin_number / PINS_PER_BANK];
+    uint32_t bit = 1u << (pin_number % PINS_PER_BANK);
+
+    // 変更前の値からエッジを判定
+    uint32_t previous;
+    uint32_t edge_mask;
+    if (level == PinLevel::High) {
+        previous  = bank.levels.fetch_or(bit, std::memory_order_acq_rel);
+        edge_mask = bank.rising.load(std::memory_order_acquire);
+    } else {
+        previous  = bank.levels.fetch_and(~bit, std::memory_order_acq_rel);
+        edge_mask = bank.falling.load(std::memory_order_acquire);
+    }
+
+    bool changed = ((previous & bit) != 0) != (level == PinLevel::High);
+    if (changed && (bank.capture.load(std::memory_order_relaxed) & bit)) {
+        captureLevel(pin_number, level);
+    }
+    if (changed && (edge_mask & bit)) {
+        postEdge(pin_number, level);
+    }
 }
 
-PinState SimulatedPin::getState() const
+void SimulatedPinTable::setInterruptDispatcher(SimulatedInterruptDispatcher* dispatcher)
+{
+    if (dispatcher_.exchange(dispatcher) == nullptr) {
+        return;
+    }
+
+    // 切り替え前のディスパッチャを読んだスレッドが全バンクで抜けるまで待機。
+    // 通知側の「カウンタを加算してから通知先を読む」と対になるため seq_cst で読む
+    for (int i = 0; i < bank_count_; ++i) {
+        while (banks_[i].edge_posters.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SimulatedPinTable::postEdge(int pin_number, PinLevel level)
 {
-    if (mode_ == PinMode::Input) {
-        return (level_ == PinLevel::Low) ? PinState::INPUT_LOW : PinState::INPUT_HIGH;
-    } else if (mode_ == PinMode::Output) {
-        return (level_ == PinLevel::Low) ? PinState::OUTPUT_LOW : PinState::OUTPUT_HIGH;
-    } else if (mode_ == PinMode::InputPullUp) {
+    // 通知先がない間はカウンタを操作しない
+    if (!dispatcher_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // カウンタはキャプチャと同様にバンクごとに持ち、加算後の再読み込みは seq_cst とする
+    Bank& bank = banks_[pin_number / PINS_PER_BANK];
+    bank.edge_posters.fetch_add(1);
+    SimulatedInterruptDispatcher* dispatcher = dispatcher_.load();
+    if (dispatcher) {
+        dispatcher->post(pin_number, level);
+    }
+    bank.edge_posters.fetch_sub(1, std::memory_order_release);
+}
+
+void SimulatedPinTable::setInterruptEdge(int pin_number, bool rising, bool falling)
+{
+    if (!isValid(pin_number)) {
+        return;
+    }
+
+    Bank& bank   = banks_[pin_number / PINS_PER_BANK];
+    uint32_t bit = 1u << (pin_number % PINS_PER_BANK);
+    if (rising) {
+        bank.rising.fetch_or(bit, std::memory_order_acq_rel);
+    } else {
+        bank.rising.fetch_and(~bit, std::memory_order_acq_rel);
+    }
+    if (falling) {
+        bank.falling.fetch_or(bit, std::memory_order_acq_rel);
+    } else {
+        bank.falling.fetch_and(~bit, std::memory_order_acq_rel);
+    }
+}
+
+PinState SimulatedPinTable::getState(int pin_number) const
+{
+    PinMode mode   = getMode(pin_number);
+    PinLevel level = getLevel(pin_number);
+
+    if (mode == PinMode::Input) {
+        return (level == PinLevel::Low) ? PinState::INPUT_LOW : PinState::INPUT_HIGH;
+    } else if (mode == PinMode::Output || mode == PinMode::OpenDrain) {
+        return (level == PinLevel::Low) ? PinState::OUTPUT_LOW : PinState::OUTPUT_HIGH;
+    } else if (mode == PinMode::InputPullUp) {
         return PinState::INPUT_PULLUP;
-    } else if (mode_ == PinMode::InputPullDown) {
+    } else if (mode == PinMode::InputPullDown) {
         return PinState::INPUT_PULLDOWN;
     }
 
     return PinState::INPUT_LOW;  // デフォルト
 }
 
-void SimulatedPin::setExternalLevel(PinLevel level)
+void SimulatedPinTable::setLevels(int bank_index, uint32_t values, uint32_t mask)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    if (bank_index < 0 || bank_index >= bank_count_) {
+        return;
+    }
 
-    // 入力モードの場合のみレベルを変更
-    if (mode_ == PinMode::Input || mode_ == PinMode::InputPullUp || mode_ == PinMode::InputPullDown) {
-        level_ = level;
+    Bank& bank = banks_[bank_index];
+
+    // オープンドレインのピンは引き込み状態を書き換えてから配線のレベルを再計算する
+    uint32_t wired = mask & bank.open_drain.load(std::memory_order_acquire);
+    if (wired) {
+        uint32_t drive = bank.drive_low.load(std::memory_order_relaxed);
+        while (!bank.drive_low.compare_exchange_weak(drive, (drive & ~wired) | (~values & wired),
+                                                     std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        }
+        updateWiredLevels(bank_index);
+    }
+
+    // 出力モードのピンだけを対象に、1回のRMWでまとめて書き換える
+    uint32_t effective = mask & bank.outputs.load(std::memory_order_acquire);
+    if (!effective) {
+        return;
+    }
+    uint32_t current = bank.levels.load(std::memory_order_relaxed);
+    while (!bank.levels.compare_exchange_weak(current, (current & ~effective) | (values & effective),
+                                              std::memory_order_acq_rel, std::memory_order_relaxed)) {
+    }
+
+    // キャプチャ対象のピンのうち変化したものを記録
+    uint32_t changed = (current ^ values) & effective & bank.capture.load(std::memory_order_relaxed);
+    for (; changed; changed &= changed - 1) {
+        int bit = lowestBitIndex(changed);
+        captureLevel(bank_index * PINS_PER_BANK + bit, ((values >> bit) & 0x01) ? PinLevel::High : PinLevel::Low);
+    }
+}
+
+void SimulatedPinTable::updateWiredLevels(int bank_index)
+{
+    Bank& bank = banks_[bank_index];
+
+    // 計算中に引き込み状態が変わった場合は、最新の状態で計算し直す
+    uint32_t original = bank.levels.load(std::memory_order_relaxed);
+    uint32_t current  = original;
+    uint32_t next;
+    for (;;) {
+        uint32_t wired = bank.open_drain.load(std::memory_order_acquire);
+        uint32_t low   = bank.drive_low.load(std::memory_order_acquire) |
+                       bank.external_low.load(std::memory_order_acquire);
+        do {
+            next = (current & ~wired) | (wired & ~low);
+        } while (!bank.levels.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                                    std::memory_order_relaxed));
+        if (wired == bank.open_drain.load(std::memory_order_acquire) &&
+            low == (bank.drive_low.load(std::memory_order_acquire) |
+                    bank.external_low.load(std::memory_order_acquire))) {
+            break;
+        }
+        current = next;
+    }
+
+    uint32_t changed = (original ^ next) & bank.open_drain.load(std::memory_order_relaxed);
+    if (!changed) {
+        return;
+    }
+
+    // キャプチャと割り込みは入力ピンと同じ扱いにする
+    uint32_t edges = (next & bank.rising.load(std::memory_order_acquire)) |
+                     (~next & bank.falling.load(std::memory_order_acquire));
+    uint32_t capture = changed & bank.capture.load(std::memory_order_relaxed);
+    for (uint32_t bits = changed; bits; bits &= bits - 1) {
+        int bit        = lowestBitIndex(bits);
+        PinLevel level = ((next >> bit) & 0x01) ? PinLevel::High : PinLevel::Low;
+        if ((capture >> bit) & 0x01) {
+            captureLevel(bank_index * PINS_PER_BANK + bit, level);
+        }
+        if ((edges >> bit) & 0x01) {
+            postEdge(bank_index * PINS_PER_BANK + bit, level);
+        }
+    }
+
+    SimulatedWireListener* listener = wire_listener_.load(std::memory_order_acquire);
+    if (listener) {
+        listener->onWireChanged(bank_index, next, changed);
     }
 }
 
+uint32_t SimulatedPinTable::getLevels(int bank_index) const
+{
+    if (bank_index < 0 || bank_index >= bank_count_) {
+        return 0;
+    }
+
+    return banks_[bank_index].levels.load(std::memory_order_acquire);
+}
+
+void SimulatedPinTable::setCaptureEnabled(int pin_number, bool enable)
+{
+    if (!isValid(pin_number)) {
+        return;
+    }
+
+    Bank& bank   = banks_[pin_number / PINS_PER_BANK];
+    uint32_t bit = 1u << (pin_number % PINS_PER_BANK);
+    if (enable) {
+        bank.capture.fetch_or(bit, std::memory_order_acq_rel);
+    } else {
+        bank.capture.fetch_and(~bit, std::memory_order_acq_rel);
+    }
+}
+
+// SimulatedPin実装
+
+SimulatedPin::SimulatedPin(std::shared_ptr<SimulatedPinTable> table, int pin_number)
+    : table_(std::move(table)), pin_number_(pin_number)
+{
+}
+
+void SimulatedPin::setMode(PinMode mode)
+{
+    table_->setMode(pin_number_, mode);
+}
+
+void SimulatedPin::setLevel(PinLevel level)
+{
+    table_->setLevel(pin_number_, level);
+}
+
+PinLevel SimulatedPin::getLevel() const
+{
+    return table_->getLevel(pin_number_);
+}
+
+PinState SimulatedPin::getState() const
+{
+    return table_->getState(pin_number_);
+}
+
+void SimulatedPin::setExternalLevel(PinLevel level)
+{
+    table_->setExternalLevel(pin_number_, level);
+}
+
 // SimulatedGPIOPort実装
 
 SimulatedGPIOPort::SimulatedGPIOPort(int pin_count, const std::string& window_title)
-    : pin_count_(pin_count), window_visible_(false)
+    : pin_count_(pin_count), table_(std::make_shared<SimulatedPinTable>(pin_count)), window_visible_(false)
 {
     // ウィンドウ作成
     window_ = std::make_unique<framework::sdl::Window>(window_title, 800, 600);
@@ -88,14 +456,23 @@ SimulatedGPIOPort::SimulatedGPIOPort(int pin_count, const std::string& window_ti
     window_->addEventCallback([this](const SDL_Event& event) { return handleEvent(event); });
     window_->addRenderCallback([this](SDL_Renderer* renderer) { render(renderer); });
 
-    // ピンの初期化
+    // ピンの初期化（以降pins_は変更しないため、参照時のロックは不要）
+    pins_.reserve(pin_count_);
     for (int i = 0; i < pin_count_; ++i) {
-        pins_[i] = std::make_shared<SimulatedPin>(i);
+        pins_.push_back(std::make_shared<SimulatedPin>(table_, i));
     }
+
+    // 割り込みディスパッチャをテーブルに接続
+    interrupt_dispatcher_ = std::make_unique<SimulatedInterruptDispatcher>(pin_count_);
+    table_->setInterruptDispatcher(interrupt_dispatcher_.get());
 }
 
 SimulatedGPIOPort::~SimulatedGPIOPort()
 {
+    // ピンはポートより長く生存しうるため、ディスパッチャとの接続を切る。
+    // 通知中のスレッドが抜けるまで待ってから戻るため、この後ディスパッチャを破棄してよい
+    table_->setInterruptDispatcher(nullptr);
+
     // ウィンドウを閉じる
     if (window_) {
         window_->close();
@@ -104,45 +481,44 @@ SimulatedGPIOPort::~SimulatedGPIOPort()
 
 std::shared_ptr<IPin> SimulatedGPIOPort::getPin(int pin_number, GPIOImplementation impl)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    (void)impl;
 
     // 範囲外のピン番号
     if (pin_number < 0 || pin_number >= pin_count_) {
         return nullptr;
     }
 
-    // ピンがまだ作成されていなければ作成
-    if (pins_.find(pin_number) == pins_.end()) {
-        pins_[pin_number] = std::make_shared<SimulatedPin>(pin_number);
-    }
-
     return pins_[pin_number];
 }
 
 void SimulatedGPIOPort::pinMode(int pin_number, PinMode mode)
 {
-    auto pin = getPin(pin_number);
-    if (pin) {
-        pin->setMode(mode);
-    }
+    table_->setMode(pin_number, mode);
 }
 
 void SimulatedGPIOPort::digitalWrite(int pin_number, PinLevel level)
 {
-    auto pin = getPin(pin_number);
-    if (pin) {
-        pin->setLevel(level);
-    }
+    table_->setLevel(pin_number, level);
 }
 
 PinLevel SimulatedGPIOPort::digitalRead(int pin_number)
 {
-    auto pin = getPin(pin_number);
-    if (!pin) {
-        return PinLevel::Low;
-    }
+    return table_->getLevel(pin_number);
+}
 
-    return pin->getLevel();
+void SimulatedGPIOPort::setPinMode(int pin_number, PinMode mode)
+{
+    table_->setMode(pin_number, mode);
+}
+
+void SimulatedGPIOPort::writePin(int pin_number, PinLevel level)
+{
+    table_->setLevel(pin_number, level);
+}
+
+PinLevel SimulatedGPIOPort::readPin(int pin_number) const
+{
+    return table_->getLevel(pin_number);
 }
 
 void SimulatedGPIOPort::showWindow()
@@ -163,17 +539,8 @@ void SimulatedGPIOPort::hideWindow()
 
 void SimulatedGPIOPort::setLevels(uint32_t values, uint32_t mask)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    // マスクされたピンの値を設定
-    for (int i = 0; i < 32; ++i) {
-        if ((mask >> i) & 0x01) {
-            auto pin = getPin(i);
-            if (pin) {
-                pin->setLevel(((values >> i) & 0x01) ? PinLevel::High : PinLevel::Low);
-            }
-        }
-    }
+    // 先頭バンク（ピン0-31）を1回のアトミック操作で更新
+    table_->setLevels(0, values, mask);
 }
 
 bool SimulatedGPIOPort::update()
@@ -187,20 +554,78 @@ bool SimulatedGPIOPort::update()
 
 uint32_t SimulatedGPIOPort::getLevels() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    uint32_t result = 0;
+    return table_->getLevels(0);
+}
 
-    // 各ピンのレベルを取得してビットマップに変換
-    for (int i = 0; i < 32; ++i) {
-        auto it = pins_.find(i);
-        if (it != pins_.end()) {
-            if (it->second->getLevel() == PinLevel::High) {
-                result |= (1 << i);
-            }
-        }
+int SimulatedGPIOPort::getBankCount() const
+{
+    return table_->getBankCount();
+}
+
+void SimulatedGPIOPort::setLevels(int bank, uint32_t values, uint32_t mask)
+{
+    table_->setLevels(bank, values, mask);
+}
+
+uint32_t SimulatedGPIOPort::getLevels(int bank) const
+{
+    return table_->getLevels(bank);
+}
+
+bool SimulatedGPIOPort::attachInterrupt(int pin_number, PinEdge edge, PinInterruptCallback callback)
+{
+    if (!table_->isValid(pin_number) || !callback) {
+        return false;
     }
 
-    return result;
+    // コールバックを先に登録してからエッジ検出を有効にする
+    interrupt_dispatcher_->setCallback(pin_number, std::move(callback));
+    table_->setInterruptEdge(pin_number, (static_cast<uint8_t>(edge) & static_cast<uint8_t>(PinEdge::Rising)) != 0,
+                             (static_cast<uint8_t>(edge) & static_cast<uint8_t>(PinEdge::Falling)) != 0);
+    return true;
+}
+
+void SimulatedGPIOPort::detachInterrupt(int pin_number)
+{
+    table_->setInterruptEdge(pin_number, false, false);
+    interrupt_dispatcher_->clearCallback(pin_number);
+}
+
+bool SimulatedGPIOPort::execute(const GPIOProgram& program, uint32_t* samples, size_t sample_capacity)
+{
+    if (!program.validate(getBankCount(), samples ? sample_capacity : 0)) {
+        return false;
+    }
+
+    // ピン状態テーブルを直接操作する実行器
+    struct Executor {
+        SimulatedPinTable& table;
+
+        void setLevels(int bank, uint32_t values, uint32_t mask)
+        {
+            table.setLevels(bank, values, mask);
+        }
+
+        uint32_t getLevels(int bank, uint32_t mask)
+        {
+            return table.getLevels(bank) & mask;
+        }
+
+        void delayMicroseconds(uint32_t us)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        }
+
+        uint32_t micros()
+        {
+            return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+    };
+
+    Executor executor{*table_};
+    return runGPIOProgram(program, executor, samples);
 }
 
 bool SimulatedGPIOPort::begin()
@@ -247,16 +672,13 @@ bool SimulatedGPIOPort::handleEvent(const SDL_Event& event)
 
             if (pin_number < pin_count_) {
                 // ピンの状態を切り替え
-                auto pin = std::dynamic_pointer_cast<SimulatedPin>(getPin(pin_number));
-                if (pin) {
-                    PinState state = pin->getState();
-
-                    // 入力モードの場合はレベルを切り替え
-                    if (state == PinState::INPUT_LOW || state == PinState::INPUT_PULLDOWN) {
-                        pin->setExternalLevel(PinLevel::High);
-                    } else if (state == PinState::INPUT_HIGH || state == PinState::INPUT_PULLUP) {
-                        pin->setExternalLevel(PinLevel::Low);
-                    }
+                PinState state = table_->getState(pin_number);
+
+                // 入力モードの場合はレベルを切り替え
+                if (state == PinState::INPUT_LOW || state == PinState::INPUT_PULLDOWN) {
+                    table_->setExternalLevel(pin_number, PinLevel::High);
+                } else if (state == PinState::INPUT_HIGH || state == PinState::INPUT_PULLUP) {
+                    table_->setExternalLevel(pin_number, PinLevel::Low);
                 }
             }
         }
@@ -285,10 +707,7 @@ void SimulatedGPIOPort::render(SDL_Renderer* renderer)
         int x = col * pin_width + margin;
         int y = row * pin_height + margin;
 
-        auto pin = std::dynamic_pointer_cast<SimulatedPin>(getPin(i));
-        if (pin) {
-            drawPin(renderer, x, y, pin_width - 2 * margin, pin_height - 2 * margin, pin->getState(), i);
-        }
+        drawPin(renderer, x, y, pin_width - 2 * margin, pin_height - 2 * margin, table_->getState(i), i);
     }
 
     // タイトルとヘルプテキスト
@@ -0,0 +1,688 @@
+/**
+ * @file i2c.hpp
+ * @brief FlexHAL - デスクトップ向けI2Cシミュレーション
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef FLEXHAL_IMPL_PLATFORMS_DESKTOP_I2C_HPP
+#define FLEXHAL_IMPL_PLATFORMS_DESKTOP_I2C_HPP
+
+#include "../../../src/flexhal/i2c.hpp"
+#include "gpio.hpp"
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace flexhal {
+namespace platform {
+namespace desktop {
+
+/**
+ * @brief シミュレーション用I2Cデバイスモデルの基底クラス
+ *
+ * アドレスが一致した後のバイト単位の送受信を処理する
+ */
+class SimulatedI2CDevice {
+public:
+    virtual ~SimulatedI2CDevice() = default;
+
+    /**
+     * @brief アドレスが一致した（STARTまたはリピーテッドスタートの後）
+     *
+     * @param read 読み込み方向か
+     * @return true ACKを返す
+     * @return false NACKを返す
+     */
+    virtual bool start(bool read)
+    {
+        (void)read;
+        return true;
+    }
+
+    /**
+     * @brief マスタから1バイト受信
+     *
+     * @param data 受信したバイト
+     * @return true ACKを返す
+     * @return false NACKを返す
+     */
+    virtual bool write(uint8_t data) = 0;
+
+    /**
+     * @brief マスタへ送信する1バイトを取得
+     *
+     * @return uint8_t 送信するバイト
+     */
+    virtual uint8_t read() = 0;
+
+    /**
+     * @brief STOPを受信した
+     */
+    virtual void stop()
+    {
+    }
+
+    /**
+     * @brief トランザクションをバス占有時間として記録
+     *
+     * STARTごとのアドレスバイトとデータバイトをACKを含めて9クロック、START/STOPをそれぞれ1クロックとして算出する
+     *
+     * @param length 転送したデータのバイト数（アドレスを除く）
+     * @param starts START数（リピーテッドスタートを含む）
+     * @param clock_hz クロック周波数（Hz）
+     */
+    void recordTransfer(size_t length, size_t starts, uint32_t clock_hz)
+    {
+        transferred_bytes_.fetch_add(length, std::memory_order_relaxed);
+        transaction_count_.fetch_add(1, std::memory_order_relaxed);
+        if (clock_hz > 0) {
+            uint64_t clocks = (static_cast<uint64_t>(length) + starts) * 9 + starts + 1;
+            bus_time_ns_.fetch_add(clocks * 1000000000ull / clock_hz, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief モデル化したバス占有時間を取得
+     *
+     * @return uint64_t バス占有時間（ナノ秒）
+     */
+    uint64_t getBusTimeNanoseconds() const
+    {
+        return bus_time_ns_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 転送したデータのバイト数を取得
+     *
+     * @return uint64_t 転送したバイト数
+     */
+    uint64_t getTransferredBytes() const
+    {
+        return transferred_bytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief トランザクション数を取得
+     *
+     * @return uint64_t トランザクション数
+     */
+    uint64_t getTransactionCount() const
+    {
+        return transaction_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics()
+    {
+        bus_time_ns_.store(0, std::memory_order_relaxed);
+        transferred_bytes_.store(0, std::memory_order_relaxed);
+        transaction_count_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief デバイスの排他制御用ミューテックスを取得
+     *
+     * @return std::mutex& ミューテックス
+     */
+    std::mutex& getMutex() const
+    {
+        return mutex_;
+    }
+
+private:
+    std::atomic<uint64_t> bus_time_ns_{0};
+    std::atomic<uint64_t> transferred_bytes_{0};
+    std::atomic<uint64_t> transaction_count_{0};
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief 7ビットアドレスをキーにしたデバイスモデルの登録表
+ *
+ * 存在するアドレスを128ビットのビットマップでも保持し、プローブは1回のビット検査、
+ * スキャンは立っているビットだけの走査で応答する。
+ * ピンレベルのバスとトランザクションレベルの実装で共有でき、同じデバイスモデルが両方から見える
+ */
+class SimulatedI2CDeviceRegistry {
+public:
+    /**
+     * @brief 7ビットアドレスの最大値
+     */
+    static constexpr I2CAddress MAX_ADDRESS = I2CAddressBitmap::MAX_ADDRESS;
+
+    /**
+     * @brief デバイスモデルを登録
+     *
+     * @param address 7ビットアドレス
+     * @param device デバイスモデル
+     * @return true 登録成功
+     * @return false アドレスが範囲外または使用済み
+     */
+    bool attach(I2CAddress address, std::shared_ptr<SimulatedI2CDevice> device);
+
+    /**
+     * @brief デバイスモデルの登録を解除
+     *
+     * @param address 7ビットアドレス
+     */
+    void detach(I2CAddress address);
+
+    /**
+     * @brief 登録されたデバイスモデルを取得
+     *
+     * @param address 7ビットアドレス
+     * @return std::shared_ptr<SimulatedI2CDevice> デバイスモデル（未登録の場合はnullptr）
+     */
+    std::shared_ptr<SimulatedI2CDevice> find(I2CAddress address) const;
+
+    /**
+     * @brief 指定アドレスにデバイスモデルが登録されているか確認
+     *
+     * @param address 7ビットアドレス
+     * @return true 登録されている
+     * @return false 登録されていない
+     */
+    bool contains(I2CAddress address) const;
+
+    /**
+     * @brief 範囲内の登録済みアドレスを昇順に取得
+     *
+     * @param first 先頭アドレス
+     * @param last 末尾アドレス（範囲に含む）
+     * @return std::vector<I2CAddress> 登録済みアドレスのリスト
+     */
+    std::vector<I2CAddress> scan(I2CAddress first = I2C_SCAN_FIRST_ADDRESS,
+                                 I2CAddress last  = I2C_SCAN_LAST_ADDRESS) const;
+
+private:
+    std::shared_ptr<SimulatedI2CDevice> devices_[MAX_ADDRESS + 1];
+    I2CAddressBitmap present_;  ///< 登録済みアドレス
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief レジスタマップ型センサーデバイス
+ *
+ * 多くのI2Cセンサーと同じく、書き込みの先頭バイトをレジスタポインタとし、
+ * 以降のバイトでポインタを自動インクリメントしながら読み書きする。
+ * 読み込みは最後に設定されたポインタから始まる（リピーテッドスタートによるレジスタ読み出し）
+ */
+class SimulatedI2CRegisterMap : public SimulatedI2CDevice {
+public:
+    /**
+     * @brief レジスタ数
+     */
+    static constexpr size_t REGISTER_COUNT = 256;
+
+    bool start(bool read) override;
+    bool write(uint8_t data) override;
+    uint8_t read() override;
+
+    /**
+     * @brief レジスタ値を設定（デバイス側からの更新、読み取り専用レジスタも変更できる）
+     *
+     * @param address レジスタアドレス
+     * @param value 値
+     */
+    void setRegister(uint8_t address, uint8_t value);
+
+    /**
+     * @brief レジスタ値を取得
+     *
+     * @param address レジスタアドレス
+     * @return uint8_t 値
+     */
+    uint8_t getRegister(uint8_t address) const;
+
+    /**
+     * @brief レジスタを読み取り専用にする（マスタからの書き込みはACKを返して無視する）
+     *
+     * @param address レジスタアドレス
+     * @param read_only trueで読み取り専用
+     */
+    void setReadOnly(uint8_t address, bool read_only = true);
+
+private:
+    uint8_t registers_[REGISTER_COUNT] = {};
+    std::bitset<REGISTER_COUNT> read_only_;
+    bool pointer_phase_ = false;  ///< 次の書き込みバイトがレジスタポインタか
+    uint8_t pointer_    = 0;
+};
+
+/**
+ * @brief 24Cxxシリーズ互換のシリアルEEPROMデバイス
+ *
+ * 書き込みの先頭1バイト（容量256バイト以下）または2バイト（上位バイトが先）をメモリアドレスとし、
+ * 以降のデータをページバッファに取り込んでSTOPで書き込む。ページ境界を越えたデータは実機と同じく
+ * 同じページの先頭に戻って上書きする。連続読み込みはメモリの末尾から先頭に戻る。
+ * 書き込みサイクル時間を設定すると、その間はアドレスにNACKを返す（ACKポーリングの再現）。
+ * 24C04〜24C16のデバイスアドレスによるブロック選択はモデル化しない
+ */
+class SimulatedI2CEEPROM : public SimulatedI2CDevice {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param size 容量（バイト、ページサイズの倍数）
+     * @param page_size ページサイズ（バイト）
+     */
+    explicit SimulatedI2CEEPROM(size_t size = 4096, size_t page_size = 32);
+
+    /**
+     * @brief コンストラクタ（ファイルをメモリマップして内容を永続化）
+     *
+     * ファイルが容量より小さい場合は拡張し、拡張した領域は消去済み（0xFF）とする。
+     * マップに失敗した場合はメモリ上に確保する（isPersistent()で確認できる）
+     *
+     * @param path バッキングファイルのパス
+     * @param size 容量（バイト、ページサイズの倍数）
+     * @param page_size ページサイズ（バイト）
+     */
+    SimulatedI2CEEPROM(const std::string& path, size_t size = 4096, size_t page_size = 32);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~SimulatedI2CEEPROM();
+
+    SimulatedI2CEEPROM(const SimulatedI2CEEPROM&)            = delete;
+    SimulatedI2CEEPROM& operator=(const SimulatedI2CEEPROM&) = delete;
+
+    bool start(bool read) override;
+    bool write(uint8_t data) override;
+    uint8_t read() override;
+    void stop() override;
+
+    /**
+     * @brief 書き込みサイクル時間を設定
+     *
+     * @param duration STOPから書き込み完了までの時間（0で即時に完了）
+     */
+    void setWriteCycleTime(std::chrono::microseconds duration);
+
+    /**
+     * @brief 容量を取得
+     *
+     * @return size_t 容量（バイト）
+     */
+    size_t getSize() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief ページサイズを取得
+     *
+     * @return size_t ページサイズ（バイト）
+     */
+    size_t getPageSize() const
+    {
+        return page_size_;
+    }
+
+    /**
+     * @brief メモリ内容を直接参照
+     *
+     * @return uint8_t* メモリの先頭
+     */
+    uint8_t* getData()
+    {
+        return data_;
+    }
+
+    /**
+     * @brief メモリ内容がファイルに永続化されているか確認
+     *
+     * @return true ファイルにマップされている
+     * @return false メモリ上に確保されている
+     */
+    bool isPersistent() const
+    {
+        return mapping_ != nullptr;
+    }
+
+private:
+    /**
+     * @brief ページサイズを容量に収まる1以上の値に丸める
+     *
+     * @param size 容量
+     * @param page_size ページサイズ
+     * @return size_t 丸めたページサイズ
+     */
+    static size_t alignPageSize(size_t size, size_t page_size);
+
+    /**
+     * @brief 容量をページサイズの倍数に切り詰める
+     *
+     * @param size 容量
+     * @param page_size ページサイズ
+     * @return size_t 切り詰めた容量
+     */
+    static size_t alignSize(size_t size, size_t page_size);
+
+    /**
+     * @brief ファイルをメモリマップ
+     *
+     * @param path バッキングファイルのパス
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool mapFile(const std::string& path);
+
+    std::vector<uint8_t> memory_;  ///< メモリ上に確保する場合の領域
+    uint8_t* data_ = nullptr;
+    size_t size_;
+    size_t page_size_;
+    int address_bytes_;        ///< メモリアドレスのバイト数
+    void* mapping_ = nullptr;  ///< ファイルにマップした領域
+
+    // 転送中の状態
+    int address_count_  = 0;      ///< 受信したメモリアドレスのバイト数
+    size_t address_     = 0;      ///< 現在のメモリアドレス
+    bool page_pending_  = false;  ///< ページバッファに書き込み待ちのデータがあるか
+    size_t page_base_   = 0;      ///< ページバッファのメモリアドレス
+    std::vector<uint8_t> page_;   ///< ページバッファ
+
+    std::chrono::microseconds write_cycle_{0};
+    std::chrono::steady_clock::time_point busy_until_;
+};
+
+/**
+ * @brief シミュレーションI2Cトランスポート
+ *
+ * ピンを操作せず、登録表から引いたデバイスモデルへトランザクション単位でデータを直接渡す。
+ * デバイスモデルのACK/NACKは実機と同じく戻り値に反映し、転送ごとにクロック周波数から
+ * バス占有時間を算出してデバイスモデルに積算する。プローブとスキャンもデバイスモデルに
+ * アドレスを送って応答を確認し、アドレスだけのトランザクションとして積算する
+ */
+class SimulatedI2CTransport : public II2CTransport {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param registry デバイスモデルの登録表
+     * @param device_config デバイス設定
+     */
+    SimulatedI2CTransport(std::shared_ptr<SimulatedI2CDeviceRegistry> registry, const I2CDeviceConfig& device_config);
+
+    bool begin() override;
+    void end() override;
+    bool isReady() const override;
+
+    ssize_t write(const void* data, size_t length) override;
+    ssize_t read(void* data, size_t length) override;
+    ssize_t transfer(const void* tx_data, void* rx_data, size_t length) override;
+    ssize_t writeRead(const void* tx_data, size_t tx_length, void* rx_data, size_t rx_length) override;
+    ssize_t writev(const TransferSegment* segments, size_t count) override;
+
+    bool supportsAsync() const override
+    {
+        return false;
+    }
+
+    void setAddress(I2CAddress address) override;
+    std::vector<I2CAddress> scan() override;
+    bool probe(I2CAddress address) override;
+
+    /**
+     * @brief バス占有時間の算出に使うクロック周波数を設定
+     *
+     * @param hz クロック周波数（Hz、0で時間を積算しない）
+     */
+    void setClockFrequency(uint32_t hz);
+
+private:
+    /**
+     * @brief 1回のトランザクションを実行
+     *
+     * 書き込む区間があれば（読み込みがない場合は0バイトでも）書き込み方向のアドレスに続けて送信し、
+     * 読み込みがあればリピーテッドスタートで読み込み方向に切り替える。最後にSTOPを送る
+     *
+     * @param segments 書き込む区間の配列
+     * @param count 区間数
+     * @param rx_data 読み込み先バッファ
+     * @param rx_length 読み込むバイト数
+     * @return ssize_t 読み込みがあれば読み込んだバイト数、なければACKされたバイト数（アドレスのNACKは-1）
+     */
+    ssize_t transaction(const TransferSegment* segments, size_t count, uint8_t* rx_data, size_t rx_length);
+
+    std::shared_ptr<SimulatedI2CDeviceRegistry> registry_;
+    I2CDeviceConfig config_;
+    bool initialized_ = false;
+};
+
+/**
+ * @brief シミュレーションI2C実装
+ *
+ * I2CBus::addImplementation() で登録し、アドレスごとにデバイスモデルを接続して使用する。
+ * 1つの実装が1本のバスに相当し、未接続のアドレスにもトランスポートを作成する（転送はNACKになる）
+ */
+class SimulatedI2CImplementation : public I2CBusImplementation {
+public:
+    SimulatedI2CImplementation() : registry_(std::make_shared<SimulatedI2CDeviceRegistry>())
+    {
+    }
+
+    bool isAvailable() const override
+    {
+        return true;
+    }
+
+    std::shared_ptr<II2CTransport> createTransport(const I2CBusConfig& bus_config,
+                                                   const I2CDeviceConfig& device_config) override;
+
+    /**
+     * @brief デバイスモデルを接続
+     *
+     * @param address 7ビットアドレス
+     * @param device デバイスモデル
+     * @return true 接続成功
+     * @return false アドレスが範囲外または使用済み
+     */
+    bool attachDevice(I2CAddress address, std::shared_ptr<SimulatedI2CDevice> device)
+    {
+        return registry_->attach(address, std::move(device));
+    }
+
+    /**
+     * @brief デバイスモデルを切り離す
+     *
+     * @param address 7ビットアドレス
+     */
+    void detachDevice(I2CAddress address)
+    {
+        registry_->detach(address);
+    }
+
+    /**
+     * @brief 接続されたデバイスモデルを取得
+     *
+     * @param address 7ビットアドレス
+     * @return std::shared_ptr<SimulatedI2CDevice> デバイスモデル（未接続の場合はnullptr）
+     */
+    std::shared_ptr<SimulatedI2CDevice> getDevice(I2CAddress address) const
+    {
+        return registry_->find(address);
+    }
+
+    /**
+     * @brief デバイスモデルの登録表を取得（SimulatedI2CPinBus と共有する場合に使用）
+     *
+     * @return std::shared_ptr<SimulatedI2CDeviceRegistry> 登録表
+     */
+    std::shared_ptr<SimulatedI2CDeviceRegistry> getRegistry() const
+    {
+        return registry_;
+    }
+
+private:
+    std::shared_ptr<SimulatedI2CDeviceRegistry> registry_;
+};
+
+/**
+ * @brief ピン状態テーブル上のI2Cバスのスレーブ側モデル
+ *
+ * オープンドレインにしたSDA/SCLピンのレベル変化を同期的に受け取り、START/STOPとビットを復号して
+ * 登録表のデバイスモデルに渡す。ACKと読み込みデータは、SCLの立ち下がりで外部からの引き込みとして
+ * SDAに出力するため、ソフトウェアI2Cなどのピンを操作するマスタと実機と同じ手順で通信できる。
+ * クロックストレッチを設定すると、各バイトのACKの後にSCLを指定時間Lowに保持する
+ */
+class SimulatedI2CPinBus : public SimulatedWireListener {
+public:
+    /**
+     * @brief コンストラクタ（ピン状態テーブルの通知先として登録する）
+     *
+     * @param table ピン状態テーブル
+     * @param sda_pin SDAピン番号
+     * @param scl_pin SCLピン番号
+     * @param registry デバイスモデルの登録表（nullptrの場合は専用の登録表を作成する）
+     */
+    SimulatedI2CPinBus(std::shared_ptr<SimulatedPinTable> table, int sda_pin, int scl_pin,
+                       std::shared_ptr<SimulatedI2CDeviceRegistry> registry = nullptr);
+
+    /**
+     * @brief デストラクタ（通知先の登録を解除し、保持しているピンを開放する）
+     */
+    ~SimulatedI2CPinBus();
+
+    SimulatedI2CPinBus(const SimulatedI2CPinBus&)            = delete;
+    SimulatedI2CPinBus& operator=(const SimulatedI2CPinBus&) = delete;
+
+    /**
+     * @brief デバイスを接続
+     *
+     * @param address 7ビットアドレス
+     * @param device デバイスモデル
+     * @return true 接続成功
+     * @return false アドレスが範囲外または使用済み
+     */
+    bool addDevice(I2CAddress address, std::shared_ptr<SimulatedI2CDevice> device);
+
+    /**
+     * @brief デバイスを切断
+     *
+     * @param address 7ビットアドレス
+     */
+    void removeDevice(I2CAddress address);
+
+    /**
+     * @brief デバイスモデルの登録表を取得
+     *
+     * @return std::shared_ptr<SimulatedI2CDeviceRegistry> 登録表
+     */
+    std::shared_ptr<SimulatedI2CDeviceRegistry> getRegistry() const
+    {
+        return registry_;
+    }
+
+    /**
+     * @brief クロックストレッチの時間を設定
+     *
+     * @param duration 各バイトのACKの後にSCLを保持する時間（0で保持しない）
+     */
+    void setClockStretch(std::chrono::microseconds duration);
+
+    /**
+     * @brief SCLをLowに保持し続ける（応答しないスレーブの再現）
+     *
+     * @param hold trueで保持、falseで開放
+     */
+    void holdClock(bool hold);
+
+    /**
+     * @brief 受信したSTART数を取得（リピーテッドスタートを含む）
+     *
+     * @return uint64_t START数
+     */
+    uint64_t getStartCount() const;
+
+    void onWireChanged(int bank, uint32_t levels, uint32_t changed) override;
+
+private:
+    /**
+     * @brief 復号の状態
+     */
+    enum class State {
+        Idle,     ///< STOP後、または応答しないトランザクション中
+        Address,  ///< アドレスを受信中
+        Write,    ///< マスタからのデータを受信中
+        Read,     ///< マスタへデータを送信中
+    };
+
+    /**
+     * @brief SCLの立ち上がり（データの取り込み）
+     *
+     * @param sda SDAのレベル
+     */
+    void onClockRising(bool sda);
+
+    /**
+     * @brief SCLの立ち下がり（ACKと送信データの出力）
+     */
+    void onClockFalling();
+
+    /**
+     * @brief 受信した1バイトを処理し、ACKを出力
+     */
+    void receiveByte();
+
+    /**
+     * @brief SDAを駆動（trueで開放、falseで引き込み）
+     */
+    void driveSDA(bool high);
+
+    /**
+     * @brief SCLを引き込み、クロックストレッチを開始
+     */
+    void stretchClock();
+
+    /**
+     * @brief クロックストレッチを解除するスレッドの処理
+     */
+    void stretchLoop();
+
+    std::shared_ptr<SimulatedPinTable> table_;
+    int sda_pin_;
+    int scl_pin_;
+    std::shared_ptr<SimulatedI2CDeviceRegistry> registry_;
+
+    State state_ = State::Idle;
+    std::shared_ptr<SimulatedI2CDevice> selected_;  ///< アドレスが一致したデバイス
+    bool sda_             = true;   ///< 最後に観測したSDAのレベル
+    bool scl_             = true;   ///< 最後に観測したSCLのレベル
+    bool driving_         = false;  ///< 自身の駆動による通知を無視するためのフラグ
+    bool ack_phase_       = false;  ///< 9クロック目か
+    bool ack_             = false;  ///< 受信したバイトにACKを返したか
+    bool master_ack_      = false;  ///< 読み込み時にマスタがACKを返したか
+    int bit_count_        = 0;      ///< 現在のバイトで処理したビット数
+    uint8_t shift_        = 0;      ///< 送受信中のバイト
+    uint64_t start_count_ = 0;
+
+    std::chrono::microseconds stretch_{0};
+    std::chrono::steady_clock::time_point stretch_until_;
+    bool stretching_ = false;  ///< クロックストレッチでSCLを保持しているか
+    bool clock_held_ = false;  ///< holdClock() でSCLを保持しているか
+    bool running_    = true;
+    std::thread stretch_thread_;
+    std::condition_variable_any stretch_cv_;
+    mutable std::recursive_mutex mutex_;
+};
+
+}  // namespace desktop
+}  // namespace platform
+}  // namespace flexhal
+
+#endif  // FLEXHAL_IMPL_PLATFORMS_DESKTOP_I2C_HPP
@@ -0,0 +1,708 @@
+/**
+ * @file i2c.inl
+ * @brief FlexHAL - デスクトップ向けI2Cシミュレーションの実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "i2c.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace flexhal {
+namespace platform {
+namespace desktop {
+
+// SimulatedI2CDeviceRegistry実装
+
+bool SimulatedI2CDeviceRegistry::attach(I2CAddress address, std::shared_ptr<SimulatedI2CDevice> device)
+{
+    if (address > MAX_ADDRESS || !device) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (devices_[address]) {
+        return false;
+    }
+    devices_[address] = std::move(device);
+    present_.set(address);
+    return true;
+}
+
+void SimulatedI2CDeviceRegistry::detach(I2CAddress address)
+{
+    if (address > MAX_ADDRESS) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_[address].reset();
+    present_.reset(address);
+}
+
+std::shared_ptr<SimulatedI2CDevice> SimulatedI2CDeviceRegistry::find(I2CAddress address) const
+{
+    if (address > MAX_ADDRESS) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return devices_[address];
+}
+
+bool SimulatedI2CDeviceRegistry::contains(I2CAddress address) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return present_.test(address);
+}
+
+std::vector<I2CAddress> SimulatedI2CDeviceRegistry::scan(I2CAddress first, I2CAddress last) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (present_ & I2CAddressBitmap::range(first, last)).toVector();
+}
+
+// SimulatedI2CRegisterMap実装
+
+bool SimulatedI2CRegisterMap::start(bool read)
+{
+    pointer_phase_ = !read;
+    return true;
+}
+
+bool SimulatedI2CRegisterMap::write(uint8_t data)
+{
+    if (pointer_phase_) {
+        pointer_       = data;
+        pointer_phase_ = false;
+        return true;
+    }
+    if (!read_only_[pointer_]) {
+        registers_[pointer_] = data;
+    }
+    ++pointer_;
+    return true;
+}
+
+uint8_t SimulatedI2CRegisterMap::read()
+{
+    return registers_[pointer_++];
+}
+
+void SimulatedI2CRegisterMap::setRegister(uint8_t address, uint8_t value)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    registers_[address] = value;
+}
+
+uint8_t SimulatedI2CRegisterMap::getRegister(uint8_t address) const
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    return registers_[address];
+}
+
+void SimulatedI2CRegisterMap::setReadOnly(uint8_t address, bool read_only)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    read_only_[address] = read_only;
+}
+
+// SimulatedI2CEEPROM実装
+
+SimulatedI2CEEPROM::SimulatedI2CEEPROM(size_t size, size_t page_size)
+    : memory_(alignSize(size, page_size), 0xFF),
+      data_(memory_.data()),
+      size_(memory_.size()),
+      page_size_(alignPageSize(size_, page_size)),
+      address_bytes_(size_ > 256 ? 2 : 1),
+      page_(page_size_)
+{
+}
+
+SimulatedI2CEEPROM::SimulatedI2CEEPROM(const std::string& path, size_t size, size_t page_size)
+    : size_(alignSize(size, page_size)),
+      page_size_(alignPageSize(size_, page_size)),
+      address_bytes_(size_ > 256 ? 2 : 1),
+      page_(page_size_)
+{
+    if (!mapFile(path)) {
+        memory_.assign(size_, 0xFF);
+        data_ = memory_.data();
+    }
+}
+
+SimulatedI2CEEPROM::~SimulatedI2CEEPROM()
+{
+    if (mapping_) {
+        msync(mapping_, size_, MS_SYNC);
+        munmap(mapping_, size_);
+    }
+}
+
+size_t SimulatedI2CEEPROM::alignPageSize(size_t size, size_t page_size)
+{
+    return std::min(std::max<size_t>(1, page_size), size);
+}
+
+size_t SimulatedI2CEEPROM::alignSize(size_t size, size_t page_size)
+{
+    page_size = std::max<size_t>(1, page_size);
+    return std::max(page_size, size - size % page_size);
+}
+
+bool SimulatedI2CEEPROM::mapFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (static_cast<size_t>(st.st_size) < size_ && ftruncate(fd, size_) != 0)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // 拡張した領域（ファイル上は0）を消去済みの状態にする
+    mapping_ = mapping;
+    data_    = static_cast<uint8_t*>(mapping);
+    if (static_cast<size_t>(st.st_size) < size_) {
+        std::memset(data_ + st.st_size, 0xFF, size_ - st.st_size);
+    }
+    return true;
+}
+
+bool SimulatedI2CEEPROM::start(bool read)
+{
+    // 書き込みサイクル中はアドレスにも応答しない
+    if (write_cycle_.count() > 0 && std::chrono::steady_clock::now() < busy_until_) {
+        return false;
+    }
+
+    // STOPを待たずにリピーテッドスタートされた書き込みは破棄される
+    page_pending_ = false;
+    if (!read) {
+        address_count_ = 0;
+    }
+    return true;
+}
+
+bool SimulatedI2CEEPROM::write(uint8_t data)
+{
+    if (address_count_ < address_bytes_) {
+        address_ = address_count_ == 0 ? data : (address_ << 8) | data;
+        address_ %= size_;
+        ++address_count_;
+        return true;
+    }
+
+    // 最初のデータでページを取り込み、以降はページ内でアドレスを循環させる
+    if (!page_pending_) {
+        page_base_ = address_ - address_ % page_size_;
+        std::memcpy(page_.data(), data_ + page_base_, page_size_);
+        page_pending_ = true;
+    }
+    size_t offset = address_ - page_base_;
+    page_[offset] = data;
+    address_      = page_base_ + (offset + 1) % page_size_;
+    return true;
+}
+
+uint8_t SimulatedI2CEEPROM::read()
+{
+    uint8_t value = data_[address_];
+    address_      = (address_ + 1) % size_;
+    return value;
+}
+
+void SimulatedI2CEEPROM::stop()
+{
+    if (!page_pending_) {
+        return;
+    }
+
+    // STOPで書き込みサイクルを開始し、ページ単位でまとめて書き込む
+    std::memcpy(data_ + page_base_, page_.data(), page_size_);
+    page_pending_ = false;
+    busy_until_   = std::chrono::steady_clock::now() + write_cycle_;
+}
+
+void SimulatedI2CEEPROM::setWriteCycleTime(std::chrono::microseconds duration)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    write_cycle_ = duration;
+}
+
+// SimulatedI2CTransport実装
+
+SimulatedI2CTransport::SimulatedI2CTransport(std::shared_ptr<SimulatedI2CDeviceRegistry> registry,
+                                             const I2CDeviceConfig& device_config)
+    : registry_(std::move(registry)), config_(device_config)
+{
+}
+
+bool SimulatedI2CTransport::begin()
+{
+    initialized_ = registry_ != nullptr;
+    return initialized_;
+}
+
+void SimulatedI2CTransport::end()
+{
+    initialized_ = false;
+}
+
+bool SimulatedI2CTransport::isReady() const
+{
+    return initialized_;
+}
+
+ssize_t SimulatedI2CTransport::write(const void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return -1;
+    }
+
+    TransferSegment segment;
+    segment.tx_data = data;
+    segment.length  = length;
+    return transaction(&segment, 1, nullptr, 0);
+}
+
+ssize_t SimulatedI2CTransport::read(void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return -1;
+    }
+    return transaction(nullptr, 0, static_cast<uint8_t*>(data), length);
+}
+
+ssize_t SimulatedI2CTransport::transfer(const void* tx_data, void* rx_data, size_t length)
+{
+    // I2Cは全二重ではないため、送信データを書き込んだ後にリピーテッドスタートで同じ長さを読み込む
+    return writeRead(tx_data, tx_data ? length : 0, rx_data, rx_data ? length : 0);
+}
+
+ssize_t SimulatedI2CTransport::writeRead(const void* tx_data, size_t tx_length, void* rx_data, size_t rx_length)
+{
+    if (!initialized_ || (!tx_data && tx_length > 0) || (!rx_data && rx_length > 0)) {
+        return -1;
+    }
+
+    TransferSegment segment;
+    segment.tx_data = tx_data;
+    segment.length  = tx_length;
+    ssize_t result  = transaction(&segment, tx_length > 0 ? 1 : 0, static_cast<uint8_t*>(rx_data), rx_length);
+    if (rx_length == 0) {
+        return result == static_cast<ssize_t>(tx_length) ? 0 : -1;
+    }
+    return result;
+}
+
+ssize_t SimulatedI2CTransport::writev(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].tx_data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+
+    // 各区間を結合せず、1回のSTART〜STOPの中で順にデバイスモデルへ渡す
+    return transaction(segments, count, nullptr, 0);
+}
+
+void SimulatedI2CTransport::setAddress(I2CAddress address)
+{
+    config_.address = address;
+}
+
+std::vector<I2CAddress> SimulatedI2CTransport::scan()
+{
+    std::vector<I2CAddress> found;
+    if (!initialized_) {
+        return found;
+    }
+
+    // 接続されているアドレスだけを実際にプローブし、応答したものを返す
+    for (I2CAddress address : registry_->scan()) {
+        if (probe(address)) {
+            found.push_back(address);
+        }
+    }
+    return found;
+}
+
+bool SimulatedI2CTransport::probe(I2CAddress address)
+{
+    if (!initialized_) {
+        return false;
+    }
+    auto device = registry_->find(address);
+    if (!device) {
+        return false;
+    }
+
+    // 書き込み方向のアドレスだけを送ってSTOPする。書き込みサイクル中のEEPROMなどはNACKを返す
+    std::lock_guard<std::mutex> lock(device->getMutex());
+    bool ack = device->start(false);
+    device->stop();
+    device->recordTransfer(0, 1, config_.clock_hz);
+    return ack;
+}
+
+void SimulatedI2CTransport::setClockFrequency(uint32_t hz)
+{
+    config_.clock_hz = hz;
+}
+
+ssize_t SimulatedI2CTransport::transaction(const TransferSegment* segments, size_t count, uint8_t* rx_data,
+                                           size_t rx_length)
+{
+    auto device = registry_->find(config_.address);
+    if (!device) {
+        notifyNack(config_.address);
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(device->getMutex());
+    bool addressed    = true;
+    size_t starts     = 0;
+    size_t wire_bytes = 0;  // アドレスを除いてバス上に流れたバイト数
+    ssize_t result    = -1;
+    bool completed    = true;
+
+    if (count > 0 || rx_length == 0) {
+        ++starts;
+        addressed      = device->start(false);
+        size_t acked   = 0;
+        completed      = addressed;
+        for (size_t i = 0; i < count && completed; ++i) {
+            const uint8_t* data = static_cast<const uint8_t*>(segments[i].tx_data);
+            for (size_t n = 0; n < segments[i].length; ++n) {
+                // NACKされたバイトもバス上には流れている
+                ++wire_bytes;
+                if (!device->write(data[n])) {
+                    completed = false;
+                    break;
+                }
+                ++acked;
+            }
+        }
+        result = addressed ? static_cast<ssize_t>(acked) : -1;
+    }
+
+    if (rx_length > 0) {
+        result = -1;
+        if (completed) {
+            ++starts;
+            addressed = device->start(true);
+            if (addressed) {
+                for (size_t i = 0; i < rx_length; ++i) {
+                    rx_data[i] = device->read();
+                }
+                wire_bytes += rx_length;
+                result = static_cast<ssize_t>(rx_length);
+            }
+        }
+    }
+
+    device->stop();
+    device->recordTransfer(wire_bytes, starts, config_.clock_hz);
+    if (!addressed) {
+        notifyNack(config_.address);
+    }
+    return result;
+}
+
+// SimulatedI2CImplementation実装
+
+std::shared_ptr<II2CTransport> SimulatedI2CImplementation::createTransport(const I2CBusConfig& bus_config,
+                                                                           const I2CDeviceConfig& device_config)
+{
+    (void)bus_config;
+    return std::make_shared<SimulatedI2CTransport>(registry_, device_config);
+}
+
+// SimulatedI2CPinBus実装
+
+SimulatedI2CPinBus::SimulatedI2CPinBus(std::shared_ptr<SimulatedPinTable> table, int sda_pin, int scl_pin,
+                                       std::shared_ptr<SimulatedI2CDeviceRegistry> registry)
+    : table_(std::move(table)),
+      sda_pin_(sda_pin),
+      scl_pin_(scl_pin),
+      registry_(registry ? std::move(registry) : std::make_shared<SimulatedI2CDeviceRegistry>())
+{
+    sda_ = table_->getLevel(sda_pin_) == PinLevel::High;
+    scl_ = table_->getLevel(scl_pin_) == PinLevel::High;
+    table_->setWireListener(this);
+}
+
+SimulatedI2CPinBus::~SimulatedI2CPinBus()
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        running_ = false;
+    }
+    stretch_cv_.notify_all();
+    if (stretch_thread_.joinable()) {
+        stretch_thread_.join();
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    driving_ = true;
+    table_->setExternalLevel(sda_pin_, PinLevel::High);
+    table_->setExternalLevel(scl_pin_, PinLevel::High);
+    table_->setWireListener(nullptr);
+}
+
+bool SimulatedI2CPinBus::addDevice(I2CAddress address, std::shared_ptr<SimulatedI2CDevice> device)
+{
+    return registry_->attach(address, std::move(device));
+}
+
+void SimulatedI2CPinBus::removeDevice(I2CAddress address)
+{
+    registry_->detach(address);
+}
+
+void SimulatedI2CPinBus::setClockStretch(std::chrono::microseconds duration)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    stretch_ = duration;
+    if (stretch_.count() > 0 && !stretch_thread_.joinable()) {
+        stretch_thread_ = std::thread(&SimulatedI2CPinBus::stretchLoop, this);
+    }
+}
+
+void SimulatedI2CPinBus::holdClock(bool hold)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    clock_held_ = hold;
+    if (hold) {
+        driving_ = true;
+        table_->setExternalLevel(scl_pin_, PinLevel::Low);
+        driving_ = false;
+        scl_     = table_->getLevel(scl_pin_) == PinLevel::High;
+    } else if (!stretching_) {
+        // 開放による立ち上がりはマスタのクロックとして通常どおり処理する
+        table_->setExternalLevel(scl_pin_, PinLevel::High);
+    }
+}
+
+uint64_t SimulatedI2CPinBus::getStartCount() const
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return start_count_;
+}
+
+void SimulatedI2CPinBus::onWireChanged(int bank, uint32_t levels, uint32_t changed)
+{
+    (void)bank;
+    (void)levels;
+    (void)changed;
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (driving_) {
+        return;
+    }
+
+    bool sda = table_->getLevel(sda_pin_) == PinLevel::High;
+    bool scl = table_->getLevel(scl_pin_) == PinLevel::High;
+    if (sda == sda_ && scl == scl_) {
+        return;
+    }
+    bool sda_changed = sda != sda_;
+    bool scl_changed = scl != scl_;
+    sda_             = sda;
+    scl_             = scl;
+
+    if (scl_changed) {
+        if (scl) {
+            onClockRising(sda);
+        } else {
+            onClockFalling();
+        }
+        return;
+    }
+    if (!scl || !sda_changed) {
+        return;
+    }
+
+    if (!sda) {
+        // SCLがHighの間のSDAの立ち下がりはSTART（リピーテッドスタートを含む）
+        ++start_count_;
+        state_     = State::Address;
+        ack_phase_ = false;
+        bit_count_ = 0;
+        shift_     = 0;
+        selected_.reset();
+    } else {
+        // SCLがHighの間のSDAの立ち上がりはSTOP
+        if (selected_) {
+            std::lock_guard<std::mutex> device_lock(selected_->getMutex());
+            selected_->stop();
+        }
+        selected_.reset();
+        state_     = State::Idle;
+        ack_phase_ = false;
+    }
+}
+
+void SimulatedI2CPinBus::onClockRising(bool sda)
+{
+    if (ack_phase_) {
+        if (state_ == State::Read) {
+            master_ack_ = !sda;
+        }
+        return;
+    }
+    if (state_ == State::Address || state_ == State::Write) {
+        shift_ = static_cast<uint8_t>((shift_ << 1) | (sda ? 0x01 : 0x00));
+        ++bit_count_;
+    }
+}
+
+void SimulatedI2CPinBus::onClockFalling()
+{
+    if (state_ == State::Idle) {
+        return;
+    }
+
+    if (ack_phase_) {
+        // 9クロック目の終わり。次のバイトの準備をする
+        ack_phase_ = false;
+        if (state_ == State::Read) {
+            if (!master_ack_) {
+                state_ = State::Idle;
+                return;
+            }
+        } else {
+            driveSDA(true);
+            if (!ack_) {
+                state_ = State::Idle;
+                return;
+            }
+            if (state_ == State::Address) {
+                state_ = (shift_ & 0x01) ? State::Read : State::Write;
+            }
+        }
+        bit_count_ = 0;
+        if (state_ == State::Read) {
+            {
+                std::lock_guard<std::mutex> device_lock(selected_->getMutex());
+                shift_ = selected_->read();
+            }
+            driveSDA((shift_ & 0x80) != 0);
+        } else {
+            shift_ = 0;
+        }
+        stretchClock();
+        return;
+    }
+
+    if (state_ == State::Read) {
+        // 送信中のバイトの次のビットを出力し、8ビット目の後はマスタのACKのために開放する
+        ++bit_count_;
+        if (bit_count_ < 8) {
+            driveSDA(((shift_ >> (7 - bit_count_)) & 0x01) != 0);
+        } else {
+            driveSDA(true);
+            ack_phase_ = true;
+        }
+        return;
+    }
+
+    if (bit_count_ == 8) {
+        receiveByte();
+    }
+}
+
+void SimulatedI2CPinBus::receiveByte()
+{
+    bool ack = false;
+    if (state_ == State::Address) {
+        auto device = registry_->find(static_cast<I2CAddress>(shift_ >> 1));
+        if (device) {
+            std::lock_guard<std::mutex> device_lock(device->getMutex());
+            ack = device->start((shift_ & 0x01) != 0);
+        }
+        if (ack) {
+            selected_ = std::move(device);
+        }
+    } else if (selected_) {
+        std::lock_guard<std::mutex> device_lock(selected_->getMutex());
+        ack = selected_->write(shift_);
+    }
+
+    // アドレスの方向ビットは9クロック目の終わりまで shift_ に残す
+    ack_       = ack;
+    ack_phase_ = true;
+    if (ack) {
+        driveSDA(false);
+    }
+}
+
+void SimulatedI2CPinBus::driveSDA(bool high)
+{
+    driving_ = true;
+    table_->setExternalLevel(sda_pin_, high ? PinLevel::High : PinLevel::Low);
+    driving_ = false;
+    sda_     = table_->getLevel(sda_pin_) == PinLevel::High;
+}
+
+void SimulatedI2CPinBus::stretchClock()
+{
+    if (stretch_.count() <= 0 || clock_held_) {
+        return;
+    }
+
+    // マスタがSCLを引き込んだ直後なので、レベルは変化しない
+    driving_ = true;
+    table_->setExternalLevel(scl_pin_, PinLevel::Low);
+    driving_       = false;
+    stretch_until_ = std::chrono::steady_clock::now() + stretch_;
+    stretching_    = true;
+    stretch_cv_.notify_all();
+}
+
+void SimulatedI2CPinBus::stretchLoop()
+{
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    while (running_) {
+        stretch_cv_.wait(lock, [this] { return !running_ || stretching_; });
+        if (!running_) {
+            break;
+        }
+        stretch_cv_.wait_until(lock, stretch_until_, [this] { return !running_; });
+        if (!running_) {
+            break;
+        }
+
+        // 開放による立ち上がりはマスタのクロックとして通常どおり処理する
+        stretching_ = false;
+        if (!clock_held_) {
+            table_->setExternalLevel(scl_pin_, PinLevel::High);
+        }
+    }
+}
+
+}  // namespace desktop
+}  // namespace platform
+}  // namespace flexhal
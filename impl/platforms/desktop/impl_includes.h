@@ -14,9 +14,9 @@
 #include "core.inl"
 #include "factory.inl"
 #include "gpio.inl"
+#include "capture.inl"
+#include "spi.inl"
+#include "i2c.inl"
 #include "logger.inl"
 
 // 将来的に追加される実装ファイルもここに追加
-// #include "spi.cpp"
-// #include "i2c.cpp"
-// など
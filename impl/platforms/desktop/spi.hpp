@@ -0,0 +1,606 @@
+/**
+ * @file spi.hpp
+ * @brief FlexHAL - デスクトップ向けSPIシミュレーション
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef FLEXHAL_IMPL_PLATFORMS_DESKTOP_SPI_HPP
+#define FLEXHAL_IMPL_PLATFORMS_DESKTOP_SPI_HPP
+
+#include "../../../src/flexhal/spi.hpp"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace flexhal {
+namespace platform {
+namespace desktop {
+
+/**
+ * @brief シミュレーション用SPIデバイスモデルの基底クラス
+ *
+ * CSで選択されている間に転送されたデータを、呼び出し元のバッファから直接処理する。
+ * 転送のたびにクロック周波数からバス占有時間を算出して積算する。
+ */
+class SimulatedSPIDevice {
+public:
+    virtual ~SimulatedSPIDevice() = default;
+
+    /**
+     * @brief CSがアクティブになった
+     */
+    virtual void select()
+    {
+    }
+
+    /**
+     * @brief CSが非アクティブになった
+     */
+    virtual void deselect()
+    {
+    }
+
+    /**
+     * @brief データを送受信
+     *
+     * @param tx_data 受信するデータ（nullptrの場合は0xFFが送られたものとする）
+     * @param rx_data 応答の格納先（nullptrの場合は応答を捨てる）
+     * @param length データ長
+     */
+    virtual void transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) = 0;
+
+    /**
+     * @brief DCピンのレベルが変化した
+     *
+     * @param dc_level DCピンのレベル
+     */
+    virtual void setDC(bool dc_level)
+    {
+        (void)dc_level;
+    }
+
+    /**
+     * @brief デバイスのビットオーダーを設定
+     *
+     * トランスポートのビットオーダーと異なる場合、実機と同じく各バイトのビット順が反転して届く
+     *
+     * @param bit_order ビットオーダー（デフォルトはMSBファースト）
+     */
+    void setBitOrder(SPIBitOrder bit_order)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bit_order_ = bit_order;
+    }
+
+    /**
+     * @brief デバイスのビットオーダーを取得（デバイスのロック取得済みで呼び出す）
+     *
+     * @return SPIBitOrder ビットオーダー
+     */
+    SPIBitOrder getBitOrder() const
+    {
+        return bit_order_;
+    }
+
+    /**
+     * @brief 転送をバス占有時間として記録
+     *
+     * @param length 転送したバイト数
+     * @param clock_hz クロック周波数（Hz）
+     */
+    void recordTransfer(size_t length, uint32_t clock_hz)
+    {
+        transferred_bytes_.fetch_add(length, std::memory_order_relaxed);
+        transaction_count_.fetch_add(1, std::memory_order_relaxed);
+        if (clock_hz > 0) {
+            bus_time_ns_.fetch_add(static_cast<uint64_t>(length) * 8 * 1000000000ull / clock_hz,
+                                   std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief モデル化したバス占有時間を取得
+     *
+     * @return uint64_t バス占有時間（ナノ秒）
+     */
+    uint64_t getBusTimeNanoseconds() const
+    {
+        return bus_time_ns_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 転送したバイト数を取得
+     *
+     * @return uint64_t 転送したバイト数
+     */
+    uint64_t getTransferredBytes() const
+    {
+        return transferred_bytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 転送回数を取得
+     *
+     * @return uint64_t 転送回数
+     */
+    uint64_t getTransactionCount() const
+    {
+        return transaction_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 統計情報をリセット
+     */
+    void resetStatistics()
+    {
+        bus_time_ns_.store(0, std::memory_order_relaxed);
+        transferred_bytes_.store(0, std::memory_order_relaxed);
+        transaction_count_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief デバイスの排他制御用ミューテックスを取得
+     *
+     * @return std::mutex& ミューテックス
+     */
+    std::mutex& getMutex() const
+    {
+        return mutex_;
+    }
+
+private:
+    std::atomic<uint64_t> bus_time_ns_{0};
+    std::atomic<uint64_t> transferred_bytes_{0};
+    std::atomic<uint64_t> transaction_count_{0};
+    SPIBitOrder bit_order_ = SPIBitOrder::MSBFirst;
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief ループバックデバイス（MOSIをそのままMISOに返す）
+ */
+class SimulatedSPILoopback : public SimulatedSPIDevice {
+public:
+    void transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) override;
+};
+
+/**
+ * @brief レジスタファイルデバイス
+ *
+ * 多くのセンサーと同じく、CS選択後の先頭バイトのビット7が読み出しフラグ、ビット0-6がレジスタアドレス。
+ * 以降のバイトでアドレスを自動インクリメントしながら読み書きする。
+ */
+class SimulatedSPIRegisterFile : public SimulatedSPIDevice {
+public:
+    /**
+     * @brief レジスタ数
+     */
+    static constexpr size_t REGISTER_COUNT = 128;
+
+    /**
+     * @brief 読み出しフラグ
+     */
+    static constexpr uint8_t READ_FLAG = 0x80;
+
+    void select() override;
+    void transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) override;
+
+    /**
+     * @brief レジスタ値を設定（デバイス側からの更新）
+     *
+     * @param address レジスタアドレス
+     * @param value 値
+     */
+    void setRegister(uint8_t address, uint8_t value);
+
+    /**
+     * @brief レジスタ値を取得
+     *
+     * @param address レジスタアドレス
+     * @return uint8_t 値
+     */
+    uint8_t getRegister(uint8_t address) const;
+
+private:
+    uint8_t registers_[REGISTER_COUNT] = {};
+    bool address_phase_ = true;
+    bool reading_       = false;
+    uint8_t address_    = 0;
+};
+
+/**
+ * @brief SPI NORフラッシュデバイス
+ *
+ * 一般的なシリアルフラッシュ（W25Qシリーズ相当）のコマンドをモデル化する。
+ * 対応コマンド：READ(0x03), FAST_READ(0x0B), PAGE_PROGRAM(0x02), SECTOR_ERASE(0x20),
+ * BLOCK_ERASE(0xD8), CHIP_ERASE(0xC7/0x60), WRITE_ENABLE(0x06), WRITE_DISABLE(0x04),
+ * READ_STATUS(0x05), READ_JEDEC_ID(0x9F)
+ */
+class SimulatedSPINorFlash : public SimulatedSPIDevice {
+public:
+    static constexpr uint8_t CMD_READ          = 0x03;
+    static constexpr uint8_t CMD_FAST_READ     = 0x0B;
+    static constexpr uint8_t CMD_PAGE_PROGRAM  = 0x02;
+    static constexpr uint8_t CMD_SECTOR_ERASE  = 0x20;
+    static constexpr uint8_t CMD_BLOCK_ERASE   = 0xD8;
+    static constexpr uint8_t CMD_CHIP_ERASE    = 0xC7;
+    static constexpr uint8_t CMD_CHIP_ERASE2   = 0x60;
+    static constexpr uint8_t CMD_WRITE_ENABLE  = 0x06;
+    static constexpr uint8_t CMD_WRITE_DISABLE = 0x04;
+    static constexpr uint8_t CMD_READ_STATUS   = 0x05;
+    static constexpr uint8_t CMD_READ_JEDEC_ID = 0x9F;
+
+    static constexpr uint8_t STATUS_BUSY = 0x01;  ///< 書き込み・消去中
+    static constexpr uint8_t STATUS_WEL  = 0x02;  ///< 書き込み許可
+
+    static constexpr size_t PAGE_SIZE   = 256;
+    static constexpr size_t SECTOR_SIZE = 4096;
+    static constexpr size_t BLOCK_SIZE  = 65536;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param size 容量（バイト、セクタサイズの倍数）
+     * @param jedec_id JEDEC ID（製造者ID・メモリタイプ・容量の3バイト）
+     */
+    explicit SimulatedSPINorFlash(size_t size = 4 * 1024 * 1024, uint32_t jedec_id = 0xEF4016);
+
+    /**
+     * @brief コンストラクタ（ファイルをメモリマップして内容を永続化）
+     *
+     * ファイルが容量より小さい場合は拡張し、拡張した領域は消去済み（0xFF）とする。
+     * マップに失敗した場合はメモリ上に確保する（isPersistent()で確認できる）
+     *
+     * @param path バッキングファイルのパス
+     * @param size 容量（バイト、セクタサイズの倍数）
+     * @param jedec_id JEDEC ID（製造者ID・メモリタイプ・容量の3バイト）
+     */
+    SimulatedSPINorFlash(const std::string& path, size_t size = 4 * 1024 * 1024, uint32_t jedec_id = 0xEF4016);
+
+    /**
+     * @brief デストラクタ
+     */
+    ~SimulatedSPINorFlash();
+
+    SimulatedSPINorFlash(const SimulatedSPINorFlash&)            = delete;
+    SimulatedSPINorFlash& operator=(const SimulatedSPINorFlash&) = delete;
+
+    void select() override;
+    void deselect() override;
+    void transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) override;
+
+    /**
+     * @brief 容量を取得
+     *
+     * @return size_t 容量（バイト）
+     */
+    size_t getSize() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief メモリ内容を直接参照
+     *
+     * @return uint8_t* メモリの先頭
+     */
+    uint8_t* getData()
+    {
+        return data_;
+    }
+
+    /**
+     * @brief メモリ内容がファイルに永続化されているか確認
+     *
+     * @return true ファイルにマップされている
+     * @return false メモリ上に確保されている
+     */
+    bool isPersistent() const
+    {
+        return mapping_ != nullptr;
+    }
+
+private:
+    /**
+     * @brief コマンドのアドレスバイト数とダミーバイト数を取得
+     *
+     * @param command コマンド
+     * @return int アドレスとダミーを合わせたバイト数（アドレスを持たない場合は0）
+     */
+    static int getHeaderLength(uint8_t command);
+
+    /**
+     * @brief 容量をセクタサイズの倍数に切り詰める
+     *
+     * @param size 容量
+     * @return size_t 切り詰めた容量
+     */
+    static size_t alignSize(size_t size);
+
+    /**
+     * @brief ファイルをメモリマップ
+     *
+     * @param path バッキングファイルのパス
+     * @return true 成功
+     * @return false 失敗
+     */
+    bool mapFile(const std::string& path);
+
+    std::vector<uint8_t> memory_;  ///< メモリ上に確保する場合の領域
+    uint8_t* data_ = nullptr;
+    size_t size_   = 0;
+    void* mapping_ = nullptr;  ///< ファイルにマップした領域
+    uint32_t jedec_id_;
+    uint8_t status_ = 0;
+
+    // 転送中のコマンド状態
+    bool has_command_  = false;
+    uint8_t command_   = 0;
+    int header_count_  = 0;
+    uint32_t address_  = 0;
+    size_t data_count_ = 0;
+};
+
+/**
+ * @brief MIPI DCS互換ディスプレイパネル
+ *
+ * DCピンがLowのバイトをコマンド、Highのバイトをパラメータ・画素データとして解釈する。
+ * CASET/RASETで設定されたウィンドウに、RAMWR以降の画素（RGB565、上位バイトが先）を書き込む。
+ * それ以外のコマンドはパラメータごと無視する
+ */
+class SimulatedSPIDisplay : public SimulatedSPIDevice {
+public:
+    static constexpr uint8_t CMD_CASET = 0x2A;
+    static constexpr uint8_t CMD_RASET = 0x2B;
+    static constexpr uint8_t CMD_RAMWR = 0x2C;
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param width パネルのメモリの幅（ピクセル）
+     * @param height パネルのメモリの高さ（ピクセル）
+     */
+    SimulatedSPIDisplay(int width, int height);
+
+    void select() override;
+    void transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) override;
+    void setDC(bool dc_level) override;
+
+    /**
+     * @brief 画素を取得
+     *
+     * @param x X座標
+     * @param y Y座標
+     * @return uint16_t 色（RGB565、範囲外は0）
+     */
+    uint16_t getPixel(int x, int y);
+
+    /**
+     * @brief RAMWRで書き込まれた画素数を取得
+     *
+     * @return uint64_t 画素数
+     */
+    uint64_t getWrittenPixels()
+    {
+        std::lock_guard<std::mutex> lock(getMutex());
+        return written_pixels_;
+    }
+
+private:
+    /**
+     * @brief 1画素を書き込んでウィンドウ内の次の位置へ進める
+     *
+     * @param color 色（RGB565）
+     */
+    void writePixel(uint16_t color);
+
+    int width_;
+    int height_;
+    std::vector<uint16_t> pixels_;
+    bool dc_level_ = false;
+
+    // 転送中のコマンド状態
+    uint8_t command_    = 0;
+    size_t param_count_ = 0;
+    uint8_t params_[4]  = {};
+    int column_start_   = 0;
+    int column_end_     = 0;
+    int row_start_      = 0;
+    int row_end_        = 0;
+    int column_         = 0;
+    int row_            = 0;
+    int high_byte_      = -1;  ///< 受信済みの画素の上位バイト（未受信は-1）
+
+    uint64_t written_pixels_ = 0;
+};
+
+/**
+ * @brief シミュレーションSPIトランスポート
+ *
+ * 転送はCSピンに接続されたデバイスモデルへ直接渡される。
+ * 非同期操作はバスごとのワーカースレッドで投入順に実行される。同期操作とDC・CSの切り替えも
+ * 同じワーカーを経由し、投入済みの非同期操作が完了してから実行される
+ */
+class SimulatedSPITransport : public ISPITransport {
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param device 接続先のデバイスモデル
+     * @param device_config デバイス設定
+     * @param worker 非同期操作を実行するワーカー（nullptrの場合は同期実行）
+     */
+    SimulatedSPITransport(std::shared_ptr<SimulatedSPIDevice> device, const SPIDeviceConfig& device_config,
+                          std::shared_ptr<TransferWorker> worker = nullptr);
+
+    bool begin() override;
+    void end() override;
+    bool isReady() const override;
+
+    ssize_t write(const void* data, size_t length) override;
+    ssize_t read(void* data, size_t length) override;
+    ssize_t transfer(const void* tx_data, void* rx_data, size_t length) override;
+
+    ssize_t writev(const TransferSegment* segments, size_t count) override;
+    ssize_t readv(const TransferSegment* segments, size_t count) override;
+    ssize_t transferv(const TransferSegment* segments, size_t count) override;
+
+    bool supportsAsync() const override
+    {
+        return worker_ != nullptr;
+    }
+
+    TransferToken writeAsync(const void* data, size_t length) override;
+    TransferToken readAsync(void* data, size_t length) override;
+    TransferToken transferAsync(const void* tx_data, void* rx_data, size_t length) override;
+
+    void setClockFrequency(uint32_t hz) override;
+    void setMode(SPIMode mode) override;
+    void setLSBFirst(bool lsb_first) override;
+    void setDC(bool dc_level) override;
+    bool setCSHold(bool hold) override;
+    bool isCSHeld() const override;
+    ssize_t writeCommandStream(const SPICommandSegment* segments, size_t count) override;
+
+    /**
+     * @brief 接続先のデバイスモデルを取得
+     *
+     * @return std::shared_ptr<SimulatedSPIDevice> デバイスモデル
+     */
+    std::shared_ptr<SimulatedSPIDevice> getDevice() const
+    {
+        return device_;
+    }
+
+private:
+    /**
+     * @brief デバイスモデルとデータを受け渡す（デバイスのロック取得済みで呼び出す）
+     *
+     * ビットオーダーがデバイスと異なる場合は、送受信データのビット順を一括で反転する
+     *
+     * @param device 接続先のデバイスモデル
+     * @param bit_order トランスポートのビットオーダー
+     * @param tx_data 送信データ
+     * @param rx_data 受信データ
+     * @param length データ長
+     */
+    static void transferBytes(SimulatedSPIDevice& device, SPIBitOrder bit_order, const uint8_t* tx_data,
+                              uint8_t* rx_data, size_t length);
+
+    /**
+     * @brief CSを選択した状態で1回の転送を行う
+     *
+     * @param device 接続先のデバイスモデル
+     * @param clock_hz クロック周波数（Hz）
+     * @param bit_order ビットオーダー
+     * @param cs_held CSが保持されているか（trueの場合はCSを切り替えない）
+     * @param tx_data 送信データ
+     * @param rx_data 受信データ
+     * @param length データ長
+     * @return ssize_t 転送したバイト数
+     */
+    static ssize_t transaction(SimulatedSPIDevice& device, uint32_t clock_hz, SPIBitOrder bit_order, bool cs_held,
+                               const uint8_t* tx_data, uint8_t* rx_data, size_t length);
+
+    /**
+     * @brief CSを選択した状態で各区間を順に転送する
+     *
+     * @param segments 区間の配列
+     * @param count 区間数
+     * @return ssize_t 転送したバイト数
+     */
+    ssize_t transaction(const TransferSegment* segments, size_t count);
+
+    /**
+     * @brief 投入済みの非同期転送の後に処理を実行し、完了を待つ
+     *
+     * 同期操作とDC・CSの切り替えが、キューに残っている非同期転送を追い越さないようにする。
+     * このトランスポートの未完了の非同期転送がない場合（ワーカーがない場合を含む）は、
+     * ワーカーを経由せずにその場で実行する。完了コールバックの中から呼び出さないこと
+     *
+     * @param job 処理
+     * @return ssize_t 処理の結果
+     */
+    template <typename Job>
+    ssize_t runInOrder(Job job);
+
+    /**
+     * @brief 転送をワーカーに投入
+     *
+     * @param tx_data 送信データ
+     * @param rx_data 受信データ
+     * @param length データ長
+     * @return TransferToken 完了トークン
+     */
+    TransferToken submit(const uint8_t* tx_data, uint8_t* rx_data, size_t length);
+
+    std::shared_ptr<SimulatedSPIDevice> device_;
+    SPIDeviceConfig config_;
+    std::shared_ptr<TransferWorker> worker_;
+    std::shared_ptr<std::atomic<uint32_t>> pending_;  ///< 未完了の非同期転送数（投入した処理と共有）
+    bool initialized_ = false;
+    bool cs_held_     = false;
+};
+
+/**
+ * @brief シミュレーションSPI実装
+ *
+ * SPIBus::addImplementation() で登録し、CSピン番号ごとにデバイスモデルを接続して使用する。
+ * 1つの実装が1本のバスに相当し、作成したトランスポートは非同期操作用のワーカーを共有する
+ */
+class SimulatedSPIImplementation : public SPIBusImplementation {
+public:
+    SimulatedSPIImplementation() : worker_(std::make_shared<TransferWorker>())
+    {
+    }
+
+    bool isAvailable() const override
+    {
+        return true;
+    }
+
+    std::shared_ptr<ISPITransport> createTransport(const SPIBusConfig& bus_config,
+                                                   const SPIDeviceConfig& device_config) override;
+
+    /**
+     * @brief デバイスモデルを接続
+     *
+     * @param cs_pin CSピン番号
+     * @param device デバイスモデル
+     */
+    void attachDevice(int cs_pin, std::shared_ptr<SimulatedSPIDevice> device);
+
+    /**
+     * @brief デバイスモデルを切り離す
+     *
+     * @param cs_pin CSピン番号
+     */
+    void detachDevice(int cs_pin);
+
+    /**
+     * @brief 接続されたデバイスモデルを取得
+     *
+     * @param cs_pin CSピン番号
+     * @return std::shared_ptr<SimulatedSPIDevice> デバイスモデル（未接続の場合はnullptr）
+     */
+    std::shared_ptr<SimulatedSPIDevice> getDevice(int cs_pin) const;
+
+private:
+    std::map<int, std::shared_ptr<SimulatedSPIDevice>> devices_;
+    std::shared_ptr<TransferWorker> worker_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace desktop
+}  // namespace platform
+}  // namespace flexhal
+
+#endif  // FLEXHAL_IMPL_PLATFORMS_DESKTOP_SPI_HPP
@@ -0,0 +1,743 @@
+/**
+ * @file spi.inl
+ * @brief FlexHAL - デスクトップ向けSPIシミュレーション（実装）
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "spi.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace flexhal {
+namespace platform {
+namespace desktop {
+
+// SimulatedSPILoopback実装
+
+void SimulatedSPILoopback::transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length)
+{
+    if (!rx_data) {
+        return;
+    }
+
+    if (tx_data) {
+        if (tx_data != rx_data) {
+            std::memmove(rx_data, tx_data, length);
+        }
+    } else {
+        std::memset(rx_data, 0xFF, length);
+    }
+}
+
+// SimulatedSPIRegisterFile実装
+
+void SimulatedSPIRegisterFile::select()
+{
+    address_phase_ = true;
+}
+
+void SimulatedSPIRegisterFile::transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t in  = tx_data ? tx_data[i] : 0xFF;
+        uint8_t out = 0xFF;
+
+        if (address_phase_) {
+            reading_       = (in & READ_FLAG) != 0;
+            address_       = in & (REGISTER_COUNT - 1);
+            address_phase_ = false;
+        } else {
+            if (reading_) {
+                out = registers_[address_];
+            } else {
+                registers_[address_] = in;
+            }
+            address_ = (address_ + 1) & (REGISTER_COUNT - 1);
+        }
+
+        if (rx_data) {
+            rx_data[i] = out;
+        }
+    }
+}
+
+void SimulatedSPIRegisterFile::setRegister(uint8_t address, uint8_t value)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    registers_[address & (REGISTER_COUNT - 1)] = value;
+}
+
+uint8_t SimulatedSPIRegisterFile::getRegister(uint8_t address) const
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    return registers_[address & (REGISTER_COUNT - 1)];
+}
+
+// SimulatedSPINorFlash実装
+
+SimulatedSPINorFlash::SimulatedSPINorFlash(size_t size, uint32_t jedec_id)
+    : memory_(alignSize(size), 0xFF), data_(memory_.data()), size_(memory_.size()), jedec_id_(jedec_id)
+{
+}
+
+SimulatedSPINorFlash::SimulatedSPINorFlash(const std::string& path, size_t size, uint32_t jedec_id)
+    : size_(alignSize(size)), jedec_id_(jedec_id)
+{
+    if (!mapFile(path)) {
+        memory_.assign(size_, 0xFF);
+        data_ = memory_.data();
+    }
+}
+
+SimulatedSPINorFlash::~SimulatedSPINorFlash()
+{
+    if (mapping_) {
+        msync(mapping_, size_, MS_SYNC);
+        munmap(mapping_, size_);
+    }
+}
+
+size_t SimulatedSPINorFlash::alignSize(size_t size)
+{
+    return std::max<size_t>(SECTOR_SIZE, size - size % SECTOR_SIZE);
+}
+
+bool SimulatedSPINorFlash::mapFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (static_cast<size_t>(st.st_size) < size_ && ftruncate(fd, size_) != 0)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // 拡張した領域（ファイル上は0）を消去済みの状態にする
+    mapping_ = mapping;
+    data_    = static_cast<uint8_t*>(mapping);
+    if (static_cast<size_t>(st.st_size) < size_) {
+        std::memset(data_ + st.st_size, 0xFF, size_ - st.st_size);
+    }
+    return true;
+}
+
+int SimulatedSPINorFlash::getHeaderLength(uint8_t command)
+{
+    switch (command) {
+        case CMD_READ:
+        case CMD_PAGE_PROGRAM:
+        case CMD_SECTOR_ERASE:
+        case CMD_BLOCK_ERASE:
+            return 3;
+        case CMD_FAST_READ:
+            return 4;  // アドレス3バイト + ダミー1バイト
+        default:
+            return 0;
+    }
+}
+
+void SimulatedSPINorFlash::select()
+{
+    has_command_ = false;
+}
+
+void SimulatedSPINorFlash::deselect()
+{
+    if (!has_command_) {
+        return;
+    }
+    has_command_ = false;
+
+    // 書き込み・消去はCSが非アクティブになった時点で確定し、完了後に書き込み許可が解除される
+    if (!(status_ & STATUS_WEL)) {
+        return;
+    }
+    bool header_done = header_count_ == getHeaderLength(command_);
+    switch (command_) {
+        case CMD_PAGE_PROGRAM:
+            status_ &= ~STATUS_WEL;
+            break;
+        case CMD_SECTOR_ERASE:
+        case CMD_BLOCK_ERASE:
+            if (header_done) {
+                size_t unit = command_ == CMD_SECTOR_ERASE ? SECTOR_SIZE : BLOCK_SIZE;
+                size_t base = address_ & ~(unit - 1);
+                if (base < size_) {
+                    std::memset(data_ + base, 0xFF, std::min(unit, size_ - base));
+                }
+                status_ &= ~STATUS_WEL;
+            }
+            break;
+        case CMD_CHIP_ERASE:
+        case CMD_CHIP_ERASE2:
+            std::memset(data_, 0xFF, size_);
+            status_ &= ~STATUS_WEL;
+            break;
+        default:
+            break;
+    }
+}
+
+void SimulatedSPINorFlash::transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length)
+{
+    size_t i = 0;
+    while (i < length) {
+        // コマンドバイト
+        if (!has_command_) {
+            command_      = tx_data ? tx_data[i] : 0xFF;
+            has_command_  = true;
+            header_count_ = 0;
+            address_      = 0;
+            data_count_   = 0;
+            if (rx_data) {
+                rx_data[i] = 0xFF;
+            }
+            ++i;
+
+            if (command_ == CMD_WRITE_ENABLE) {
+                status_ |= STATUS_WEL;
+            } else if (command_ == CMD_WRITE_DISABLE) {
+                status_ &= ~STATUS_WEL;
+            }
+            continue;
+        }
+
+        // アドレス（上位バイトから）とダミーバイト
+        int header_length = getHeaderLength(command_);
+        if (header_count_ < header_length) {
+            if (header_count_ < 3) {
+                address_ = (address_ << 8) | (tx_data ? tx_data[i] : 0xFF);
+            }
+            if (rx_data) {
+                rx_data[i] = 0xFF;
+            }
+            ++i;
+            if (++header_count_ == header_length) {
+                address_ %= size_;
+            }
+            continue;
+        }
+
+        // データフェーズは残りをまとめて処理する
+        size_t count = length - i;
+        switch (command_) {
+            case CMD_READ:
+            case CMD_FAST_READ:
+                // メモリから呼び出し元のバッファへ直接コピー（末尾で先頭に折り返す）
+                while (count > 0) {
+                    size_t chunk = std::min(count, size_ - address_);
+                    if (rx_data) {
+                        std::memcpy(rx_data + i, data_ + address_, chunk);
+                    }
+                    address_ = static_cast<uint32_t>((address_ + chunk) % size_);
+                    i += chunk;
+                    count -= chunk;
+                }
+                break;
+
+            case CMD_PAGE_PROGRAM: {
+                // 1にしかできないビットを0に落とす（ページ内で折り返す）
+                if (status_ & STATUS_WEL) {
+                    size_t base = address_ & ~(PAGE_SIZE - 1);
+                    for (size_t n = 0; n < count; ++n) {
+                        size_t offset = (address_ + n) & (PAGE_SIZE - 1);
+                        data_[base + offset] &= tx_data ? tx_data[i + n] : 0xFF;
+                    }
+                    address_ = static_cast<uint32_t>(base + ((address_ + count) & (PAGE_SIZE - 1)));
+                }
+                if (rx_data) {
+                    std::memset(rx_data + i, 0xFF, count);
+                }
+                i += count;
+                break;
+            }
+
+            case CMD_READ_STATUS:
+                if (rx_data) {
+                    std::memset(rx_data + i, status_, count);
+                }
+                i += count;
+                break;
+
+            case CMD_READ_JEDEC_ID:
+                for (size_t n = 0; n < count; ++n, ++data_count_) {
+                    if (rx_data) {
+                        rx_data[i + n] =
+                            data_count_ < 3 ? static_cast<uint8_t>(jedec_id_ >> (16 - 8 * data_count_)) : 0xFF;
+                    }
+                }
+                i += count;
+                break;
+
+            default:
+                if (rx_data) {
+                    std::memset(rx_data + i, 0xFF, count);
+                }
+                i += count;
+                break;
+        }
+    }
+}
+
+// SimulatedSPIDisplay実装
+
+SimulatedSPIDisplay::SimulatedSPIDisplay(int width, int height)
+    : width_(std::max(width, 0)),
+      height_(std::max(height, 0)),
+      pixels_(static_cast<size_t>(width_) * height_, 0),
+      column_end_(width_ - 1),
+      row_end_(height_ - 1)
+{
+}
+
+void SimulatedSPIDisplay::select()
+{
+    high_byte_ = -1;
+}
+
+void SimulatedSPIDisplay::setDC(bool dc_level)
+{
+    dc_level_ = dc_level;
+}
+
+void SimulatedSPIDisplay::transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length)
+{
+    if (rx_data) {
+        std::memset(rx_data, 0xFF, length);
+    }
+    if (!tx_data) {
+        return;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t in = tx_data[i];
+        if (!dc_level_) {
+            command_     = in;
+            param_count_ = 0;
+            high_byte_   = -1;
+            if (command_ == CMD_RAMWR) {
+                column_ = column_start_;
+                row_    = row_start_;
+            }
+            continue;
+        }
+
+        switch (command_) {
+            case CMD_CASET:
+            case CMD_RASET:
+                if (param_count_ < sizeof(params_)) {
+                    params_[param_count_++] = in;
+                }
+                if (param_count_ == sizeof(params_)) {
+                    int start = (params_[0] << 8) | params_[1];
+                    int end   = (params_[2] << 8) | params_[3];
+                    if (command_ == CMD_CASET) {
+                        column_start_ = start;
+                        column_end_   = end;
+                    } else {
+                        row_start_ = start;
+                        row_end_   = end;
+                    }
+                }
+                break;
+
+            case CMD_RAMWR:
+                if (high_byte_ < 0) {
+                    high_byte_ = in;
+                } else {
+                    writePixel(static_cast<uint16_t>((high_byte_ << 8) | in));
+                    high_byte_ = -1;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+uint16_t SimulatedSPIDisplay::getPixel(int x, int y)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+        return 0;
+    }
+    return pixels_[static_cast<size_t>(y) * width_ + x];
+}
+
+void SimulatedSPIDisplay::writePixel(uint16_t color)
+{
+    if (column_ >= 0 && row_ >= 0 && column_ < width_ && row_ < height_) {
+        pixels_[static_cast<size_t>(row_) * width_ + column_] = color;
+    }
+    ++written_pixels_;
+
+    if (++column_ > column_end_) {
+        column_ = column_start_;
+        if (++row_ > row_end_) {
+            row_ = row_start_;
+        }
+    }
+}
+
+// SimulatedSPITransport実装
+
+SimulatedSPITransport::SimulatedSPITransport(std::shared_ptr<SimulatedSPIDevice> device,
+                                             const SPIDeviceConfig& device_config,
+                                             std::shared_ptr<TransferWorker> worker)
+    : device_(std::move(device)),
+      config_(device_config),
+      worker_(std::move(worker)),
+      pending_(std::make_shared<std::atomic<uint32_t>>(0))
+{
+}
+
+bool SimulatedSPITransport::begin()
+{
+    initialized_ = device_ != nullptr;
+    return initialized_;
+}
+
+void SimulatedSPITransport::end()
+{
+    setCSHold(false);
+    initialized_ = false;
+}
+
+bool SimulatedSPITransport::isReady() const
+{
+    return initialized_;
+}
+
+ssize_t SimulatedSPITransport::write(const void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return -1;
+    }
+    const uint8_t* tx_data = static_cast<const uint8_t*>(data);
+    return runInOrder([this, tx_data, length]() {
+        return transaction(*device_, config_.clock_hz, config_.bit_order, cs_held_, tx_data, nullptr, length);
+    });
+}
+
+ssize_t SimulatedSPITransport::read(void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return -1;
+    }
+    uint8_t* rx_data = static_cast<uint8_t*>(data);
+    return runInOrder([this, rx_data, length]() {
+        return transaction(*device_, config_.clock_hz, config_.bit_order, cs_held_, nullptr, rx_data, length);
+    });
+}
+
+ssize_t SimulatedSPITransport::transfer(const void* tx_data, void* rx_data, size_t length)
+{
+    if (!initialized_ || (!tx_data && !rx_data && length > 0)) {
+        return -1;
+    }
+    const uint8_t* tx = static_cast<const uint8_t*>(tx_data);
+    uint8_t* rx       = static_cast<uint8_t*>(rx_data);
+    return runInOrder([this, tx, rx, length]() {
+        return transaction(*device_, config_.clock_hz, config_.bit_order, cs_held_, tx, rx, length);
+    });
+}
+
+ssize_t SimulatedSPITransport::writev(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].tx_data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+    return runInOrder([this, segments, count]() { return transaction(segments, count); });
+}
+
+ssize_t SimulatedSPITransport::readv(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].rx_data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+    return runInOrder([this, segments, count]() { return transaction(segments, count); });
+}
+
+ssize_t SimulatedSPITransport::transferv(const TransferSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    return runInOrder([this, segments, count]() { return transaction(segments, count); });
+}
+
+TransferToken SimulatedSPITransport::writeAsync(const void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return TransferToken::completed(-1);
+    }
+    return submit(static_cast<const uint8_t*>(data), nullptr, length);
+}
+
+TransferToken SimulatedSPITransport::readAsync(void* data, size_t length)
+{
+    if (!initialized_ || (!data && length > 0)) {
+        return TransferToken::completed(-1);
+    }
+    return submit(nullptr, static_cast<uint8_t*>(data), length);
+}
+
+TransferToken SimulatedSPITransport::transferAsync(const void* tx_data, void* rx_data, size_t length)
+{
+    if (!initialized_ || (!tx_data && !rx_data && length > 0)) {
+        return TransferToken::completed(-1);
+    }
+    return submit(static_cast<const uint8_t*>(tx_data), static_cast<uint8_t*>(rx_data), length);
+}
+
+void SimulatedSPITransport::setClockFrequency(uint32_t hz)
+{
+    config_.clock_hz = hz;
+}
+
+void SimulatedSPITransport::setMode(SPIMode mode)
+{
+    config_.mode = mode;
+}
+
+void SimulatedSPITransport::setLSBFirst(bool lsb_first)
+{
+    config_.bit_order = lsb_first ? SPIBitOrder::LSBFirst : SPIBitOrder::MSBFirst;
+}
+
+void SimulatedSPITransport::setDC(bool dc_level)
+{
+    if (!initialized_) {
+        return;
+    }
+
+    // 投入済みの非同期転送の途中でDCが切り替わらないよう、その後に実行する
+    runInOrder([this, dc_level]() -> ssize_t {
+        std::lock_guard<std::mutex> lock(device_->getMutex());
+        device_->setDC(dc_level);
+        return 0;
+    });
+}
+
+bool SimulatedSPITransport::setCSHold(bool hold)
+{
+    if (!initialized_) {
+        return false;
+    }
+    if (hold == cs_held_) {
+        return true;
+    }
+
+    // 投入済みの非同期転送を完了させてからCSを切り替える
+    runInOrder([this, hold]() -> ssize_t {
+        std::lock_guard<std::mutex> lock(device_->getMutex());
+        if (hold) {
+            device_->select();
+        } else {
+            device_->deselect();
+        }
+        return 0;
+    });
+    cs_held_ = hold;
+    return true;
+}
+
+bool SimulatedSPITransport::isCSHeld() const
+{
+    return cs_held_;
+}
+
+ssize_t SimulatedSPITransport::writeCommandStream(const SPICommandSegment* segments, size_t count)
+{
+    if (!initialized_ || (!segments && count > 0)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!segments[i].data && segments[i].length > 0) {
+            return -1;
+        }
+    }
+
+    // デバイスのロックを1回だけ取得し、DCの切り替えを挟みながら全区間を1回の転送として記録する
+    return runInOrder([this, segments, count]() -> ssize_t {
+        size_t total = 0;
+        std::lock_guard<std::mutex> lock(device_->getMutex());
+        if (!cs_held_) {
+            device_->select();
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (i == 0 || segments[i].dc != segments[i - 1].dc) {
+                device_->setDC(segments[i].dc);
+            }
+            transferBytes(*device_, config_.bit_order, static_cast<const uint8_t*>(segments[i].data), nullptr,
+                          segments[i].length);
+            total += segments[i].length;
+        }
+        if (!cs_held_) {
+            device_->deselect();
+        }
+        device_->recordTransfer(total, config_.clock_hz);
+        return static_cast<ssize_t>(total);
+    });
+}
+
+void SimulatedSPITransport::transferBytes(SimulatedSPIDevice& device, SPIBitOrder bit_order, const uint8_t* tx_data,
+                                          uint8_t* rx_data, size_t length)
+{
+    if (bit_order == device.getBitOrder()) {
+        device.transfer(tx_data, rx_data, length);
+        return;
+    }
+
+    // 送信データがない場合の0xFFは反転しても変わらないので、そのまま渡す
+    uint8_t reversed[256];
+    for (size_t offset = 0; offset < length; offset += sizeof(reversed)) {
+        size_t count = std::min(length - offset, sizeof(reversed));
+        if (tx_data) {
+            reverseBitOrder(tx_data + offset, reversed, count);
+        }
+        device.transfer(tx_data ? reversed : nullptr, rx_data ? rx_data + offset : nullptr, count);
+        if (rx_data) {
+            reverseBitOrder(rx_data + offset, count);
+        }
+    }
+}
+
+ssize_t SimulatedSPITransport::transaction(SimulatedSPIDevice& device, uint32_t clock_hz, SPIBitOrder bit_order,
+                                           bool cs_held, const uint8_t* tx_data, uint8_t* rx_data, size_t length)
+{
+    std::lock_guard<std::mutex> lock(device.getMutex());
+    if (!cs_held) {
+        device.select();
+    }
+    transferBytes(device, bit_order, tx_data, rx_data, length);
+    if (!cs_held) {
+        device.deselect();
+    }
+    device.recordTransfer(length, clock_hz);
+    return static_cast<ssize_t>(length);
+}
+
+ssize_t SimulatedSPITransport::transaction(const TransferSegment* segments, size_t count)
+{
+    // 各区間を呼び出し元のバッファのままデバイスモデルへ渡す（ビット順の反転が必要な場合を除く）
+    size_t total = 0;
+    std::lock_guard<std::mutex> lock(device_->getMutex());
+    if (!cs_held_) {
+        device_->select();
+    }
+    for (size_t i = 0; i < count; ++i) {
+        transferBytes(*device_, config_.bit_order, static_cast<const uint8_t*>(segments[i].tx_data),
+                      static_cast<uint8_t*>(segments[i].rx_data), segments[i].length);
+        total += segments[i].length;
+    }
+    if (!cs_held_) {
+        device_->deselect();
+    }
+    device_->recordTransfer(total, config_.clock_hz);
+    return static_cast<ssize_t>(total);
+}
+
+template <typename Job>
+ssize_t SimulatedSPITransport::runInOrder(Job job)
+{
+    // 追い越す非同期転送がなければ、スレッドを切り替えずに呼び出し元で実行する
+    if (!worker_ || pending_->load(std::memory_order_acquire) == 0) {
+        return job();
+    }
+
+    // ワーカーに投入して、先に投入された非同期転送の後に実行されるのを待つ
+    TransferToken token = worker_->submit(TransferWorker::Job(std::move(job)));
+    token.wait();
+    return token.getResult();
+}
+
+TransferToken SimulatedSPITransport::submit(const uint8_t* tx_data, uint8_t* rx_data, size_t length)
+{
+    if (!worker_) {
+        return TransferToken::completed(
+            transaction(*device_, config_.clock_hz, config_.bit_order, cs_held_, tx_data, rx_data, length));
+    }
+
+    // トランスポートが先に破棄されても完了できるよう、デバイスと設定値を保持して投入する
+    std::shared_ptr<SimulatedSPIDevice> device     = device_;
+    uint32_t clock_hz                              = config_.clock_hz;
+    SPIBitOrder bit_order                          = config_.bit_order;
+    bool cs_held                                   = cs_held_;
+    std::shared_ptr<std::atomic<uint32_t>> pending = pending_;
+    pending->fetch_add(1, std::memory_order_relaxed);
+    return worker_->submit([device, clock_hz, bit_order, cs_held, tx_data, rx_data, length, pending]() {
+        ssize_t result = transaction(*device, clock_hz, bit_order, cs_held, tx_data, rx_data, length);
+        pending->fetch_sub(1, std::memory_order_release);
+        return result;
+    });
+}
+
+// SimulatedSPIImplementation実装
+
+std::shared_ptr<ISPITransport> SimulatedSPIImplementation::createTransport(const SPIBusConfig& bus_config,
+                                                                           const SPIDeviceConfig& device_config)
+{
+    (void)bus_config;
+
+    auto device = getDevice(device_config.cs_pin);
+    if (!device) {
+        return nullptr;
+    }
+    return std::make_shared<SimulatedSPITransport>(device, device_config, worker_);
+}
+
+void SimulatedSPIImplementation::attachDevice(int cs_pin, std::shared_ptr<SimulatedSPIDevice> device)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (device) {
+        devices_[cs_pin] = std::move(device);
+    } else {
+        devices_.erase(cs_pin);
+    }
+}
+
+void SimulatedSPIImplementation::detachDevice(int cs_pin)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_.erase(cs_pin);
+}
+
+std::shared_ptr<SimulatedSPIDevice> SimulatedSPIImplementation::getDevice(int cs_pin) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = devices_.find(cs_pin);
+    return it != devices_.end() ? it->second : nullptr;
+}
+
+}  // namespace desktop
+}  // namespace platform
+}  // namespace flexhal
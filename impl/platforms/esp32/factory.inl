@@ -41,6 +41,17 @@ std::shared_ptr<IPin> getPin(int pin_number)
     return port->getPin(pin_number);
 }
 
+// 指定したピン番号のピンへの非所有ハンドルを取得
+PinRef getPinRef(int pin_number)
+{
+    auto port = getDefaultGPIOPort();
+    if (!port) {
+        return PinRef();
+    }
+
+    return PinRef(*port, pin_number);
+}
+
 // プラットフォーム固有の初期化
 namespace platform {
     namespace esp32 {
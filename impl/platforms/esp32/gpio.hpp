@@ -11,6 +11,7 @@
 #pragma once
 
 #include "../../internal/gpio.h"
+#include "../../internal/gpio_program.h"
 #include "../../internal/device.h"
 #include <memory>
 #include <vector>
@@ -147,6 +148,64 @@ public:
      */
     uint32_t getLevels() const override;
 
+    using IGPIOPort::getLevels;
+    using IGPIOPort::setLevels;
+
+    /**
+     * @brief ピンのレベルを設定（W1TS/W1TCレジスタへ直接書き込む）
+     *
+     * @param pin_number ピン番号
+     * @param level 設定するレベル
+     */
+    void writePin(int pin_number, PinLevel level) override;
+
+    /**
+     * @brief ピンのレベルを取得（入力レジスタを直接読み取る）
+     *
+     * @param pin_number ピン番号
+     * @return PinLevel 現在のレベル
+     */
+    PinLevel readPin(int pin_number) const override;
+
+    /**
+     * @brief バンク数を取得
+     *
+     * @return int バンク数
+     */
+    int getBankCount() const override;
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に設定
+     *
+     * W1TS/W1TCレジスタへの書き込みで行うため、他タスクの操作と干渉しない
+     *
+     * @param bank バンク番号（0: GPIO0-31, 1: GPIO32-39）
+     * @param values 設定する値（ビットマップ）
+     * @param mask 設定対象のピン（ビットマップ）
+     */
+    void setLevels(int bank, uint32_t values, uint32_t mask) override;
+
+    /**
+     * @brief 指定バンクのピンのレベルを一度に取得
+     *
+     * @param bank バンク番号（0: GPIO0-31, 1: GPIO32-39）
+     * @return uint32_t 現在のレベル（ビットマップ）
+     */
+    uint32_t getLevels(int bank) const override;
+
+    /**
+     * @brief GPIOプログラムを実行
+     *
+     * レベル設定と読み取りはW1TS/W1TCおよび入力レジスタへ直接展開して実行する
+     *
+     * @param program 実行するプログラム
+     * @param samples 読み取りステップの結果の格納先
+     * @param sample_capacity 格納先の要素数
+     * @return true 実行成功
+     * @return false 検証失敗、またはレベル待ちのタイムアウト
+     */
+    bool execute(const GPIOProgram& program, uint32_t* samples = nullptr, size_t sample_capacity = 0) override;
+
     /**
      * @brief デバイスを初期化
      *
@@ -149,30 +149,154 @@ std::shared_ptr<IPin> ESP32GPIOPort::getPin(int pin_number, GPIOImplementation i
 
 void ESP32GPIOPort::setLevels(uint32_t values, uint32_t mask)
 {
-    // マスクされたビットに対応するピンの値を設定
-    for (int i = 0; i < 32 && i < pin_count_; ++i) {
-        if (mask & (1 << i)) {
-            bool level = (values & (1 << i)) != 0;
-            // 実装クラスを使用してピンレベルを設定
-            auto pin = getPin(i);
-            if (pin) {
-                pin->setLevel(level ? PinLevel::High : PinLevel::Low);
-            }
+    setLevels(0, values, mask);
+}
+
+uint32_t ESP32GPIOPort::getLevels() const
+{
+    return getLevels(0);
+}
+
+void ESP32GPIOPort::writePin(int pin_number, PinLevel level)
+{
+    if (pin_number < 0 || pin_number >= pin_count_) {
+        return;
+    }
+
+#if CONFIG_IDF_TARGET_ESP32
+    uint32_t bit = 1u << (pin_number % GPIO_PINS_PER_BANK);
+    if (pin_number < GPIO_PINS_PER_BANK) {
+        if (level == PinLevel::High) {
+            GPIO.out_w1ts = bit;
+        } else {
+            GPIO.out_w1tc = bit;
+        }
+    } else {
+        if (level == PinLevel::High) {
+            GPIO.out1_w1ts.val = bit;
+        } else {
+            GPIO.out1_w1tc.val = bit;
         }
     }
+#else
+    digitalWrite(pin_number, level == PinLevel::High ? HIGH : LOW);
+#endif
 }
 
-uint32_t ESP32GPIOPort::getLevels() const
+PinLevel ESP32GPIOPort::readPin(int pin_number) const
+{
+    if (pin_number < 0 || pin_number >= pin_count_) {
+        return PinLevel::Low;
+    }
+
+#if CONFIG_IDF_TARGET_ESP32
+    uint32_t levels = pin_number < GPIO_PINS_PER_BANK ? GPIO.in : GPIO.in1.data;
+    return ((levels >> (pin_number % GPIO_PINS_PER_BANK)) & 0x01) ? PinLevel::High : PinLevel::Low;
+#else
+    return digitalRead(pin_number) == HIGH ? PinLevel::High : PinLevel::Low;
+#endif
+}
+
+int ESP32GPIOPort::getBankCount() const
+{
+    return (pin_count_ + GPIO_PINS_PER_BANK - 1) / GPIO_PINS_PER_BANK;
+}
+
+void ESP32GPIOPort::setLevels(int bank, uint32_t values, uint32_t mask)
 {
-    // 32ビット分のピンの値を取得
+    if (bank < 0 || bank >= getBankCount()) {
+        return;
+    }
+
+#if CONFIG_IDF_TARGET_ESP32
+    // W1TS/W1TCレジスタでバンク全体をまとめて更新
+    uint32_t set_bits   = values & mask;
+    uint32_t clear_bits = ~values & mask;
+    if (bank == 0) {
+        if (set_bits) GPIO.out_w1ts = set_bits;
+        if (clear_bits) GPIO.out_w1tc = clear_bits;
+    } else {
+        if (set_bits) GPIO.out1_w1ts.val = set_bits;
+        if (clear_bits) GPIO.out1_w1tc.val = clear_bits;
+    }
+#else
+    // レジスタ配置が異なるターゲットではマスクの立っているピンだけを個別に設定
+    int base = bank * GPIO_PINS_PER_BANK;
+    for (uint32_t bits = mask; bits; bits &= bits - 1) {
+        int bit = lowestBitIndex(bits);
+        if (base + bit < pin_count_) {
+            digitalWrite(base + bit, ((values >> bit) & 0x01) ? HIGH : LOW);
+        }
+    }
+#endif
+}
+
+uint32_t ESP32GPIOPort::getLevels(int bank) const
+{
+    if (bank < 0 || bank >= getBankCount()) {
+        return 0;
+    }
+
+#if CONFIG_IDF_TARGET_ESP32
+    // 入力レジスタからバンク全体を一度に読み取る
+    return bank == 0 ? GPIO.in : GPIO.in1.data;
+#else
     uint32_t result = 0;
-    for (int i = 0; i < 32 && i < pin_count_; ++i) {
-        // 実装クラスを使用してピンレベルを取得
-        if (pins_[i] && pins_[i]->getLevel() == PinLevel::High) {
-            result |= (1 << i);
+    int base        = bank * GPIO_PINS_PER_BANK;
+    for (int i = 0; i < GPIO_PINS_PER_BANK && base + i < pin_count_; ++i) {
+        if (pins_[base + i] && pins_[base + i]->getLevel() == PinLevel::High) {
+            result |= (1u << i);
         }
     }
     return result;
+#endif
+}
+
+bool ESP32GPIOPort::execute(const GPIOProgram& program, uint32_t* samples, size_t sample_capacity)
+{
+    if (!program.validate(getBankCount(), samples ? sample_capacity : 0)) {
+        return false;
+    }
+
+    // レジスタを直接操作する実行器（仮想関数を経由しない）
+    struct Executor {
+        ESP32GPIOPort& port;
+
+        void setLevels(int bank, uint32_t values, uint32_t mask)
+        {
+            port.ESP32GPIOPort::setLevels(bank, values, mask);
+        }
+
+        uint32_t getLevels(int bank, uint32_t mask)
+        {
+#if CONFIG_IDF_TARGET_ESP32
+            return (bank == 0 ? GPIO.in : GPIO.in1.data) & mask;
+#else
+            uint32_t result = 0;
+            int base        = bank * GPIO_PINS_PER_BANK;
+            for (uint32_t bits = mask; bits; bits &= bits - 1) {
+                int bit = lowestBitIndex(bits);
+                if (digitalRead(base + bit) == HIGH) {
+                    result |= (1u << bit);
+                }
+            }
+            return result;
+#endif
+        }
+
+        void delayMicroseconds(uint32_t us)
+        {
+            ::delayMicroseconds(us);
+        }
+
+        uint32_t micros()
+        {
+            return static_cast<uint32_t>(::micros());
+        }
+    };
+
+    Executor executor{*this};
+    return runGPIOProgram(program, executor, samples);
 }
 
 bool ESP32GPIOPort::begin()
@@ -51,7 +51,8 @@ void ESP32IDFPin::setMode(PinMode mode)
             io_conf.pull_down_en = GPIO_PULLDOWN_ENABLE;
             break;
         case PinMode::OpenDrain:
-            io_conf.mode         = GPIO_MODE_OUTPUT_OD;
+            // I2CのACKやクロックストレッチを読み取れるよう入力も有効にする
+            io_conf.mode         = GPIO_MODE_INPUT_OUTPUT_OD;
             io_conf.pull_up_en   = GPIO_PULLUP_DISABLE;
             io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
             break;
@@ -11,6 +11,8 @@
 #pragma once
 
 #include "../../internal/gpio.h"
+#include "../../internal/static_pin.h"
+#include "../../frameworks/arduino/gpio.hpp"
 #include <esp_rom_gpio.h>
 #include <soc/gpio_reg.h>
 #include <soc/gpio_struct.h>
@@ -87,6 +89,59 @@ private:
     uint32_t gpio_num_;
 };
 
+/**
+ * @brief StaticPin用のESP32ネイティブバックエンド
+ *
+ * 出力はW1TS/W1TCレジスタ、入力はINレジスタを直接操作する。
+ * ピン番号がコンパイル時定数であれば、バンクの選択とビットマスクは定数に畳み込まれる。
+ */
+struct ESP32NativePinBackend {
+    static void setMode(int pin_number, PinMode mode)
+    {
+        // モード設定は頻度が低いためArduino APIを使用する
+        framework::arduino::ArduinoPinBackend::setMode(pin_number, mode);
+    }
+
+    static void setLevel(int pin_number, PinLevel level)
+    {
+#if CONFIG_IDF_TARGET_ESP32
+        if (pin_number < 32) {
+            if (level == PinLevel::High) {
+                GPIO.out_w1ts = (1u << pin_number);
+            } else {
+                GPIO.out_w1tc = (1u << pin_number);
+            }
+        } else {
+            if (level == PinLevel::High) {
+                GPIO.out1_w1ts.val = (1u << (pin_number - 32));
+            } else {
+                GPIO.out1_w1tc.val = (1u << (pin_number - 32));
+            }
+        }
+#else
+        framework::arduino::ArduinoPinBackend::setLevel(pin_number, level);
+#endif
+    }
+
+    static PinLevel getLevel(int pin_number)
+    {
+#if CONFIG_IDF_TARGET_ESP32
+        uint32_t bits = (pin_number < 32) ? (GPIO.in >> pin_number) : (GPIO.in1.data >> (pin_number - 32));
+        return (bits & 0x01) ? PinLevel::High : PinLevel::Low;
+#else
+        return framework::arduino::ArduinoPinBackend::getLevel(pin_number);
+#endif
+    }
+};
+
+/**
+ * @brief ESP32のピン（コンパイル時ピン番号指定、レジスタ直接操作）
+ *
+ * @tparam PinNumber ピン番号
+ */
+template <int PinNumber>
+using ESP32StaticPin = StaticPin<PinNumber, ESP32NativePinBackend>;
+
 }  // namespace esp32
 }  // namespace platform
 }  // namespace flexhal
@@ -13,6 +13,9 @@
 #include "task.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#if defined(ESP_PLATFORM)
+#include <esp_timer.h>
+#endif
 
 namespace flexhal {
 
@@ -44,7 +47,12 @@ uint32_t millis()
 // 現在の時刻をマイクロ秒単位で取得
 uint32_t micros()
 {
+#if defined(ESP_PLATFORM)
+    // ティック単位ではミリ秒未満を計れないため、高分解能タイマーを使う
+    return (uint32_t)esp_timer_get_time();
+#else
     return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS * 1000);
+#endif
 }
 
 // 現在のタスクを一時的に中断
@@ -13,6 +13,7 @@
 #include "../../internal/task.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -201,8 +202,9 @@ private:
         }
 
         // タスク関数が終了したら自動的にタスクを停止
-        task->running_ = false;
+        // running_ を最後に更新し、isRunning() が false を返した後はインスタンスに触れない
         task->handle_  = nullptr;
+        task->running_ = false;
         vTaskDelete(nullptr);
     }
 
@@ -212,7 +214,7 @@ private:
     flexhal::TaskPriority priority_;
     int core_id_;
     TaskHandle_t handle_;
-    bool running_;
+    std::atomic<bool> running_;
 };
 
 }  // namespace freertos
@@ -12,9 +12,9 @@
 
 // SDL向け実装ファイルをインクルード
 #include "time.inl"  // 時間管理機能
+#include "task.inl"  // タスク
 
 // 以下は現在実装中または予定のファイル
 // #include "mutex.inl"
-// #include "task.inl"
 // #include "semaphore.inl"
 // #include "queue.inl"
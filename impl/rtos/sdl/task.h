@@ -22,35 +22,30 @@
 #include <string>
 #include <memory>
 #include <atomic>
+#include "../../internal/task.h"
 
 namespace flexhal {
 namespace rtos {
 
-/**
- * @brief タスク優先度
- */
-enum class TaskPriority { Low, Normal, High, Realtime };
-
 /**
  * @brief SDL_Threadを使用したタスククラス
+ *
+ * SDLのスレッドは外部から強制終了できないため、stop() はタスク関数が戻るまで待機する。
+ * タスク関数は終了条件を自身で確認すること
  */
-class Task {
+class Task : public flexhal::ITask {
 public:
     /**
      * @brief コンストラクタ
      *
      * @param name タスク名
      * @param function タスク関数
-     * @param priority タスク優先度
-     * @param stack_size スタックサイズ
+     * @param stack_size スタックサイズ（SDLでは使用しない）
+     * @param priority タスク優先度（SDLでは記録のみ）
      */
-    Task(const std::string& name, std::function<void()> function, TaskPriority priority = TaskPriority::Normal,
-         size_t stack_size = 4096)
-        : name_(name),
-          function_(function),
-          priority_(priority),
-          stack_size_(stack_size),
-          running_(false),
+    Task(const std::string& name, std::function<void()> function, size_t stack_size = 4096,
+         flexhal::TaskPriority priority = flexhal::TaskPriority::Normal)
+        : name_(name), function_(function), stack_size_(stack_size), priority_(priority), running_(false),
           thread_(nullptr)
     {
     }
@@ -58,7 +53,7 @@ public:
     /**
      * @brief デストラクタ
      */
-    ~Task()
+    virtual ~Task()
     {
         stop();
     }
@@ -69,40 +64,38 @@ public:
      * @return true 成功
      * @return false 失敗
      */
-    bool start()
+    bool start() override
     {
         if (running_) {
             return true;
         }
 
-        // スレッド終了フラグをリセット
-        should_exit_ = false;
+        // 前回終了したスレッドを回収
+        if (thread_) {
+            SDL_WaitThread(thread_, nullptr);
+            thread_ = nullptr;
+        }
 
-        // スレッド作成
-        thread_ = SDL_CreateThread(threadFunction, name_.c_str(), this);
+        // スレッドがすぐに終了しても状態が食い違わないよう、作成前に実行中にする
+        running_ = true;
+        thread_  = SDL_CreateThread(threadFunction, name_.c_str(), this);
         if (!thread_) {
+            running_ = false;
             return false;
         }
-
-        running_ = true;
         return true;
     }
 
     /**
-     * @brief タスク停止
+     * @brief タスク停止（タスク関数が戻るまで待機）
      */
-    void stop()
+    void stop() override
     {
-        if (!running_ || !thread_) {
+        if (!thread_) {
             return;
         }
 
-        // スレッド終了フラグをセット
-        should_exit_ = true;
-
-        // スレッド終了待ち
-        int result;
-        SDL_WaitThread(thread_, &result);
+        SDL_WaitThread(thread_, nullptr);
         thread_  = nullptr;
         running_ = false;
     }
@@ -113,11 +106,41 @@ public:
      * @return true 実行中
      * @return false 停止中
      */
-    bool isRunning() const
+    bool isRunning() const override
     {
         return running_;
     }
 
+    /**
+     * @brief タスク優先度を設定
+     *
+     * @param priority 設定する優先度
+     */
+    void setPriority(flexhal::TaskPriority priority) override
+    {
+        priority_ = priority;
+    }
+
+    /**
+     * @brief タスク優先度を取得
+     *
+     * @return TaskPriority 現在の優先度
+     */
+    flexhal::TaskPriority getPriority() const override
+    {
+        return priority_;
+    }
+
+    /**
+     * @brief タスク名を取得
+     *
+     * @return const std::string& タスク名
+     */
+    const std::string& getName() const override
+    {
+        return name_;
+    }
+
 private:
     /**
      * @brief スレッド関数
@@ -139,10 +162,9 @@ private:
 
     std::string name_;
     std::function<void()> function_;
-    TaskPriority priority_;
     size_t stack_size_;
+    flexhal::TaskPriority priority_;
     std::atomic<bool> running_;
-    std::atomic<bool> should_exit_;
     SDL_Thread* thread_;
 };
 
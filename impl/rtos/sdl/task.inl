@@ -0,0 +1,33 @@
+/**
+ * @file task.inl
+ * @brief FlexHAL - SDL向けタスク機能の実装
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <thread>
+#include "../../../src/flexhal/rtos.hpp"
+#include "task.h"
+
+namespace flexhal {
+
+// タスクを作成（SDLではコアを指定できない）
+std::shared_ptr<ITask> createTask(const std::string& name, std::function<void()> function, size_t stack_size,
+                                  TaskPriority priority, int core_id)
+{
+    (void)core_id;
+    return std::make_shared<rtos::Task>(name, function, stack_size, priority);
+}
+
+// 現在のタスクを一時的に中断
+void yield()
+{
+    std::this_thread::yield();
+}
+
+}  // namespace flexhal
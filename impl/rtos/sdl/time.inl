@@ -12,6 +12,7 @@
 
 #include <chrono>
 #include <thread>
+#include "../../../src/flexhal/rtos.hpp"
 
 // SDL2のヘッダーファイルのインクルード方法を条件分岐で実装
 #if defined(__has_include) && __has_include(<SDL2/SDL.h>)
@@ -26,14 +27,21 @@ namespace flexhal {
 static std::chrono::time_point<std::chrono::steady_clock> start_time = std::chrono::steady_clock::now();
 
 // 現在の時間をミリ秒単位で取得
-unsigned long millis()
+uint32_t millis()
 {
     auto now = std::chrono::steady_clock::now();
-    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time).count());
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time).count());
+}
+
+// 現在の時間をマイクロ秒単位で取得
+uint32_t micros()
+{
+    auto now = std::chrono::steady_clock::now();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - start_time).count());
 }
 
 // 指定されたミリ秒数だけスリープ
-void sleep(unsigned int ms)
+void sleep(uint32_t ms)
 {
     std::this_thread::sleep_for(std::chrono::milliseconds(ms));
 }
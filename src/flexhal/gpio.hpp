@@ -14,6 +14,10 @@
 #include "core.hpp"
 #include "../../impl/internal/pin.h"
 #include "../../impl/internal/gpio.h"
+#include "../../impl/internal/gpio_program.h"
+#include "../../impl/internal/soft_pwm.h"
+#include "../../impl/internal/debounce.h"
+#include "../../impl/internal/static_pin.h"
 
 namespace flexhal {
 
@@ -32,6 +36,16 @@ std::shared_ptr<IGPIOPort> getDefaultGPIOPort();
  */
 std::shared_ptr<IPin> getPin(int pin_number);
 
+/**
+ * @brief 指定したピン番号のピンへの非所有ハンドルを取得
+ *
+ * デフォルトのGPIOポートはプログラム終了まで存在するため、ハンドルは保持し続けてよい
+ *
+ * @param pin_number ピン番号
+ * @return PinRef ピンハンドル（ポートが利用できない場合は無効なハンドル）
+ */
+PinRef getPinRef(int pin_number);
+
 }  // namespace flexhal
 
 #endif  // FLEXHAL_GPIO_HPP
@@ -14,6 +14,8 @@
 #include "core.hpp"
 #include "gpio.hpp"
 #include "../../impl/internal/i2c.h"
+#include "../../impl/internal/i2c_register_cache.h"
+#include "../../impl/internal/software_i2c.h"
 
 namespace flexhal {
 
@@ -46,11 +48,27 @@ std::shared_ptr<I2CBusImplementation> createSoftwareI2CImplementation();
 /**
  * @brief I2Cバス上のデバイスをスキャン
  *
+ * バスの在否キャッシュを使用するため、2回目以降は未確認のアドレスだけをプローブします。
+ * デバイスを抜き差しした場合は II2CBus::notifyHotPlug() で通知してください
+ *
  * @param bus スキャンするI2Cバス
  * @return std::vector<I2CAddress> 見つかったデバイスのアドレスリスト
  */
 std::vector<I2CAddress> scanI2CDevices(std::shared_ptr<II2CBus> bus);
 
+/**
+ * @brief 複数のI2Cバス上のデバイスをスキャン
+ *
+ * 並列スキャンでは、バスごとのスレッドで同時にプローブします。
+ * 各バスは異なるピン（または異なるコントローラ）を使用している必要があります
+ *
+ * @param buses スキャンするI2Cバスのリスト
+ * @param parallel 並列にスキャンするか
+ * @return std::vector<std::vector<I2CAddress>> バスごとの見つかったデバイスのアドレスリスト
+ */
+std::vector<std::vector<I2CAddress>> scanI2CBuses(const std::vector<std::shared_ptr<II2CBus>>& buses,
+                                                  bool parallel = true);
+
 }  // namespace flexhal
 
 #endif  // FLEXHAL_I2C_HPP
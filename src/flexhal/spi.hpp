@@ -14,6 +14,12 @@
 #include "core.hpp"
 #include "gpio.hpp"
 #include "../../impl/internal/spi.h"
+#include "../../impl/internal/bit_reverse.h"
+#include "../../impl/internal/software_spi.h"
+#include "../../impl/internal/spi_arbiter.h"
+#include "../../impl/internal/spi_flash.h"
+#include "../../impl/internal/command_stream.h"
+#include "../../impl/internal/display.h"
 
 namespace flexhal {
 
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+# FlexHAL チャタリング除去テスト用ビルドスクリプト
+#
+# デスクトップシミュレータのピン状態テーブルにチャタリングを含む入力を与え、
+# チャタリング除去後のエッジを確認する
+
+# ディレクトリ設定
+FLEXHAL_DIR="$(cd "$(dirname "$0")/../.." && pwd)"
+BUILD_DIR="${FLEXHAL_DIR}/build/debounce_test"
+SRC_DIR="${FLEXHAL_DIR}/tests/debounce_test/src"
+
+# ビルドディレクトリの作成
+mkdir -p "${BUILD_DIR}"
+
+# コンパイラフラグ
+CXXFLAGS="-std=c++17 -O2 -Wall -Wextra -pthread -I${FLEXHAL_DIR}/src -I${FLEXHAL_DIR} $*"
+CXXFLAGS="${CXXFLAGS} -DFLEXHAL_PLATFORM_DESKTOP -DFLEXHAL_RTOS_SDL"
+
+# ソースファイル（デスクトップ向けの実装一式をリンクする）
+SOURCES=(
+    "${SRC_DIR}/main.cpp"
+    "${FLEXHAL_DIR}/src/FlexHAL_Impl.cpp"
+    "${FLEXHAL_DIR}/src/flexhal/core.cpp"
+    "${FLEXHAL_DIR}/src/flexhal/framework.cpp"
+    "${FLEXHAL_DIR}/src/flexhal/logger.cpp"
+    "${FLEXHAL_DIR}/src/flexhal/platform.cpp"
+    "${FLEXHAL_DIR}/src/flexhal/rtos.cpp"
+)
+
+# SDL2の依存関係を確認
+if command -v sdl2-config &> /dev/null; then
+    CXXFLAGS="${CXXFLAGS} $(sdl2-config --cflags)"
+    LDFLAGS="$(sdl2-config --libs)"
+else
+    echo "SDL2 not found, desktop simulation may not work properly"
+fi
+
+# コンパイル
+echo "Compiling debounce test..."
+g++ ${CXXFLAGS} ${SOURCES[@]} -o "${BUILD_DIR}/debounce_test" ${LDFLAGS}
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Executable: ${BUILD_DIR}/debounce_test"
+    echo "Run with: ${BUILD_DIR}/debounce_test"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,127 @@
+/**
+ * @file main.cpp
+ * @brief FlexHAL - チャタリング除去テスト
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "FlexHAL.hpp"
+#include "impl/platforms/desktop/gpio.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using namespace flexhal;
+using namespace flexhal::platform::desktop;
+
+static int failures = 0;
+
+static void check(bool condition, const char* name)
+{
+    printf("[%s] %s\n", condition ? "PASS" : "FAIL", name);
+    if (!condition) {
+        ++failures;
+    }
+}
+
+/**
+ * @brief 入力ピンにレベル列を与え、1サンプルごとに update() を呼ぶ
+ *
+ * @param pattern 入力レベル列（'1'でHigh、それ以外でLow）
+ * @param edge_at 最初に安定レベルが変化したサンプルの位置を格納する（nullptrで格納しない）
+ * @return int 安定レベルが変化した回数
+ */
+static int feed(const std::shared_ptr<SimulatedGPIOPort>& port, DebouncedInputs& inputs, int pin_number,
+                const char* pattern, int* edge_at = nullptr)
+{
+    int edges = 0;
+    for (int i = 0; pattern[i] != '\0'; ++i) {
+        port->getPinTable()->setExternalLevel(pin_number, pattern[i] == '1' ? PinLevel::High : PinLevel::Low);
+        inputs.update();
+
+        int bank = pin_number / GPIO_PINS_PER_BANK;
+        if (inputs.takeChanged(bank) & (1u << (pin_number % GPIO_PINS_PER_BANK))) {
+            if (edge_at && edges == 0) {
+                *edge_at = i;
+            }
+            ++edges;
+        }
+    }
+    return edges;
+}
+
+static void testBouncingInput(const std::shared_ptr<SimulatedGPIOPort>& port)
+{
+    // 4回連続で一致したら安定とみなす
+    DebouncedInputs inputs(port, 4);
+    port->getPinTable()->setExternalLevel(2, PinLevel::Low);
+    port->getPinTable()->setExternalLevel(35, PinLevel::High);
+    inputs.update();
+    check(inputs.getLevel(2) == PinLevel::Low && inputs.getLevel(35) == PinLevel::High,
+          "first sample becomes the stable level");
+
+    // 閾値未満の連続で途切れるチャタリングは無視する
+    check(feed(port, inputs, 2, "1101110111011") == 0, "bounces shorter than the threshold are ignored");
+    check(inputs.getLevel(2) == PinLevel::Low, "stable level stays low while bouncing");
+
+    // チャタリングの後、4回連続でHighになった時点で1回だけ立ち上がる
+    int edge_at = -1;
+    check(feed(port, inputs, 2, "010110111111", &edge_at) == 1, "bouncing press gives a single rising edge");
+    check(edge_at == 9, "rising edge is reported on the fourth consecutive sample");
+    check(inputs.getLevel(2) == PinLevel::High, "stable level is high after the press");
+
+    edge_at = -1;
+    check(feed(port, inputs, 2, "1011010000000", &edge_at) == 1, "bouncing release gives a single falling edge");
+    check(edge_at == 9, "falling edge is reported on the fourth consecutive sample");
+    check(inputs.getLevel(2) == PinLevel::Low, "stable level is low after the release");
+
+    // 別バンクのピンは独立して積分する
+    check(feed(port, inputs, 35, "0000") == 1 && inputs.getLevel(35) == PinLevel::Low,
+          "pins in other banks are debounced");
+    check(inputs.takeChanged(0) == 0 && inputs.takeChanged(1) == 0, "changes are cleared once taken");
+}
+
+static void testSamplingTask(const std::shared_ptr<SimulatedGPIOPort>& port)
+{
+    DebouncedInputs inputs(port, 4);
+    port->getPinTable()->setExternalLevel(3, PinLevel::Low);
+
+    check(inputs.start(1000) && inputs.isRunning(), "sampling task is started");
+    check(!inputs.start(1000), "sampling task is started only once");
+    flexhal::sleep(10);
+
+    // サンプリング間隔より短いパルスは無視する
+    port->getPinTable()->setExternalLevel(3, PinLevel::High);
+    port->getPinTable()->setExternalLevel(3, PinLevel::Low);
+    flexhal::sleep(20);
+    check(inputs.getLevel(3) == PinLevel::Low && inputs.takeChanged(0) == 0, "glitch is filtered by the task");
+
+    port->getPinTable()->setExternalLevel(3, PinLevel::High);
+    flexhal::sleep(20);
+    check(inputs.getLevel(3) == PinLevel::High && (inputs.takeChanged(0) & (1u << 3)),
+          "held level is reported by the task");
+
+    inputs.stop();
+    check(!inputs.isRunning(), "sampling task is stopped");
+}
+
+int main()
+{
+    // テスト中はウィンドウを表示しない
+    setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+    printf("FlexHAL debounce test\n");
+
+    auto port = std::make_shared<SimulatedGPIOPort>(64, "FlexHAL Debounce Test");
+    for (int pin_number : {2, 3, 35}) {
+        port->getPinTable()->setMode(pin_number, PinMode::Input);
+    }
+    testBouncingInput(port);
+    testSamplingTask(port);
+
+    printf("%s (%d failure(s))\n", failures == 0 ? "All tests passed" : "Tests failed", failures);
+    return failures == 0 ? 0 : 1;
+}
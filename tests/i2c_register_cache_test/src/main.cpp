@@ -0,0 +1,225 @@
+/**
+ * @file main.cpp
+ * @brief FlexHAL - I2Cレジスタキャッシュテスト
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "FlexHAL.hpp"
+#include "impl/platforms/desktop/i2c.hpp"
+#include <cstdio>
+#include <memory>
+
+using namespace flexhal;
+using namespace flexhal::platform::desktop;
+
+static const I2CAddress ADDRESS = 0x40;
+
+// レジスタ配置
+static const uint8_t REG_STATUS  = 0x00;  ///< 読み込むたびに値が変わる
+static const uint8_t REG_CONFIG  = 0x01;
+static const uint8_t REG_COMMAND = 0x03;  ///< 書き込み専用
+static const uint8_t REG_LIMIT   = 0x05;
+
+/**
+ * @brief レジスタごとの読み込み回数を記録するデバイスモデル
+ */
+class RegisterDevice : public SimulatedI2CDevice {
+public:
+    bool start(bool read) override
+    {
+        address_phase_ = !read;
+        return true;
+    }
+
+    bool write(uint8_t data) override
+    {
+        if (address_phase_) {
+            pointer_       = data;
+            address_phase_ = false;
+            return true;
+        }
+        if (pointer_ == nack_register_) {
+            return false;
+        }
+        registers_[pointer_++] = data;
+        return true;
+    }
+
+    uint8_t read() override
+    {
+        ++read_counts_[pointer_];
+        uint8_t value = registers_[pointer_];
+        if (pointer_ == REG_STATUS) {
+            ++registers_[REG_STATUS];
+        }
+        ++pointer_;
+        return value;
+    }
+
+    uint8_t registers_[256] = {};
+    int read_counts_[256]   = {};
+    int nack_register_      = -1;  ///< このレジスタへのデータ書き込みをNACKする（-1で無効）
+
+private:
+    uint8_t pointer_    = 0;
+    bool address_phase_ = false;
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char* name)
+{
+    printf("[%s] %s\n", condition ? "PASS" : "FAIL", name);
+    if (!condition) {
+        ++failures;
+    }
+}
+
+/**
+ * @brief テスト対象のキャッシュを作成
+ */
+static std::unique_ptr<I2CRegisterCache> createCache(std::shared_ptr<RegisterDevice>& device)
+{
+    auto implementation = std::make_shared<SimulatedI2CImplementation>();
+    device              = std::make_shared<RegisterDevice>();
+    implementation->attachDevice(ADDRESS, device);
+
+    I2CDeviceConfig device_config;
+    device_config.address = ADDRESS;
+    auto transport        = implementation->createTransport(I2CBusConfig(), device_config);
+    transport->begin();
+
+    std::unique_ptr<I2CRegisterCache> cache(new I2CRegisterCache(transport));
+    cache->declare(REG_STATUS, I2CRegisterKind::Volatile);
+    cache->declare(REG_CONFIG, REG_CONFIG + 1, I2CRegisterKind::Cacheable);
+    cache->declare(REG_COMMAND, I2CRegisterKind::WriteOnly);
+    cache->declare(REG_LIMIT, REG_LIMIT + 2, I2CRegisterKind::Cacheable);
+    return cache;
+}
+
+static void testVolatile()
+{
+    std::shared_ptr<RegisterDevice> device;
+    auto cache = createCache(device);
+
+    uint8_t first  = 0;
+    uint8_t second = 0;
+    check(cache->readRegister(REG_STATUS, first) && cache->readRegister(REG_STATUS, second),
+          "volatile register is read");
+    check(device->read_counts_[REG_STATUS] == 2 && second == first + 1,
+          "volatile register is read from bus every time");
+}
+
+static void testCacheable()
+{
+    std::shared_ptr<RegisterDevice> device;
+    auto cache = createCache(device);
+
+    device->registers_[REG_CONFIG] = 0x12;
+    uint8_t value                  = 0;
+    check(cache->readRegister(REG_CONFIG, value) && value == 0x12, "cacheable register is read");
+
+    device->registers_[REG_CONFIG] = 0x34;
+    check(cache->readRegister(REG_CONFIG, value) && value == 0x12, "cacheable register is answered from cache");
+    check(device->read_counts_[REG_CONFIG] == 1, "cacheable register is read from bus once");
+
+    check(cache->writeRegister(REG_CONFIG, 0x56) && device->registers_[REG_CONFIG] == 0x56,
+          "write goes through to device");
+    check(cache->readRegister(REG_CONFIG, value) && value == 0x56 && device->read_counts_[REG_CONFIG] == 1,
+          "written value is cached");
+
+    cache->invalidate(REG_CONFIG);
+    check(cache->readRegister(REG_CONFIG, value) && device->read_counts_[REG_CONFIG] == 2,
+          "invalidated register is read again");
+}
+
+static void testWriteOnly()
+{
+    std::shared_ptr<RegisterDevice> device;
+    auto cache = createCache(device);
+
+    uint8_t data[REG_LIMIT + 3] = {};
+    check(!cache->readRegisters(REG_STATUS, data, sizeof(data)), "unknown write-only register fails the read");
+    check(device->read_counts_[REG_STATUS] == 0, "failed read does not touch the bus");
+
+    check(cache->writeRegister(REG_COMMAND, 0xA5), "write-only register is written");
+    device->registers_[REG_COMMAND] = 0x00;  // 実機では読み込めない
+    device->registers_[REG_LIMIT]   = 0x77;
+
+    I2CRegisterCacheStatistics before = cache->getStatistics();
+    check(cache->readRegisters(REG_STATUS, data, sizeof(data)),
+          "span containing written write-only register is read");
+    I2CRegisterCacheStatistics after = cache->getStatistics();
+    check(data[REG_COMMAND] == 0xA5 && data[REG_LIMIT] == 0x77, "span returns cached and bus values");
+    check(device->read_counts_[REG_COMMAND] == 0, "write-only register is never read from bus");
+    check(after.bus_reads - before.bus_reads == 2, "bus read is split around write-only register");
+
+    int volatile_reads = device->read_counts_[REG_COMMAND + 1];
+    cache->preload(REG_COMMAND + 1, 0x00);
+    check(cache->readRegisters(REG_CONFIG, data, 4) && device->read_counts_[REG_COMMAND + 1] == volatile_reads + 1,
+          "preload is ignored for volatile register");
+}
+
+static void testUpdateBits()
+{
+    std::shared_ptr<RegisterDevice> device;
+    auto cache = createCache(device);
+
+    device->registers_[REG_CONFIG] = 0xF0;
+    check(cache->updateBits(REG_CONFIG, 0x0F, 0x05) && device->registers_[REG_CONFIG] == 0xF5,
+          "uncached read-modify-write");
+    check(device->read_counts_[REG_CONFIG] == 1, "uncached read-modify-write reads once");
+
+    I2CRegisterCacheStatistics before = cache->getStatistics();
+    check(cache->updateBits(REG_CONFIG, 0x80, 0x00) && device->registers_[REG_CONFIG] == 0x75,
+          "cached read-modify-write");
+    check(device->read_counts_[REG_CONFIG] == 1, "cached read-modify-write does not read");
+
+    check(cache->updateBits(REG_CONFIG, 0x80, 0x00), "unchanged read-modify-write");
+    I2CRegisterCacheStatistics after = cache->getStatistics();
+    check(after.bus_writes - before.bus_writes == 1 && after.skipped_writes - before.skipped_writes == 1,
+          "unchanged value is not written");
+
+    check(!cache->updateBits(REG_COMMAND, 0x01, 0x01), "unknown write-only register cannot be modified");
+    cache->preload(REG_COMMAND, 0x10);
+    check(cache->updateBits(REG_COMMAND, 0x01, 0x01) && device->registers_[REG_COMMAND] == 0x11,
+          "preloaded write-only register is modified");
+}
+
+static void testNackInvalidation()
+{
+    std::shared_ptr<RegisterDevice> device;
+    auto cache = createCache(device);
+
+    uint8_t limits[3] = {1, 2, 3};
+    check(cache->writeRegisters(REG_LIMIT, limits, sizeof(limits)), "registers are written");
+
+    // 2バイト目でNACKされると、それ以降のデバイス上の値は不明になる
+    device->nack_register_ = REG_LIMIT + 1;
+    uint8_t updated[3]     = {4, 5, 6};
+    check(!cache->writeRegisters(REG_LIMIT, updated, sizeof(updated)), "NACKed write fails");
+    device->nack_register_ = -1;
+
+    uint8_t data[3] = {};
+    check(cache->readRegisters(REG_LIMIT, data, sizeof(data)), "registers are read after NACK");
+    check(data[0] == 4 && data[1] == 2 && data[2] == 3, "values reflect the device after NACK");
+    check(device->read_counts_[REG_LIMIT] == 1, "NACKed range is read from bus again");
+}
+
+int main()
+{
+    printf("FlexHAL I2C register cache test\n");
+
+    testVolatile();
+    testCacheable();
+    testWriteOnly();
+    testUpdateBits();
+    testNackInvalidation();
+
+    printf("%s (%d failure(s))\n", failures == 0 ? "All tests passed" : "Tests failed", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file main.cpp
+ * @brief FlexHAL - パラレルバステスト
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "FlexHAL.hpp"
+#include "impl/platforms/desktop/gpio.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace flexhal;
+using namespace flexhal::platform::desktop;
+
+static int failures = 0;
+
+static void check(bool condition, const char* name)
+{
+    printf("[%s] %s\n", condition ? "PASS" : "FAIL", name);
+    if (!condition) {
+        ++failures;
+    }
+}
+
+/**
+ * @brief バンク単位の出力を記録するGPIOポート
+ */
+class RecordingGPIOPort : public SimulatedGPIOPort {
+public:
+    struct Write {
+        int bank;
+        uint32_t values;
+        uint32_t mask;
+    };
+
+    RecordingGPIOPort() : SimulatedGPIOPort(64, "FlexHAL Parallel Bus Test") {}
+
+    using SimulatedGPIOPort::setLevels;
+
+    void setLevels(int bank, uint32_t values, uint32_t mask) override
+    {
+        writes.push_back(Write{bank, values, mask});
+        SimulatedGPIOPort::setLevels(bank, values, mask);
+    }
+
+    std::vector<Write> writes;
+};
+
+static void testInvalidPins(const std::shared_ptr<RecordingGPIOPort>& port)
+{
+    ParallelBusPort duplicated(port, {0, 1, 2, 1});
+    check(duplicated.getDataWidth() == 0 && !duplicated.begin(), "duplicate data pin is rejected");
+
+    ParallelBusPort wr_in_data(port, {0, 1, 2, 3}, 2);
+    check(wr_in_data.getDataWidth() == 0 && !wr_in_data.begin(), "WR pin shared with data is rejected");
+
+    ParallelBusPort out_of_range(port, {0, 1, 64});
+    check(out_of_range.getDataWidth() == 0, "pin outside the port is rejected");
+
+    ParallelBusPort valid(port, {0, 1, 2, 3}, 4);
+    check(valid.getDataWidth() == 4 && valid.begin(), "distinct pins are accepted");
+}
+
+static void testTwoBanks(const std::shared_ptr<RecordingGPIOPort>& port)
+{
+    // D0〜D3はバンク0のピン28〜31、D4〜D7はバンク1のピン32〜35、WRはバンク1のピン40
+    ParallelBusPort bus(port, {28, 29, 30, 31, 32, 33, 34, 35}, 40);
+    check(bus.begin() && bus.getDataWidth() == 8, "8-bit bus over two banks is accepted");
+
+    port->writes.clear();
+    bus.write(0xA5);
+    check(port->writes.size() == 2, "write emits one setLevels per bank");
+    if (port->writes.size() == 2) {
+        check(port->writes[0].bank == 0 && port->writes[0].mask == 0xF0000000u &&
+                  port->writes[0].values == 0x50000000u,
+              "low nibble goes to bank 0 pins 28-31");
+        check(port->writes[1].bank == 1 && port->writes[1].mask == 0x0000000Fu && port->writes[1].values == 0x0Au,
+              "high nibble goes to bank 1 pins 32-35");
+    }
+
+    // WRはデータの上位側と同じバンクなので、データと同時にLowにしてから立ち上げる
+    port->writes.clear();
+    const uint8_t data[] = {0x3C};
+    bus.writeBlock(data, 1);
+    check(port->writes.size() == 3, "strobe emits data per bank and one WR rise");
+    if (port->writes.size() == 3) {
+        check(port->writes[0].bank == 0 && port->writes[0].mask == 0xF0000000u &&
+                  port->writes[0].values == 0xC0000000u,
+              "strobe drives bank 0 data");
+        check(port->writes[1].bank == 1 && port->writes[1].mask == 0x0000010Fu && port->writes[1].values == 0x03u,
+              "strobe drives bank 1 data with WR low");
+        check(port->writes[2].bank == 1 && port->writes[2].mask == 0x00000100u &&
+                  port->writes[2].values == 0x00000100u,
+              "WR rises after the data");
+    }
+
+    auto table = port->getPinTable();
+    uint8_t read_back = 0;
+    for (int bit = 0; bit < 8; ++bit) {
+        if (table->getLevel(bit < 4 ? 28 + bit : 32 + bit - 4) == PinLevel::High) {
+            read_back |= static_cast<uint8_t>(1u << bit);
+        }
+    }
+    check(read_back == 0x3C && table->getLevel(40) == PinLevel::High, "pins hold the last value");
+}
+
+int main()
+{
+    // テスト中はウィンドウを表示しない
+    setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+    printf("FlexHAL parallel bus test\n");
+
+    auto port = std::make_shared<RecordingGPIOPort>();
+    testInvalidPins(port);
+    testTwoBanks(port);
+
+    printf("%s (%d failure(s))\n", failures == 0 ? "All tests passed" : "Tests failed", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# FlexHAL ピクセルフォーマット変換ベンチマーク用ビルドスクリプト
+#
+# 追加の引数はコンパイラフラグとして渡される（例: ./build.sh -mavx2、./build.sh -DFLEXHAL_NO_SIMD）
+
+# ディレクトリ設定
+FLEXHAL_DIR="$(cd "$(dirname "$0")/../.." && pwd)"
+BUILD_DIR="${FLEXHAL_DIR}/build/pixel_format_bench"
+SRC_DIR="${FLEXHAL_DIR}/tests/pixel_format_bench/src"
+
+# ビルドディレクトリの作成
+mkdir -p "${BUILD_DIR}"
+
+# コンパイラフラグ
+CXXFLAGS="-std=c++14 -O2 -Wall -Wextra -I${FLEXHAL_DIR}/src -I${FLEXHAL_DIR} $*"
+
+# 変換処理は他に依存しないので、実装ファイルを直接インクルードする
+SOURCES=(
+    "${SRC_DIR}/main.cpp"
+)
+
+# コンパイル
+echo "Compiling pixel format benchmark..."
+g++ ${CXXFLAGS} ${SOURCES[@]} -o "${BUILD_DIR}/pixel_format_bench"
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Executable: ${BUILD_DIR}/pixel_format_bench"
+    echo "Run with: ${BUILD_DIR}/pixel_format_bench"
+else
+    echo "Build failed!"
+    exit 1
+fi
@@ -0,0 +1,229 @@
+/**
+ * @file main.cpp
+ * @brief FlexHAL - ピクセルフォーマット変換ベンチマーク
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "impl/internal/bit_reverse.inl"
+#include "impl/internal/pixel_format.inl"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace flexhal;
+
+// 240x320のフレームで計測する
+static const size_t WIDTH        = 240;
+static const size_t HEIGHT       = 320;
+static const size_t PIXELS       = WIDTH * HEIGHT;
+static const int ITERATIONS      = 200;
+static const double SPI_CLOCK_HZ = 40000000.0;
+
+// 比較用の1画素ずつのスカラー実装
+static void referenceRGB565(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint16_t color = static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    dst[0]         = static_cast<uint8_t>(color >> 8);
+    dst[1]         = static_cast<uint8_t>(color);
+}
+
+static uint8_t referenceExpand6(uint16_t value5)
+{
+    return static_cast<uint8_t>(((value5 << 1) | (value5 >> 4)) << 2);
+}
+
+/**
+ * @brief 1フレームあたりの変換時間を計測して表示
+ *
+ * @param name 変換名
+ * @param output_bytes 1フレームの出力バイト数
+ * @param convert 変換処理
+ * @param reference 比較用の実装
+ * @param output 変換処理の出力先
+ * @param expected 比較用の実装の出力先
+ * @return true 出力が一致
+ * @return false 出力が不一致
+ */
+static bool benchmark(const char* name, size_t output_bytes, const std::function<void()>& convert,
+                      const std::function<void()>& reference, const std::vector<uint8_t>& output,
+                      const std::vector<uint8_t>& expected)
+{
+    convert();
+    reference();
+    bool matched = std::memcmp(output.data(), expected.data(), output_bytes) == 0;
+
+    auto measure = [](const std::function<void()>& func) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            func();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::micro>(elapsed).count() / ITERATIONS;
+    };
+
+    double kernel_us    = measure(convert);
+    double reference_us = measure(reference);
+    double transfer_us  = output_bytes * 8 / SPI_CLOCK_HZ * 1000000.0;
+
+    printf("%-24s %9.1f us %9.1f us %7.2fx %9.1f us  %s\n", name, kernel_us, reference_us, reference_us / kernel_us,
+           transfer_us, matched ? "OK" : "MISMATCH");
+    return matched;
+}
+
+/**
+ * @brief バイト列のビット順反転を1バイトずつの表引きと比較
+ *
+ * SIMDの本体ループ（AVX2は32バイト、SSSE3/NEONは16バイト単位）と端数処理の境界をすべて通るよう、
+ * 長さ0〜100と入力位置のずれの組み合わせで、コピー・インプレースの両方を確認する
+ *
+ * @param rng 入力データの生成に使用する乱数
+ * @return true 全ての長さで一致
+ * @return false 不一致あり
+ */
+static bool checkReverseBitOrder(std::mt19937& rng)
+{
+    const size_t max_length = 100;
+    const size_t guard      = 32;
+    const uint8_t fill      = 0xA5;
+
+    std::vector<uint8_t> src(max_length + guard);
+    for (auto& v : src) {
+        v = static_cast<uint8_t>(rng());
+    }
+
+    size_t mismatches = 0;
+    for (size_t offset = 0; offset < 4; ++offset) {
+        for (size_t length = 0; length <= max_length; ++length) {
+            const uint8_t* input = src.data() + offset;
+
+            // 出力の前後に番兵を置き、範囲外への書き込みも検出する
+            std::vector<uint8_t> copied(offset + length + guard, fill);
+            reverseBitOrder(input, copied.data() + offset, length);
+
+            std::vector<uint8_t> in_place(input, input + length);
+            reverseBitOrder(in_place.data(), length);
+
+            bool matched = true;
+            for (size_t i = 0; i < copied.size(); ++i) {
+                bool inside = i >= offset && i < offset + length;
+                if (copied[i] != (inside ? reverseBitOrder(input[i - offset]) : fill)) {
+                    matched = false;
+                }
+            }
+            for (size_t i = 0; i < length; ++i) {
+                if (in_place[i] != reverseBitOrder(input[i])) {
+                    matched = false;
+                }
+            }
+            if (!matched) {
+                printf("bit reverse mismatch: offset %zu, length %zu\n", offset, length);
+                ++mismatches;
+            }
+        }
+    }
+
+    printf("%-24s %s\n", "bit reverse (0-100 B)", mismatches == 0 ? "OK" : "MISMATCH");
+    return mismatches == 0;
+}
+
+int main()
+{
+    std::mt19937 rng(12345);
+
+    std::vector<uint8_t> rgb888(PIXELS * 3);
+    std::vector<uint32_t> argb8888(PIXELS);
+    std::vector<uint16_t> rgb565(PIXELS);
+    std::vector<uint8_t> gray8(PIXELS);
+    std::vector<uint16_t> palette(256);
+    for (auto& v : rgb888) {
+        v = static_cast<uint8_t>(rng());
+    }
+    for (auto& v : argb8888) {
+        v = static_cast<uint32_t>(rng());
+    }
+    for (auto& v : rgb565) {
+        v = static_cast<uint16_t>(rng());
+    }
+    for (auto& v : gray8) {
+        v = static_cast<uint8_t>(rng());
+    }
+    for (auto& v : palette) {
+        v = static_cast<uint16_t>(rng());
+    }
+
+    std::vector<uint8_t> output(PIXELS * 3);
+    std::vector<uint8_t> expected(PIXELS * 3);
+
+    printf("FlexHAL pixel format benchmark (%zux%zu, backend: %s)\n", WIDTH, HEIGHT, pixel::getBackendName());
+    printf("%-24s %12s %12s %8s %12s\n", "conversion", "kernel", "per-pixel", "speedup", "SPI@40MHz");
+
+    bool ok = true;
+    ok &= benchmark(
+        "RGB565 byte swap", PIXELS * 2, [&] { pixel::swapRGB565(rgb565.data(), output.data(), PIXELS); },
+        [&] {
+            for (size_t i = 0; i < PIXELS; ++i) {
+                expected[i * 2]     = static_cast<uint8_t>(rgb565[i] >> 8);
+                expected[i * 2 + 1] = static_cast<uint8_t>(rgb565[i]);
+            }
+        },
+        output, expected);
+    ok &= benchmark(
+        "RGB888 -> RGB565", PIXELS * 2,
+        [&] { pixel::convertRGB888ToRGB565(rgb888.data(), output.data(), PIXELS); },
+        [&] {
+            for (size_t i = 0; i < PIXELS; ++i) {
+                referenceRGB565(&expected[i * 2], rgb888[i * 3], rgb888[i * 3 + 1], rgb888[i * 3 + 2]);
+            }
+        },
+        output, expected);
+    ok &= benchmark(
+        "ARGB8888 -> RGB565", PIXELS * 2,
+        [&] { pixel::convertARGB8888ToRGB565(argb8888.data(), output.data(), PIXELS); },
+        [&] {
+            for (size_t i = 0; i < PIXELS; ++i) {
+                uint32_t c = argb8888[i];
+                referenceRGB565(&expected[i * 2], static_cast<uint8_t>(c >> 16), static_cast<uint8_t>(c >> 8),
+                                static_cast<uint8_t>(c));
+            }
+        },
+        output, expected);
+    ok &= benchmark(
+        "RGB565 -> RGB666", PIXELS * 3,
+        [&] { pixel::convertRGB565ToRGB666(rgb565.data(), output.data(), PIXELS); },
+        [&] {
+            for (size_t i = 0; i < PIXELS; ++i) {
+                expected[i * 3]     = referenceExpand6(rgb565[i] >> 11);
+                expected[i * 3 + 1] = static_cast<uint8_t>(((rgb565[i] >> 5) & 0x3F) << 2);
+                expected[i * 3 + 2] = referenceExpand6(rgb565[i] & 0x1F);
+            }
+        },
+        output, expected);
+    ok &= benchmark(
+        "Gray8 -> RGB565", PIXELS * 2, [&] { pixel::convertGray8ToRGB565(gray8.data(), output.data(), PIXELS); },
+        [&] {
+            for (size_t i = 0; i < PIXELS; ++i) {
+                referenceRGB565(&expected[i * 2], gray8[i], gray8[i], gray8[i]);
+            }
+        },
+        output, expected);
+    ok &= benchmark(
+        "Indexed8 -> RGB565", PIXELS * 2,
+        [&] { pixel::convertIndexed8ToRGB565(gray8.data(), output.data(), PIXELS, palette.data()); },
+        [&] {
+            for (size_t i = 0; i < PIXELS; ++i) {
+                expected[i * 2]     = static_cast<uint8_t>(palette[gray8[i]] >> 8);
+                expected[i * 2 + 1] = static_cast<uint8_t>(palette[gray8[i]]);
+            }
+        },
+        output, expected);
+    ok &= checkReverseBitOrder(rng);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file main.cpp
+ * @brief FlexHAL - ソフトウェアPWMテスト
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "FlexHAL.hpp"
+#include "impl/platforms/desktop/gpio.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using namespace flexhal;
+using namespace flexhal::platform::desktop;
+
+static const uint32_t PERIOD_US = 2000;
+
+static int failures = 0;
+
+static void check(bool condition, const char* name)
+{
+    printf("[%s] %s\n", condition ? "PASS" : "FAIL", name);
+    if (!condition) {
+        ++failures;
+    }
+}
+
+static bool isHigh(const std::shared_ptr<SimulatedGPIOPort>& port, int pin_number)
+{
+    return port->getPinTable()->getLevel(pin_number) == PinLevel::High;
+}
+
+static void testAttach(const std::shared_ptr<SimulatedGPIOPort>& port)
+{
+    SoftPWM pwm(port, PERIOD_US);
+
+    int channel = pwm.attach(3, SoftPWM::DUTY_MAX);
+    check(channel == 0, "pin is attached");
+    check(port->getPinTable()->getMode(3) == PinMode::Output, "attached pin is an output");
+
+    pwm.runPeriod();
+    check(isHigh(port, 3), "full duty pin stays high after a period");
+
+    // 失敗した登録はピンを変更しない
+    check(pwm.attach(3, 0) == -1, "pin cannot be attached twice");
+    check(isHigh(port, 3), "duplicate attach leaves the pin untouched");
+
+    port->getPinTable()->setMode(40, PinMode::Input);
+    check(pwm.attach(64, 0) == -1 && pwm.attach(-1, 0) == -1, "pin outside the port is rejected");
+    check(port->getPinTable()->getMode(40) == PinMode::Input, "rejected attach leaves other pins untouched");
+
+    // 解除したチャンネルは再利用する
+    pwm.detach(channel);
+    check(!isHigh(port, 3), "detached pin is driven low");
+    check(pwm.attach(40, 0) == 0, "free channel is reused");
+    check(!pwm.setDuty(1, 100), "unused channel is rejected");
+}
+
+static void testPeriod(const std::shared_ptr<SimulatedGPIOPort>& port)
+{
+    SoftPWM pwm(port, PERIOD_US);
+    int full = pwm.attach(5, SoftPWM::DUTY_MAX);
+    int half = pwm.attach(37, SoftPWM::DUTY_MAX / 2);
+    int off  = pwm.attach(38, 0);
+
+    pwm.runPeriod();
+    check(isHigh(port, 5) && !isHigh(port, 37) && !isHigh(port, 38), "period ends with only full duty high");
+
+    check(pwm.setPulseWidth(full, 0) && pwm.setPulseWidth(off, PERIOD_US), "pulse widths are changed");
+    check(pwm.getPulseWidth(half) == PERIOD_US * (SoftPWM::DUTY_MAX / 2) / SoftPWM::DUTY_MAX,
+          "pulse width is derived from duty");
+    pwm.runPeriod();
+    check(!isHigh(port, 5) && isHigh(port, 38), "new widths apply on the next period");
+}
+
+static void testDetachWhileRunning(const std::shared_ptr<SimulatedGPIOPort>& port)
+{
+    SoftPWM pwm(port, PERIOD_US);
+    int full = pwm.attach(7, SoftPWM::DUTY_MAX);
+    int keep = pwm.attach(8, SoftPWM::DUTY_MAX);
+
+    check(pwm.start() && pwm.isRunning(), "timer task is started");
+    check(!pwm.start(), "timer task is started only once");
+    flexhal::sleep(10);
+    check(isHigh(port, 7) && isHigh(port, 8), "full duty pins are high while running");
+
+    // 周期の先頭の出力と競合しても、タイマータスクがLowにする
+    int left_high  = 0;
+    int stayed_low = 0;
+    for (int i = 0; i < 20; ++i) {
+        pwm.detach(full);
+        flexhal::sleep(5);
+        left_high += isHigh(port, 7) ? 1 : 0;
+        full = pwm.attach(7, SoftPWM::DUTY_MAX);
+        flexhal::sleep(5);
+        stayed_low += isHigh(port, 7) ? 0 : 1;
+    }
+    check(left_high == 0, "pin detached while running goes low");
+    check(stayed_low == 0, "reattached pin is driven again");
+    check(isHigh(port, 8), "other channel keeps running");
+
+    check(pwm.setPulseWidth(keep, 0), "pulse width is changed while running");
+    flexhal::sleep(10);
+    check(!isHigh(port, 8), "zero width is applied while running");
+
+    pwm.stop();
+    check(!pwm.isRunning() && !isHigh(port, 7), "stop drives every pin low");
+}
+
+int main()
+{
+    // テスト中はウィンドウを表示しない
+    setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+    printf("FlexHAL software PWM test\n");
+
+    auto port = std::make_shared<SimulatedGPIOPort>(64, "FlexHAL Software PWM Test");
+    testAttach(port);
+    testPeriod(port);
+    testDetachWhileRunning(port);
+
+    printf("%s (%d failure(s))\n", failures == 0 ? "All tests passed" : "Tests failed", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file main.cpp
+ * @brief FlexHAL - ソフトウェアI2Cベンチマーク
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "FlexHAL.hpp"
+#include "impl/platforms/desktop/gpio.hpp"
+#include "impl/platforms/desktop/i2c.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+using namespace flexhal;
+using namespace flexhal::platform::desktop;
+
+// ESP32のデフォルトI2Cピンで計測する
+static const int SDA_PIN             = 21;
+static const int SCL_PIN             = 22;
+static const I2CAddress ADDRESS      = 0x50;
+static const size_t PAYLOAD          = 32;
+static const double MIN_MEASURE_TIME = 0.2;
+
+/**
+ * @brief 1バイトのアドレスで読み書きする256バイトのメモリデバイス
+ */
+class MemoryDevice : public SimulatedI2CDevice {
+public:
+    bool start(bool read) override
+    {
+        address_phase_ = !read;
+        return true;
+    }
+
+    bool write(uint8_t data) override
+    {
+        if (address_phase_) {
+            pointer_       = data;
+            address_phase_ = false;
+        } else {
+            memory_[pointer_++] = data;
+        }
+        return true;
+    }
+
+    uint8_t read() override
+    {
+        return memory_[pointer_++];
+    }
+
+private:
+    uint8_t memory_[256] = {};
+    uint8_t pointer_     = 0;
+    bool address_phase_  = false;
+};
+
+/**
+ * @brief 書き込みと読み返しを繰り返し、バス速度と1バイトあたりのCPU時間を表示
+ *
+ * @param transport ソフトウェアI2Cトランスポート
+ * @param clock_hz クロック周波数（0で待機なし）
+ * @return true 読み返したデータが一致
+ * @return false 不一致または転送エラー
+ */
+static bool benchmark(SoftwareI2CTransport& transport, uint32_t clock_hz)
+{
+    transport.setClockFrequency(clock_hz);
+    transport.resetStatistics();
+
+    uint8_t tx[PAYLOAD + 1];
+    uint8_t rx[PAYLOAD];
+    bool ok        = true;
+    int iterations = 0;
+
+    auto start       = std::chrono::steady_clock::now();
+    std::clock_t cpu = std::clock();
+    double elapsed   = 0;
+    while (elapsed < MIN_MEASURE_TIME) {
+        tx[0] = static_cast<uint8_t>((iterations * PAYLOAD) & 0xE0);
+        for (size_t i = 0; i < PAYLOAD; ++i) {
+            tx[i + 1] = static_cast<uint8_t>(iterations + i);
+        }
+        ok &= transport.write(tx, sizeof(tx)) == static_cast<ssize_t>(sizeof(tx));
+        ok &= transport.writeRead(tx, 1, rx, sizeof(rx)) == static_cast<ssize_t>(sizeof(rx));
+        ok &= std::memcmp(tx + 1, rx, sizeof(rx)) == 0;
+        ++iterations;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    double cpu_seconds = static_cast<double>(std::clock() - cpu) / CLOCKS_PER_SEC;
+
+    // アドレスを含めてバス上を流れたバイト数（1バイト9クロック）で評価する
+    SoftwareI2CStatistics statistics = transport.getStatistics();
+    double bytes                     = static_cast<double>(statistics.bytes);
+    printf("%10u Hz %12.1f kbit/s %10.2f us %10.2f us  %s\n", clock_hz, bytes * 9 / elapsed / 1000.0,
+           elapsed / bytes * 1000000.0, cpu_seconds / bytes * 1000000.0, ok ? "OK" : "MISMATCH");
+    return ok;
+}
+
+int main()
+{
+    // 計測中はウィンドウを表示しない
+    setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+    auto port = std::make_shared<SimulatedGPIOPort>(64, "FlexHAL Software I2C Benchmark");
+    SimulatedI2CPinBus bus(port->getPinTable(), SDA_PIN, SCL_PIN);
+    bus.addDevice(ADDRESS, std::make_shared<MemoryDevice>());
+
+    I2CBusConfig bus_config;
+    bus_config.sda_pin = SDA_PIN;
+    bus_config.scl_pin = SCL_PIN;
+    I2CDeviceConfig device_config;
+    device_config.address = ADDRESS;
+
+    SoftwareI2CTransport transport(port, bus_config, device_config);
+    if (!transport.begin()) {
+        printf("begin() failed\n");
+        return 1;
+    }
+
+    printf("FlexHAL software I2C benchmark (%zu-byte write + repeated-start read)\n", PAYLOAD);
+    printf("%13s %19s %13s %13s\n", "clock", "bus rate", "wall/byte", "cpu/byte");
+
+    bool ok = true;
+    for (uint32_t clock_hz : {100000u, 400000u, 1000000u, 0u}) {
+        ok &= benchmark(transport, clock_hz);
+    }
+
+    // スレーブが各バイトの後にSCLを保持する場合
+    bus.setClockStretch(std::chrono::microseconds(10));
+    printf("with 10 us clock stretching after each byte:\n");
+    ok &= benchmark(transport, 400000);
+    printf("clock stretches: %llu\n", static_cast<unsigned long long>(transport.getStatistics().clock_stretches));
+    bus.setClockStretch(std::chrono::microseconds(0));
+
+    // 2回目以降のスキャンは在否キャッシュから応答する
+    I2CBus i2c_bus(bus_config);
+    i2c_bus.addImplementation(std::make_shared<SoftwareI2CImplementation>(port));
+    printf("bus scan at 100 kHz (%d addresses):\n", I2C_SCAN_LAST_ADDRESS - I2C_SCAN_FIRST_ADDRESS + 1);
+    for (const char* label : {"first", "cached", "after hot-plug"}) {
+        if (std::strcmp(label, "after hot-plug") == 0) {
+            i2c_bus.notifyHotPlug(ADDRESS, ADDRESS);
+        }
+        auto start                    = std::chrono::steady_clock::now();
+        std::vector<I2CAddress> found = i2c_bus.scan(I2C_SCAN_FIRST_ADDRESS, I2C_SCAN_LAST_ADDRESS);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        printf("%16s %10.3f ms  %zu device(s)\n", label, elapsed.count(), found.size());
+        ok &= found.size() == 1 && found[0] == ADDRESS;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file main.cpp
+ * @brief FlexHAL - SPIフラッシュキャッシュテスト
+ * @version 0.1.0
+ * @date 2025-03-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "FlexHAL.hpp"
+#include "impl/platforms/desktop/spi.hpp"
+#include <cstdio>
+#include <memory>
+
+using namespace flexhal;
+using namespace flexhal::platform::desktop;
+
+static const int CS_PIN              = 5;
+static const size_t FLASH_SIZE       = 64 * 1024;  // 容量バイト 0x10
+static const uint32_t FLASH_JEDEC_ID = 0xEF4010;
+
+/**
+ * @brief 指定した間は READ_STATUS にビジーを返し続けるフラッシュ（書き込み・消去のタイムアウト用）
+ */
+class StuckFlash : public SimulatedSPINorFlash {
+public:
+    StuckFlash() : SimulatedSPINorFlash(FLASH_SIZE, FLASH_JEDEC_ID)
+    {
+    }
+
+    void select() override
+    {
+        first_byte_ = true;
+        status_     = false;
+        SimulatedSPINorFlash::select();
+    }
+
+    void transfer(const uint8_t* tx_data, uint8_t* rx_data, size_t length) override
+    {
+        SimulatedSPINorFlash::transfer(tx_data, rx_data, length);
+
+        size_t i = 0;
+        if (first_byte_ && length > 0) {
+            status_     = tx_data && tx_data[0] == CMD_READ_STATUS;
+            first_byte_ = false;
+            i           = 1;
+        }
+        if (busy_ && status_ && rx_data) {
+            for (; i < length; ++i) {
+                rx_data[i] |= STATUS_BUSY;
+            }
+        }
+    }
+
+    bool busy_ = false;
+
+private:
+    bool first_byte_ = false;
+    bool status_     = false;
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char* name)
+{
+    printf("[%s] %s\n", condition ? "PASS" : "FAIL", name);
+    if (!condition) {
+        ++failures;
+    }
+}
+
+/**
+ * @brief フラッシュモデルに接続したドライバを作成
+ */
+static std::shared_ptr<SPIFlash> createFlash(std::shared_ptr<SimulatedSPIDevice> device)
+{
+    auto implementation = std::make_shared<SimulatedSPIImplementation>();
+    implementation->attachDevice(CS_PIN, device);
+
+    SPIDeviceConfig device_config;
+    device_config.cs_pin = CS_PIN;
+    auto flash = std::make_shared<SPIFlash>(implementation->createTransport(SPIBusConfig(), device_config));
+    return flash->begin() ? flash : nullptr;
+}
+
+static void testCapacity()
+{
+    auto large = createFlash(std::make_shared<SimulatedSPINorFlash>(FLASH_SIZE, 0xEF4019));
+    check(large && large->getSize() == SPIFlash::MAX_ADDRESSABLE_SIZE, "capacity above 16MB is clamped");
+
+    auto flash = createFlash(std::make_shared<SimulatedSPINorFlash>(FLASH_SIZE, FLASH_JEDEC_ID));
+    uint8_t data[4];
+    check(flash && flash->getSize() == FLASH_SIZE, "capacity is detected");
+    check(flash && !flash->read(FLASH_SIZE - 2, data, sizeof(data)), "read past the end fails");
+}
+
+static void testReadCache()
+{
+    auto device = std::make_shared<SimulatedSPINorFlash>(FLASH_SIZE, FLASH_JEDEC_ID);
+    for (size_t i = 0; i < FLASH_SIZE; ++i) {
+        device->getData()[i] = static_cast<uint8_t>(i * 7);
+    }
+    SPIFlashCache cache(createFlash(device), 8, 4);
+
+    uint8_t data[16];
+    check(cache.read(0x100, data, sizeof(data)) && data[3] == static_cast<uint8_t>(0x103 * 7), "page is read");
+    check(cache.read(0x110, data, sizeof(data)) && cache.getStatistics().read_commands == 1,
+          "same page is answered from cache");
+
+    // 連続したページへのミスで後続のページを先読みする
+    check(cache.read(0x200, data, sizeof(data)), "next page is read");
+    SPIFlashCacheStatistics statistics = cache.getStatistics();
+    check(statistics.read_commands == 2 && statistics.read_ahead_pages == 4, "sequential miss reads ahead");
+    check(cache.read(0x600, data, sizeof(data)) && cache.getStatistics().read_commands == 2,
+          "read-ahead page is answered from cache");
+
+    // 容量の末尾では先読みしない
+    uint32_t last_page = FLASH_SIZE - SPIFlash::PAGE_SIZE;
+    check(cache.read(last_page - SPIFlash::PAGE_SIZE, data, 1) && cache.read(last_page, data, 1),
+          "last pages are read");
+    uint64_t read_ahead = cache.getStatistics().read_ahead_pages;
+    check(read_ahead == 4, "read-ahead is clamped at the end of flash");
+    check(!cache.read(FLASH_SIZE, data, 1), "page past the end is not read");
+    check(cache.getStatistics().read_ahead_pages == read_ahead, "page past the end does not read ahead");
+}
+
+static void testWriteBack()
+{
+    auto device = std::make_shared<SimulatedSPINorFlash>(FLASH_SIZE, FLASH_JEDEC_ID);
+    SPIFlashCache cache(createFlash(device), 4, 0);
+
+    check(cache.eraseSector(0), "sector is erased");
+    uint8_t first[4]  = {1, 2, 3, 4};
+    uint8_t second[4] = {5, 6, 7, 8};
+    check(cache.write(0x10, first, sizeof(first)) && cache.write(0x20, second, sizeof(second)), "page is written");
+    check(device->getData()[0x10] == 0xFF, "write is deferred");
+
+    check(cache.flush(), "cache is flushed");
+    SPIFlashCacheStatistics statistics = cache.getStatistics();
+    check(statistics.program_commands == 1 && statistics.coalesced_writes == 1, "writes to a page are coalesced");
+    check(device->getData()[0x13] == 4 && device->getData()[0x20] == 5 && device->getData()[0x18] == 0xFF,
+          "flash holds written data");
+
+    // 書き込みは消去済みのビットを0にするだけ
+    uint8_t mask  = 0xF0;
+    uint8_t value = 0;
+    check(cache.write(0x10, &mask, 1) && cache.read(0x10, &value, 1) && value == 0x00, "write only clears bits");
+}
+
+static void testEraseFailure()
+{
+    auto device = std::make_shared<StuckFlash>();
+    SPIFlashCache cache(createFlash(device), 4, 0);
+
+    uint8_t data[2] = {0x12, 0x34};
+    check(cache.write(0x40, data, sizeof(data)), "page is written");
+
+    device->busy_ = true;
+    check(!cache.eraseSector(0), "erase timeout is reported");
+    device->busy_ = false;
+
+    uint8_t value = 0;
+    check(cache.read(0x41, &value, 1) && value == 0x34, "failed erase keeps cached data");
+    check(cache.eraseSector(0) && cache.read(0x41, &value, 1) && value == 0xFF, "successful erase clears cached data");
+    check(cache.flush() && cache.getStatistics().program_commands == 0, "erased page is not written back");
+}
+
+int main()
+{
+    printf("FlexHAL SPI flash cache test\n");
+
+    testCapacity();
+    testReadCache();
+    testWriteBack();
+    testEraseFailure();
+
+    printf("%s (%d failure(s))\n", failures == 0 ? "All tests passed" : "Tests failed", failures);
+    return failures == 0 ? 0 : 1;
+}